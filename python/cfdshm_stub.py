@@ -0,0 +1,102 @@
+#!/usr/bin/env python
+# stand-in for a CFD solver coupled via fix couple/cfd ... shm
+# answers every coupling step of LIGGGHTS without doing any CFD
+#
+# Syntax: cfdshm_stub.py path nprocs [-set name v1 v2 ...]
+#         path = segment path given to the shm coupling
+#         nprocs = # of LIGGGHTS procs, segments are path.0 ... path.N-1
+#         -set = fill pulled property name with these values per atom
+#                (default = pulled properties are set to zero)
+#
+# the segment layout and handshake are described in
+# src/cfd_datacoupling_shm.h
+
+import sys, os, time, mmap, struct
+
+HEADER = "=8siiqqqqqqiid"
+FIELD = "=32s32siiiiiiq"
+SEQ_DEM = 32
+SEQ_CFD = 40
+
+class Segment:
+  def __init__(self, name):
+    self.name = name
+    self.fd = os.open(name, os.O_RDWR)
+    self.map = None
+    self.size = 0
+    self.seq = 0
+
+  def remap(self):
+    size = os.fstat(self.fd).st_size
+    if size != self.size:
+      if self.map: self.map.close()
+      self.map = mmap.mmap(self.fd, size)
+      self.size = size
+
+  def header(self):
+    return struct.unpack_from(HEADER, self.map, 0)
+
+  def fields(self):
+    nfield = self.header()[2]
+    off = struct.calcsize(HEADER)
+    out = []
+    for i in range(nfield):
+      f = struct.unpack_from(FIELD, self.map, off + i*struct.calcsize(FIELD))
+      name = f[0].rstrip(b"\0").decode()
+      type = f[1].rstrip(b"\0").decode()
+      out.append((name, type, f[2], f[3], f[4], f[5], f[6], f[8]))
+    return out
+
+  def load(self, pos):
+    return struct.unpack_from("=q", self.map, pos)[0]
+
+def answer(seg, values):
+  seg.remap()
+  h = seg.header()
+  ntimestep, nlocal = h[7], h[8]
+  for name, type, pull, isint, peratom, len1, len2, offset in seg.fields():
+    if not pull: continue
+    nrows = nlocal if peratom else len1
+    row = values.get(name, [0.0]*len2)
+    if len(row) != len2:
+      sys.exit("-set %s needs %d values" % (name, len2))
+    fmt = "=%d%s" % (len2, "i" if isint else "d")
+    size = struct.calcsize(fmt)
+    for i in range(nrows):
+      struct.pack_into(fmt, seg.map, offset + i*size, *row)
+  print("step %d proc %d: %d particles" % (ntimestep, h[9], nlocal))
+  sys.stdout.flush()
+  # pulled data is in place, hand back to LIGGGHTS
+  struct.pack_into("=q", seg.map, SEQ_CFD, seg.seq)
+
+if __name__ == "__main__":
+  args = sys.argv[1:]
+  if len(args) < 2:
+    sys.exit("Syntax: cfdshm_stub.py path nprocs [-set name v1 v2 ...]")
+  path = args.pop(0)
+  nprocs = int(args.pop(0))
+  values = {}
+  while args:
+    if args.pop(0) != "-set" or not args: sys.exit("unknown option")
+    name = args.pop(0)
+    row = []
+    while args and args[0] != "-set": row.append(float(args.pop(0)))
+    values[name] = row
+
+  names = ["%s.%d" % (path, p) for p in range(nprocs)]
+  while not all(os.path.exists(name) for name in names): time.sleep(0.01)
+  segs = [Segment(name) for name in names]
+  for seg in segs: seg.remap()
+
+  done = 0
+  while done < nprocs:
+    idle = True
+    for seg in segs:
+      if seg.seq < 0: continue
+      seq = seg.load(SEQ_DEM)
+      if seq == seg.seq: continue
+      idle = False
+      seg.seq = seq
+      if seq < 0: done += 1
+      else: answer(seg, values)
+    if idle: time.sleep(0.0001)
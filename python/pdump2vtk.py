@@ -0,0 +1,149 @@
+#!/usr/bin/env python
+# convert output of dump custom/parallel into VTK XML files, offline
+#
+# Syntax: pdump2vtk.py index [-vtu] [-prefix name]
+#         index = index file given to dump custom/parallel
+#         -vtu = write .vtu unstructured grids instead of .vtp poly data
+#         -prefix = output file prefix (default = index file name)
+#
+# writes one file per snapshot, prefix_<timestep>.vtp (or .vtu)
+# columns x,y,z (or xs,ys,zs unscaled with the snapshot box) become the
+# points, other columns become point data, column triplets that only
+# differ by a trailing x,y,z (vx vy vz, fx fy fz, ...) become vectors
+# the index file header and snapshot records are described in
+# src/dump_custom_parallel.h
+
+import sys, struct, base64
+from array import array
+
+NINFO = 8
+
+def read(f, fmt):
+  size = struct.calcsize(fmt)
+  data = f.read(size)
+  if len(data) != size: return None
+  return struct.unpack(fmt, data)
+
+def snapshots(index):
+  f = open(index, "rb")
+  if f.read(8) != b"LPDUMP01":
+    sys.exit("%s is not a dump custom/parallel index file" % index)
+  ncol, n = read(f, "=ii")
+  columns = f.read(n).decode().split()
+  if len(columns) != ncol:
+    sys.exit("%s is incorrectly formatted" % index)
+  while True:
+    head = read(f, "=qqi6i6d")
+    if head is None: break
+    ntimestep, natoms, triclinic = head[0:3]
+    box = head[9:15]
+    if triclinic: read(f, "=3d")
+    nblock = read(f, "=i")[0]
+    info = read(f, "=%dd" % (NINFO*nblock))
+    blocks = [(int(info[NINFO*i]), int(info[NINFO*i+1]))
+              for i in range(nblock)]
+    yield ntimestep, natoms, box, columns, blocks
+  f.close()
+
+def gather(index, columns, blocks):
+  # read all blocks of one snapshot into per-column arrays
+  ncol = len(columns)
+  values = array("d")
+  for iblock, (nlines, offset) in enumerate(blocks):
+    if nlines == 0: continue
+    f = open("%s.%d" % (index, iblock), "rb")
+    f.seek(offset)
+    values.fromfile(f, nlines*ncol)
+    f.close()
+  return [values[i::ncol] for i in range(ncol)]
+
+def encode(values, typecode="d"):
+  data = array(typecode, values)
+  if sys.byteorder == "big": data.byteswap()
+  raw = data.tobytes()
+  return base64.b64encode(struct.pack("<I", len(raw)) + raw).decode()
+
+def dataarray(name, ncomp, values, vtktype="Float64", typecode="d"):
+  return ('<DataArray type="%s" Name="%s" NumberOfComponents="%d" '
+          'format="binary">\n%s\n</DataArray>\n' %
+          (vtktype, name, ncomp, encode(values, typecode)))
+
+def interleave(cols):
+  out = array("d", [0.0]) * (len(cols[0])*len(cols))
+  for k, col in enumerate(cols): out[k::len(cols)] = col
+  return out
+
+def points(columns, data, box):
+  for names, scaled in ((("x","y","z"), 0), (("xs","ys","zs"), 1),
+                        (("xu","yu","zu"), 0), (("xsu","ysu","zsu"), 1)):
+    if all(name in columns for name in names):
+      cols = [data[columns.index(name)] for name in names]
+      if scaled:
+        cols = [array("d", [box[2*k] + v*(box[2*k+1]-box[2*k])
+                            for v in col]) for k, col in enumerate(cols)]
+      return names, interleave(cols)
+  sys.exit("dump needs x,y,z or xs,ys,zs columns for VTK output")
+
+def write(name, vtu, columns, data, box):
+  npoints = len(data[0]) if data else 0
+  used, xyz = points(columns, data, box)
+
+  arrays = []
+  done = set(used)
+  for i, col in enumerate(columns):
+    if col in done: continue
+    if col.endswith("x") and len(col) > 1:
+      stem = col[:-1]
+      triplet = [stem + c for c in "xyz"]
+      if all(t in columns for t in triplet):
+        cols = [data[columns.index(t)] for t in triplet]
+        arrays.append(dataarray(stem, 3, interleave(cols)))
+        done.update(triplet)
+        continue
+    arrays.append(dataarray(col, 1, data[i]))
+    done.add(col)
+
+  kind = "UnstructuredGrid" if vtu else "PolyData"
+  out = open(name, "w")
+  out.write('<?xml version="1.0"?>\n')
+  out.write('<VTKFile type="%s" version="0.1" byte_order="LittleEndian">\n'
+            % kind)
+  out.write('<%s>\n' % kind)
+  if vtu:
+    out.write('<Piece NumberOfPoints="%d" NumberOfCells="%d">\n'
+              % (npoints, npoints))
+  else:
+    out.write('<Piece NumberOfPoints="%d" NumberOfVerts="%d">\n'
+              % (npoints, npoints))
+  out.write('<PointData>\n%s</PointData>\n' % "".join(arrays))
+  out.write('<Points>\n%s</Points>\n' % dataarray("points", 3, xyz))
+
+  # one vertex cell per particle
+  conn = range(npoints)
+  offsets = range(1, npoints+1)
+  out.write('<%s>\n' % ("Cells" if vtu else "Verts"))
+  out.write(dataarray("connectivity", 1, conn, "Int64", "q"))
+  out.write(dataarray("offsets", 1, offsets, "Int64", "q"))
+  if vtu: out.write(dataarray("types", 1, [1]*npoints, "UInt8", "B"))
+  out.write('</%s>\n' % ("Cells" if vtu else "Verts"))
+  out.write('</Piece>\n</%s>\n</VTKFile>\n' % kind)
+  out.close()
+
+if __name__ == "__main__":
+  args = sys.argv[1:]
+  if not args: sys.exit("Syntax: pdump2vtk.py index [-vtu] [-prefix name]")
+  index = args.pop(0)
+  vtu = 0
+  prefix = index
+  while args:
+    arg = args.pop(0)
+    if arg == "-vtu": vtu = 1
+    elif arg == "-prefix" and args: prefix = args.pop(0)
+    else: sys.exit("Syntax: pdump2vtk.py index [-vtu] [-prefix name]")
+
+  suffix = "vtu" if vtu else "vtp"
+  for ntimestep, natoms, box, columns, blocks in snapshots(index):
+    data = gather(index, columns, blocks)
+    name = "%s_%d.%s" % (prefix, ntimestep, suffix)
+    write(name, vtu, columns, data, box)
+    print("%s: %d particles" % (name, natoms))
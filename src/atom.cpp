@@ -143,6 +143,7 @@ Atom::Atom(LAMMPS *lmp) : Pointers(lmp)
   num_bond = NULL;
   bond_type = bond_atom = NULL;
   bond_hist = NULL;
+  bond_hist_gen = 0;
   n_bondhist = 0; 
 
   num_angle = NULL;
@@ -190,6 +191,8 @@ Atom::Atom(LAMMPS *lmp) : Pointers(lmp)
   theta = theta_prev = NULL;
   cont_distance = NULL;
   bond_index = NULL;
+  bond_mca = NULL;
+  bond_partner = NULL;
 
   // ntype-length arrays
 
@@ -318,6 +321,8 @@ Atom::~Atom()
   memory->destroy(equiv_strain);
   memory->destroy(cont_distance);
   memory->destroy(bond_index);
+  memory->destroy(bond_mca);
+  memory->destroy(bond_partner);
 
 //Superquadric bonus-----------------------------------
   memory->destroy(shape); //half axes and roundness parameters
@@ -111,6 +111,7 @@ class Atom : protected Pointers {
   int **bond_type;     
   int **bond_atom;     
   double ***bond_hist; 
+  int bond_hist_gen;   // generation of the double buffered bond_hist values (MCA)
                        
   int *num_angle;
   int **angle_type;
@@ -164,6 +165,7 @@ class Atom : protected Pointers {
   double *plastic_heat; // heat due to work of plastic deformation
   int **bond_index;     // corresponding index of bondlist[index] in neighbor
   int **bond_mca;   //  local # of bonded automaton
+  int **bond_partner; // slot k of the reverse bond in bond_atom[bond_mca[i][*]]
   // End of MCA
 
   int molecule_flag,q_flag,mu_flag;
@@ -74,13 +74,12 @@ AtomVecMCA::AtomVecMCA(LAMMPS *lmp) : AtomVec(lmp)
   bonds_allow = 1;
   mass_type = 1; // per-type masses
 
-  comm_x_only = 0;   // 1 if only exchange x in forward comm - we need rotation and mean stress
+  comm_x_only = 1;   // 1 if only exchange x in forward comm - MCA state is forwarded by fix mca/meanstress and pair mca
   comm_f_only = 0;   // 1 if only exchange f in reverse comm - we need torque
 
-///AS TODO What is border communications? What is forward and reverse communications? What we need for them?
-  size_forward = 9;  ///AS TODO # of values per atom in comm !! Later choose what to pass via MPI
-  size_reverse = 1;  ///AS we use reverse_comm to exchage 'cont_distance' only // 6;  // # in reverse comm
-  size_border = 22+MAX_BONDS*(2+BOND_HIST_LEN);  // # in border comm (periodic boundary ?)
+  size_forward = 3;  // # of values per atom in comm, bond topology and history go with borders only
+  size_reverse = 6;  // # in reverse comm
+  size_border = 24+MAX_BONDS*(4+BOND_HIST_LEN);  // # in border comm, incl. per-atom bond history of ghosts
   size_velocity = 6; ///AS # of velocity based quantities
   size_data_atom = 19;///AS it seems that 22-3=19 TODO number of values in Atom line
   size_data_vel = 7; ///AS TODO number of values in Velocity line
@@ -312,6 +311,7 @@ void AtomVecMCA::grow(int n)
 if (logfile) fprintf(logfile, "AtomVecMCA::grow atom->bond_index= %d \n", atom->bond_index);  ///AS DEBUG
   bond_index = memory->grow(atom->bond_index,nmax,atom->bond_per_atom,"atom:bond_index");
   bond_mca = memory->grow(atom->bond_mca,nmax,atom->bond_per_atom,"atom:bond_mca");
+  bond_partner = memory->grow(atom->bond_partner,nmax,atom->bond_per_atom,"atom:bond_partner");
 
   if(atom->n_bondhist < 0)
     error->all(FLERR,"atom->n_bondhist < 0 suggests that 'bond_style mca' has not been called before 'read_restart' command! Please check that.");
@@ -358,6 +358,7 @@ void AtomVecMCA::grow_reset()
   bond_atom = atom->bond_atom;
   bond_index = atom->bond_index;
   bond_mca = atom->bond_mca;
+  bond_partner = atom->bond_partner;
   n_bondhist = atom->n_bondhist; bond_hist = atom->bond_hist;
 }
 
@@ -409,17 +410,15 @@ void AtomVecMCA::copy(int i, int j, int delflag)
     bond_atom[j][k] = bond_atom[i][k];
     bond_index[j][k] = bond_index[i][k];
     bond_mca[j][k] = bond_mca[i][k];
+    bond_partner[j][k] = bond_partner[i][k];
   }
-/**
+  // bond history is stored per local/ghost atom, so it moves with the atom
   if(atom->n_bondhist)
   {
-      int tag_i = tag[i] - 1;
-      int tag_j = tag[j] - 1;
       for (k = 0; k < num_bond[j]; k++)
-         for (l =0; l < atom->n_bondhist; l++)
-            bond_hist[tag_j][k][l] = bond_hist[tag_i][k][l];
+         for (l = 0; l < atom->n_bondhist; l++)
+            bond_hist[j][k][l] = bond_hist[i][k][l];
   }
-*/
   nspecial[j][0] = nspecial[i][0];
   nspecial[j][1] = nspecial[i][1];
   nspecial[j][2] = nspecial[i][2];
@@ -430,16 +429,19 @@ void AtomVecMCA::copy(int i, int j, int delflag)
       modify->fix[atom->extra_grow[iextra]]->copy_arrays(i,j,delflag);
 }
 
-/* ---------------------------------------------------------------------- */
+/* ----------------------------------------------------------------------
+   per-step forward comm carries coordinates (and velocities) only;
+   bond topology and the full bond history of ghosts are sent with borders,
+   the MCA state updated during a step is forwarded by FixMCAMeanStress
+   (rotations, mean stress) and PairMCA (bond history, contact distance)
+------------------------------------------------------------------------- */
 
 int AtomVecMCA::pack_comm(int n, int *list, double *buf,
 			   int pbc_flag, int *pbc)
 {
   int i,j,m;
-  int k,l;
   double dx,dy,dz;
 
-///AS  if (radvary == 0) {
   m = 0;
   if (pbc_flag == 0) {
     for (i = 0; i < n; i++) {
@@ -447,33 +449,6 @@ int AtomVecMCA::pack_comm(int n, int *list, double *buf,
       buf[m++] = x[j][0];
       buf[m++] = x[j][1];
       buf[m++] = x[j][2];
-      buf[m++] = theta[j][0];
-      buf[m++] = theta[j][1];
-      buf[m++] = theta[j][2];
-      buf[m++] = theta_prev[j][0];
-      buf[m++] = theta_prev[j][1];
-      buf[m++] = theta_prev[j][2];
-      buf[m++] = mean_stress[j];
-      buf[m++] = mean_stress_prev[j];
-      buf[m++] = equiv_stress[j];
-      buf[m++] = equiv_stress_prev[j];
-      buf[m++] = equiv_strain[j];
-      buf[m++] = cont_distance[j];
-      buf[m++] = plastic_heat[j];
-      buf[m++] = ubuf(num_bond[j]).d;
-      for (k = 0; k < num_bond[j]; k++) {
-        buf[m++] = ubuf(bond_type[j][k]).d;
-        buf[m++] = ubuf(bond_atom[j][k]).d;
-        buf[m++] = ubuf(bond_index[j][k]).d;
-        buf[m++] = ubuf(bond_mca[j][k]).d;
-      }
-      if(atom->n_bondhist)
-      {
-          int tag_j = tag[j] - 1;
-          for (k = 0; k < num_bond[j]; k++)
-             for (l = 0; l < atom->n_bondhist; l++)
-                buf[m++] = bond_hist[tag_j][k][l];
-      }
     }
   } else {
     if (domain->triclinic == 0) {
@@ -490,99 +465,8 @@ int AtomVecMCA::pack_comm(int n, int *list, double *buf,
       buf[m++] = x[j][0] + dx;
       buf[m++] = x[j][1] + dy;
       buf[m++] = x[j][2] + dz;
-      buf[m++] = theta[j][0];
-      buf[m++] = theta[j][1];
-      buf[m++] = theta[j][2];
-      buf[m++] = theta_prev[j][0];
-      buf[m++] = theta_prev[j][1];
-      buf[m++] = theta_prev[j][2];
-      buf[m++] = mean_stress[j];
-      buf[m++] = mean_stress_prev[j];
-      buf[m++] = equiv_stress[j];
-      buf[m++] = equiv_stress_prev[j];
-      buf[m++] = equiv_strain[j];
-      buf[m++] = cont_distance[j];
-      buf[m++] = plastic_heat[j];
-      buf[m++] = ubuf(num_bond[j]).d;
-      for (k = 0; k < num_bond[j]; k++) {
-        buf[m++] = ubuf(bond_type[j][k]).d;
-        buf[m++] = ubuf(bond_atom[j][k]).d;
-        buf[m++] = ubuf(bond_index[j][k]).d;
-        buf[m++] = ubuf(bond_mca[j][k]).d;
-      }
-      if(atom->n_bondhist)
-      {
-          int tag_j = tag[j] - 1;
-          for (k = 0; k < num_bond[j]; k++)
-             for (l = 0; l < atom->n_bondhist; l++)
-                buf[m++] = bond_hist[tag_j][k][l];
-      }
     }
   }
-/*
-  } else {
-    m = 0;
-    if (pbc_flag == 0) {
-      for (i = 0; i < n; i++) {
-        j = list[i];
-        buf[m++] = x[j][0];
-        buf[m++] = x[j][1];
-        buf[m++] = x[j][2];
-        buf[m++] = ubuf(type[j]).d;
-        buf[m++] = rmass[j];
-        buf[m++] = density[j];
-        buf[m++] = mca_inertia[j];
-        buf[m++] = theta[j][0];
-        buf[m++] = theta[j][1];
-        buf[m++] = theta[j][2];
-        buf[m++] = theta_prev[j][0];
-        buf[m++] = theta_prev[j][1];
-        buf[m++] = theta_prev[j][2];
-        buf[m++] = mean_stress[j];
-        buf[m++] = mean_stress_prev[j];
-        buf[m++] = equiv_stress[j];
-        buf[m++] = equiv_stress_prev[j];
-        buf[m++] = equiv_strain[j];
-        buf[m++] = cont_distance[j]
-        buf[m++] = plastic_heat[j];
-      }
-    } else {
-      if (domain->triclinic == 0) {
-        dx = pbc[0]*domain->xprd;
-        dy = pbc[1]*domain->yprd;
-        dz = pbc[2]*domain->zprd;
-      } else {
-        dx = pbc[0]*domain->xprd + pbc[5]*domain->xy + pbc[4]*domain->xz;
-        dy = pbc[1]*domain->yprd + pbc[3]*domain->yz;
-        dz = pbc[2]*domain->zprd;
-      }
-      for (i = 0; i < n; i++) {
-        j = list[i];
-        buf[m++] = x[j][0] + dx;
-        buf[m++] = x[j][1] + dy;
-        buf[m++] = x[j][2] + dz;
-        buf[m++] = ubuf(type[j]).d;
-        buf[m++] = rmass[j];
-        buf[m++] = density[j];
-        buf[m++] = mca_inertia[j];
-        buf[m++] = theta[j][0];
-        buf[m++] = theta[j][1];
-        buf[m++] = theta[j][2];
-        buf[m++] = theta_prev[j][0];
-        buf[m++] = theta_prev[j][1];
-        buf[m++] = theta_prev[j][2];
-        buf[m++] = mean_stress[j];
-        buf[m++] = mean_stress_prev[j];
-        buf[m++] = equiv_stress[j];
-        buf[m++] = equiv_stress_prev[j];
-        buf[m++] = equiv_strain[j];
-        buf[m++] = cont_distance[j]
-        buf[m++] = plastic_heat[j];
-      }
-    }
-  } */
-if (logfile) fprintf(logfile,"AtomVecMCA::pack_comm m=%d n=%d \n",m,n);
-
   return m;
 }
 
@@ -595,10 +479,8 @@ int AtomVecMCA::pack_comm_vel(int n, int *list, double *buf,
     return pack_comm_vel_wedge(n,list,buf,pbc_flag,pbc);
 
   int i,j,m;
-  int k,l;
   double dx,dy,dz,dvx,dvy,dvz;
 
-///AS if (radvary == 0) {
   m = 0;
   if (pbc_flag == 0) {
     for (i = 0; i < n; i++) {
@@ -609,37 +491,9 @@ int AtomVecMCA::pack_comm_vel(int n, int *list, double *buf,
       buf[m++] = v[j][0];
       buf[m++] = v[j][1];
       buf[m++] = v[j][2];
-/*
       buf[m++] = omega[j][0];
       buf[m++] = omega[j][1];
       buf[m++] = omega[j][2];
-      buf[m++] = theta[j][0];
-      buf[m++] = theta[j][1];
-      buf[m++] = theta[j][2];
-      buf[m++] = theta_prev[j][0];
-      buf[m++] = theta_prev[j][1];
-      buf[m++] = theta_prev[j][2];
-      buf[m++] = mean_stress[j];
-      buf[m++] = mean_stress_prev[j];
-      buf[m++] = equiv_stress[j];
-      buf[m++] = equiv_stress_prev[j];
-      buf[m++] = equiv_strain[j];
-      buf[m++] = cont_distance[j];
-      buf[m++] = plastic_heat[j];
-      buf[m++] = ubuf(num_bond[j]).d;
-      for (k = 0; k < num_bond[j]; k++) {
-        buf[m++] = ubuf(bond_type[j][k]).d;
-        buf[m++] = ubuf(bond_atom[j][k]).d;
-        buf[m++] = ubuf(bond_index[j][k]).d;
-        buf[m++] = ubuf(bond_mca[j][k]).d;
-      }
-      if(atom->n_bondhist)
-      {
-          int tag_j = tag[j] - 1;
-          for (k = 0; k < num_bond[j]; k++)
-             for (l = 0; l < atom->n_bondhist; l++)
-                buf[m++] = bond_hist[tag_j][k][l];
-      }*/
     }
   } else {
     if (domain->triclinic == 0) {
@@ -660,38 +514,9 @@ int AtomVecMCA::pack_comm_vel(int n, int *list, double *buf,
         buf[m++] = v[j][0];
         buf[m++] = v[j][1];
         buf[m++] = v[j][2];
-/*
         buf[m++] = omega[j][0];
         buf[m++] = omega[j][1];
         buf[m++] = omega[j][2];
-        buf[m++] = theta[j][0];
-        buf[m++] = theta[j][1];
-        buf[m++] = theta[j][2];
-        buf[m++] = theta_prev[j][0];
-        buf[m++] = theta_prev[j][1];
-        buf[m++] = theta_prev[j][2];
-        buf[m++] = mean_stress[j];
-        buf[m++] = mean_stress_prev[j];
-        buf[m++] = equiv_stress[j];
-        buf[m++] = equiv_stress_prev[j];
-        buf[m++] = equiv_strain[j];
-        buf[m++] = cont_distance[j];
-        buf[m++] = plastic_heat[j];
-        buf[m++] = ubuf(num_bond[j]).d;
-//if(tag[j]==10) if (logfile) fprintf(logfile,"pack_comm_vel num_bond[%d(tag=%d)]=%d\n",j,tag[j],num_bond[j]);
-        for (k = 0; k < num_bond[j]; k++) {
-          buf[m++] = ubuf(bond_type[j][k]).d;
-          buf[m++] = ubuf(bond_atom[j][k]).d;
-          buf[m++] = ubuf(bond_index[j][k]).d;
-          buf[m++] = ubuf(bond_mca[j][k]).d;
-//if(tag[j]==10) if (logfile) fprintf(logfile,"\tbond_atom[j][%d]=%d m=%d buf[m]=%+20.14e\n",k,bond_atom[j][k],m-1,buf[m-1]);
-        }
-        if(atom->n_bondhist) {
-          int tag_j = tag[j] - 1;
-          for (k = 0; k < num_bond[j]; k++)
-            for (l = 0; l < atom->n_bondhist; l++)
-              buf[m++] = bond_hist[tag_j][k][l];
-        }*/
       }
     } else {
       dvx = pbc[0]*h_rate[0] + pbc[5]*h_rate[5] + pbc[4]*h_rate[4];
@@ -711,159 +536,12 @@ int AtomVecMCA::pack_comm_vel(int n, int *list, double *buf,
           buf[m++] = v[j][1];
           buf[m++] = v[j][2];
         }
-/*
         buf[m++] = omega[j][0];
         buf[m++] = omega[j][1];
         buf[m++] = omega[j][2];
-        buf[m++] = theta[j][0];
-        buf[m++] = theta[j][1];
-        buf[m++] = theta[j][2];
-        buf[m++] = theta_prev[j][0];
-        buf[m++] = theta_prev[j][1];
-        buf[m++] = theta_prev[j][2];
-        buf[m++] = mean_stress[j];
-        buf[m++] = mean_stress_prev[j];
-        buf[m++] = equiv_stress[j];
-        buf[m++] = equiv_stress_prev[j];
-        buf[m++] = equiv_strain[j];
-        buf[m++] = cont_distance[j];
-        buf[m++] = plastic_heat[j];
-        buf[m++] = ubuf(num_bond[j]).d;
-        for (k = 0; k < num_bond[j]; k++) {
-          buf[m++] = ubuf(bond_type[j][k]).d;
-          buf[m++] = ubuf(bond_atom[j][k]).d;
-          buf[m++] = ubuf(bond_index[j][k]).d;
-          buf[m++] = ubuf(bond_mca[j][k]).d;
-        }
-        if(atom->n_bondhist) {
-          int tag_j = tag[j] - 1;
-          for (k = 0; k < num_bond[j]; k++)
-            for (l = 0; l < atom->n_bondhist; l++)
-              buf[m++] = bond_hist[tag_j][k][l];
-        }*/
       }
     }
   }
-/* AS
-  } else {
-    m = 0;
-    if (pbc_flag == 0) {
-      for (i = 0; i < n; i++) {
-        j = list[i];
-        buf[m++] = x[j][0];
-        buf[m++] = x[j][1];
-        buf[m++] = x[j][2];
-        buf[m++] = ubuf(type[j]).d;
-        buf[m++] = rmass[j];
-        buf[m++] = density[j];
-        buf[m++] = v[j][0];
-        buf[m++] = v[j][1];
-        buf[m++] = v[j][2];
-        buf[m++] = omega[j][0];
-        buf[m++] = omega[j][1];
-        buf[m++] = omega[j][2];
-
-        buf[m++] = mca_inertia[j];
-        buf[m++] = theta[j][0];
-        buf[m++] = theta[j][1];
-        buf[m++] = theta[j][2];
-        buf[m++] = theta_prev[j][0];
-        buf[m++] = theta_prev[j][1];
-        buf[m++] = theta_prev[j][2];
-        buf[m++] = mean_stress[j];
-        buf[m++] = mean_stress_prev[j];
-        buf[m++] = equiv_stress[j];
-        buf[m++] = equiv_stress_prev[j];
-        buf[m++] = equiv_strain[j];
-        buf[m++] = cont_distance[j]
-        buf[m++] = plastic_heat[j];
-      }
-    } else {
-      if (domain->triclinic == 0) {
-        dx = pbc[0]*domain->xprd;
-        dy = pbc[1]*domain->yprd;
-        dz = pbc[2]*domain->zprd;
-      } else {
-        dx = pbc[0]*domain->xprd + pbc[5]*domain->xy + pbc[4]*domain->xz;
-        dy = pbc[1]*domain->yprd + pbc[3]*domain->yz;
-        dz = pbc[2]*domain->zprd;
-      }
-      if (!deform_vremap) {
-        for (i = 0; i < n; i++) {
-          j = list[i];
-          buf[m++] = x[j][0] + dx;
-          buf[m++] = x[j][1] + dy;
-          buf[m++] = x[j][2] + dz;
-          buf[m++] = ubuf(type[j]).d;
-          buf[m++] = rmass[j];
-          buf[m++] = density[j];
-          buf[m++] = v[j][0];
-          buf[m++] = v[j][1];
-          buf[m++] = v[j][2];
-          buf[m++] = omega[j][0];
-          buf[m++] = omega[j][1];
-          buf[m++] = omega[j][2];
-
-          buf[m++] = mca_inertia[j];
-          buf[m++] = theta[j][0];
-          buf[m++] = theta[j][1];
-          buf[m++] = theta[j][2];
-          buf[m++] = theta_prev[j][0];
-          buf[m++] = theta_prev[j][1];
-          buf[m++] = theta_prev[j][2];
-          buf[m++] = mean_stress[j];
-          buf[m++] = mean_stress_prev[j];
-          buf[m++] = equiv_stress[j];
-          buf[m++] = equiv_stress_prev[j];
-          buf[m++] = equiv_strain[j];
-          buf[m++] = cont_distance[j]
-          buf[m++] = plastic_heat[j];
-        }
-      } else {
-        dvx = pbc[0]*h_rate[0] + pbc[5]*h_rate[5] + pbc[4]*h_rate[4];
-        dvy = pbc[1]*h_rate[1] + pbc[3]*h_rate[3];
-        dvz = pbc[2]*h_rate[2];
-        for (i = 0; i < n; i++) {
-          j = list[i];
-          buf[m++] = x[j][0] + dx;
-          buf[m++] = x[j][1] + dy;
-          buf[m++] = x[j][2] + dz;
-          buf[m++] = ubuf(type[j]).d;
-          buf[m++] = rmass[j];
-          buf[m++] = density[j];
-          if (mask[i] & deform_groupbit) {
-            buf[m++] = v[j][0] + dvx;
-            buf[m++] = v[j][1] + dvy;
-            buf[m++] = v[j][2] + dvz;
-          } else {
-            buf[m++] = v[j][0];
-            buf[m++] = v[j][1];
-            buf[m++] = v[j][2];
-          }
-          buf[m++] = omega[j][0];
-          buf[m++] = omega[j][1];
-          buf[m++] = omega[j][2];
-
-          buf[m++] = mca_inertia[j];
-          buf[m++] = theta[j][0];
-          buf[m++] = theta[j][1];
-          buf[m++] = theta[j][2];
-          buf[m++] = theta_prev[j][0];
-          buf[m++] = theta_prev[j][1];
-          buf[m++] = theta_prev[j][2];
-          buf[m++] = mean_stress[j];
-          buf[m++] = mean_stress_prev[j];
-          buf[m++] = equiv_stress[j];
-          buf[m++] = equiv_stress_prev[j];
-          buf[m++] = equiv_strain[j];
-          buf[m++] = cont_distance[j]
-          buf[m++] = plastic_heat[j];
-        }
-      }
-    }
-  } */
-
-//if (logfile) fprintf(logfile,"AtomVecMCA::pack_comm_vel m=%d n=%d [%d - %d]\n",m,n,list[0],list[n-1]);///
   return m;
 }
 
@@ -871,66 +549,7 @@ int AtomVecMCA::pack_comm_vel(int n, int *list, double *buf,
 
 int AtomVecMCA::pack_comm_hybrid(int n, int *list, double *buf)
 {
-  int i,j,m;
-  int k,l;
-
-  m = 0;
-///AS  if (radvary == 0) {
-    for (i = 0; i < n; i++) {
-      j = list[i];
-      buf[m++] = theta[j][0];
-      buf[m++] = theta[j][1];
-      buf[m++] = theta[j][2];
-      buf[m++] = theta_prev[j][0];
-      buf[m++] = theta_prev[j][1];
-      buf[m++] = theta_prev[j][2];
-      buf[m++] = mean_stress[j];
-      buf[m++] = mean_stress_prev[j];
-      buf[m++] = equiv_stress[j];
-      buf[m++] = equiv_stress_prev[j];
-      buf[m++] = equiv_strain[j];
-      buf[m++] = cont_distance[j];
-      buf[m++] = plastic_heat[j];
-      buf[m++] = ubuf(num_bond[j]).d;
-      for (k = 0; k < num_bond[j]; k++) {
-        buf[m++] = ubuf(bond_type[j][k]).d;
-        buf[m++] = ubuf(bond_atom[j][k]).d;
-        buf[m++] = ubuf(bond_index[j][k]).d;
-        buf[m++] = ubuf(bond_mca[j][k]).d;
-      }
-      if(atom->n_bondhist)
-      {
-          int tag_j = tag[j] - 1;
-          for (k = 0; k < num_bond[j]; k++)
-             for (l = 0; l < atom->n_bondhist; l++)
-                buf[m++] = bond_hist[tag_j][k][l];
-      }
-    }
-/* AS
-  } else {
-    for (i = 0; i < n; i++) {
-      j = list[i];
-      buf[m++] = ubuf(type[j]).d;
-      buf[m++] = rmass[j];
-      buf[m++] = density[j];
-      buf[m++] = mca_inertia[j];
-      buf[m++] = theta[j][0];
-      buf[m++] = theta[j][1];
-      buf[m++] = theta[j][2];
-      buf[m++] = theta_prev[j][0];
-      buf[m++] = theta_prev[j][1];
-      buf[m++] = theta_prev[j][2];
-      buf[m++] = mean_stress[j];
-      buf[m++] = mean_stress_prev[j];
-      buf[m++] = equiv_stress[j];
-      buf[m++] = equiv_stress_prev[j];
-      buf[m++] = equiv_strain[j];
-      buf[m++] = cont_distance[j]
-      buf[m++] = plastic_heat[j];
-    }
- } */
-if (logfile) fprintf(logfile,"AtomVecMCA::pack_comm_hybrid m=%d n=%d \n",m,n);
-  return m;
+  return 0;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -938,70 +557,14 @@ if (logfile) fprintf(logfile,"AtomVecMCA::pack_comm_hybrid m=%d n=%d \n",m,n);
 void AtomVecMCA::unpack_comm(int n, int first, double *buf)
 {
   int i,m,last;
-  int k,l;
 
   m = 0;
-///AS if (radvary == 0) {
   last = first + n;
   for (i = first; i < last; i++) {
     x[i][0] = buf[m++];
     x[i][1] = buf[m++];
     x[i][2] = buf[m++];
-    theta[i][0] = buf[m++];
-    theta[i][1] = buf[m++];
-    theta[i][2] = buf[m++];
-    theta_prev[i][0] = buf[m++];
-    theta_prev[i][1] = buf[m++];
-    theta_prev[i][2] = buf[m++];
-    mean_stress[i] = buf[m++];
-    mean_stress_prev[i] = buf[m++];
-    equiv_stress[i] = buf[m++];
-    equiv_stress_prev[i] = buf[m++];
-    equiv_strain[i] = buf[m++];
-    cont_distance[i] = buf[m++];
-    plastic_heat[i] = buf[m++];
-    num_bond[i] = (int) ubuf(buf[m++]).i;
-    for (k = 0; k < num_bond[i]; k++) {
-      bond_type[i][k] = (int) ubuf(buf[m++]).i;
-      bond_atom[i][k] = (int) ubuf(buf[m++]).i;
-      bond_index[i][k] = (int) ubuf(buf[m++]).i;
-      bond_mca[i][k] = (int) ubuf(buf[m++]).i;
-    }
-    if(atom->n_bondhist)
-    {
-        int tag_i = tag[i] - 1;
-        for (k = 0; k < num_bond[i]; k++)
-          for (l = 0; l < atom->n_bondhist; l++)
-            bond_hist[tag_i][k][l] = buf[m++];
-    }
-   }
-/*AS  } else {
-    m = 0;
-    last = first + n;
-    for (i = first; i < last; i++) {
-      x[i][0] = buf[m++];
-      x[i][1] = buf[m++];
-      x[i][2] = buf[m++];
-      type[i] = (int) ubuf(buf[m++]).i;
-      rmass[i] = buf[m++];
-      density[i] = buf[m++];
-      mca_inertia[i] = buf[m++];
-      theta[i][0] = buf[m++];
-      theta[i][1] = buf[m++];
-      theta[i][2] = buf[m++];
-      theta_prev[i][0] = buf[m++];
-      theta_prev[i][1] = buf[m++];
-      theta_prev[i][2] = buf[m++];
-      mean_stress[i] = buf[m++];
-      mean_stress_prev[i] = buf[m++];
-      equiv_stress[i] = buf[m++];
-      equiv_stress_prev[i] = buf[m++];
-      equiv_strain[i] = buf[m++];
-      cont_distance[i] = buf[m++];
-      plastic_heat[i] = buf[m++];
-    }
-  } */
-if (logfile) fprintf(logfile,"AtomVecMCA::unpack_comm m=%d n=%d \n",m,n);
+  }
 }
 
 /* ---------------------------------------------------------------------- */
@@ -1009,9 +572,7 @@ if (logfile) fprintf(logfile,"AtomVecMCA::unpack_comm m=%d n=%d \n",m,n);
 void AtomVecMCA::unpack_comm_vel(int n, int first, double *buf)
 {
   int i,m,last;
-  int k,l;
 
-///AS if (radvary == 0) {
   m = 0;
   last = first + n;
   for (i = first; i < last; i++) {
@@ -1021,139 +582,17 @@ void AtomVecMCA::unpack_comm_vel(int n, int first, double *buf)
     v[i][0] = buf[m++];
     v[i][1] = buf[m++];
     v[i][2] = buf[m++];
-/*
     omega[i][0] = buf[m++];
     omega[i][1] = buf[m++];
     omega[i][2] = buf[m++];
-    theta[i][0] = buf[m++];
-    theta[i][1] = buf[m++];
-    theta[i][2] = buf[m++];
-    theta_prev[i][0] = buf[m++];
-    theta_prev[i][1] = buf[m++];
-    theta_prev[i][2] = buf[m++];
-    mean_stress[i] = buf[m++];
-    mean_stress_prev[i] = buf[m++];
-    equiv_stress[i] = buf[m++];
-    equiv_stress_prev[i] = buf[m++];
-    equiv_strain[i] = buf[m++];
-    cont_distance[i] = buf[m++];
-    plastic_heat[i] = buf[m++];
-    num_bond[i] = (int) ubuf(buf[m++]).i;
-//if(tag[i]==10) if (logfile) fprintf(logfile,"unpack_comm_vel num_bond[%d(tag=%d)]=%d\n",i,tag[i],num_bond[i]);
-    for (k = 0; k < num_bond[i]; k++) {
-      bond_type[i][k] = (int) ubuf(buf[m++]).i;
-      bond_atom[i][k] = (int) ubuf(buf[m++]).i;
-      bond_index[i][k] = (int) ubuf(buf[m++]).i;
-      bond_mca[i][k] = (int) ubuf(buf[m++]).i;
-//if(tag[i]==10) if (logfile) fprintf(logfile,"\tbond_atom[i][%d]=%d m=%d buf[m]=%+20.14e\n",k,bond_atom[i][k],m-1,buf[m-1]);
-    }
-    if(atom->n_bondhist)
-    {
-        int tag_i = tag[i] - 1;
-        for (k = 0; k < num_bond[i]; k++)
-          for (l = 0; l < atom->n_bondhist; l++)
-            bond_hist[tag_i][k][l] = buf[m++];
-    }*/
   }
-/*AS
-  } else {
-    m = 0;
-    last = first + n;
-    for (i = first; i < last; i++) {
-      x[i][0] = buf[m++];
-      x[i][1] = buf[m++];
-      x[i][2] = buf[m++];
-      type[i] = (int) ubuf(buf[m++]).i;
-      rmass[i] = buf[m++];
-      density[i] = buf[m++];
-      v[i][0] = buf[m++];
-      v[i][1] = buf[m++];
-      v[i][2] = buf[m++];
-      omega[i][0] = buf[m++];
-      omega[i][1] = buf[m++];
-      omega[i][2] = buf[m++];
-
-      mca_inertia[i] = buf[m++];
-      theta[i][0] = buf[m++];
-      theta[i][1] = buf[m++];
-      theta[i][2] = buf[m++];
-      theta_prev[i][0] = buf[m++];
-      theta_prev[i][1] = buf[m++];
-      theta_prev[i][2] = buf[m++];
-      mean_stress[i] = buf[m++];
-      mean_stress_prev[i] = buf[m++];
-      equiv_stress[i] = buf[m++];
-      equiv_stress_prev[i] = buf[m++];
-      equiv_strain[i] = buf[m++];
-      cont_distance[i] = buf[m++];
-      plastic_heat[i] = buf[m++];
-    }
-  } */
-//if (logfile) fprintf(logfile,"AtomVecMCA::unpack_comm_vel m=%d n=%d [%d - %d]\n",m,n,first,last);///
 }
 
 /* ---------------------------------------------------------------------- */
 
 int AtomVecMCA::unpack_comm_hybrid(int n, int first, double *buf)
 {
-  int i,m,last;
-  int k,l;
-
-  m = 0;
-  last = first + n;
-///AS if (radvary == 0) {
-  for (i = first; i < last; i++) {
-    theta[i][0] = buf[m++];
-    theta[i][1] = buf[m++];
-    theta[i][2] = buf[m++];
-    theta_prev[i][0] = buf[m++];
-    theta_prev[i][1] = buf[m++];
-    theta_prev[i][2] = buf[m++];
-    mean_stress[i] = buf[m++];
-    mean_stress_prev[i] = buf[m++];
-    equiv_stress[i] = buf[m++];
-    equiv_stress_prev[i] = buf[m++];
-    equiv_strain[i] = buf[m++];
-    cont_distance[i] = buf[m++];
-    plastic_heat[i] = buf[m++];
-    num_bond[i] = (int) ubuf(buf[m++]).i;
-    for (k = 0; k < num_bond[i]; k++) {
-      bond_type[i][k] = (int) ubuf(buf[m++]).i;
-      bond_atom[i][k] = (int) ubuf(buf[m++]).i;
-      bond_index[i][k] = (int) ubuf(buf[m++]).i;
-      bond_mca[i][k] = (int) ubuf(buf[m++]).i;
-    }
-    if(atom->n_bondhist)
-    {
-        int tag_i = tag[i] - 1;
-        for (k = 0; k < num_bond[i]; k++)
-          for (l = 0; l < atom->n_bondhist; l++)
-            bond_hist[tag_i][k][l] = buf[m++];
-    }
-   }
-/*  } else {
-  for (i = first; i < last; i++) {
-    type[i] = (int) ubuf(buf[m++]).i;
-    rmass[i] = buf[m++];
-    density[i] = buf[m++];
-    mca_inertia[i] = buf[m++];
-    theta[i][0] = buf[m++];
-    theta[i][1] = buf[m++];
-    theta[i][2] = buf[m++];
-    theta_prev[i][0] = buf[m++];
-    theta_prev[i][1] = buf[m++];
-    theta_prev[i][2] = buf[m++];
-    mean_stress[i] = buf[m++];
-    mean_stress_prev[i] = buf[m++];
-    equiv_stress[i] = buf[m++];
-    equiv_stress_prev[i] = buf[m++];
-    equiv_strain[i] = buf[m++];
-    cont_distance[i] = buf[m++];
-    plastic_heat[i] = buf[m++];
-  }
-  }*/
-if (logfile) fprintf(logfile,"AtomVecMCA::unpack_comm_hybrid m=%d n=%d \n",m,n);
-  return m;
+  return 0;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -1165,17 +604,13 @@ int AtomVecMCA::pack_reverse(int n, int first, double *buf)
   m = 0;
   last = first + n;
   for (i = first; i < last; i++) {
-/*
     buf[m++] = f[i][0];
     buf[m++] = f[i][1];
     buf[m++] = f[i][2];
     buf[m++] = torque[i][0];
     buf[m++] = torque[i][1];
     buf[m++] = torque[i][2];
-*/
-    buf[m++] = cont_distance[i];
   }
-//if (logfile) fprintf(logfile,"AtomVecMCA::pack_reverse m=%d n=%d first=%d\n",m,n,first);
   return m;
 }
 
@@ -1188,10 +623,9 @@ int AtomVecMCA::pack_reverse_hybrid(int n, int first, double *buf)
   m = 0;
   last = first + n;
   for (i = first; i < last; i++) {
-/*    buf[m++] = torque[i][0];
+    buf[m++] = torque[i][0];
     buf[m++] = torque[i][1];
-    buf[m++] = torque[i][2];*/
-    buf[m++] = cont_distance[i];
+    buf[m++] = torque[i][2];
   }
   return m;
 }
@@ -1205,17 +639,13 @@ void AtomVecMCA::unpack_reverse(int n, int *list, double *buf)
   m = 0;
   for (i = 0; i < n; i++) {
     j = list[i];
-/*
-    f[j][0] += buf[m++];/// += buf[m++];
-    f[j][1] += buf[m++];/// += buf[m++];
-    f[j][2] += buf[m++];/// += buf[m++];
-    torque[j][0] += buf[m++];/// += buf[m++];
-    torque[j][1] += buf[m++];/// += buf[m++];
-    torque[j][2] += buf[m++];/// += buf[m++];
-*/
-    cont_distance[i] = buf[m++];
+    f[j][0] += buf[m++];
+    f[j][1] += buf[m++];
+    f[j][2] += buf[m++];
+    torque[j][0] += buf[m++];
+    torque[j][1] += buf[m++];
+    torque[j][2] += buf[m++];
   }
-//if (logfile) fprintf(logfile,"AtomVecMCA::unpack_reverse m=%d n=%d first=%d\n",m,n,list[0]);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -1227,10 +657,9 @@ int AtomVecMCA::unpack_reverse_hybrid(int n, int *list, double *buf)
   m = 0;
   for (i = 0; i < n; i++) {
     j = list[i];
-/*    torque[j][0] = buf[m++];/// += buf[m++];
-    torque[j][1] = buf[m++];/// += buf[m++];
-    torque[j][2] = buf[m++];/// += buf[m++];*/
-    cont_distance[i] = buf[m++];
+    torque[j][0] += buf[m++];
+    torque[j][1] += buf[m++];
+    torque[j][2] += buf[m++];
   }
   return m;
 }
@@ -1281,10 +710,9 @@ int AtomVecMCA::pack_border(int n, int *list, double *buf,
         buf[m++] = ubuf(bond_mca[j][k]).d;
       }
       if(atom->n_bondhist) {
-        int tag_j = tag[j] - 1;
         for (k = 0; k < num_bond[j]; k++)
           for (l = 0; l < atom->n_bondhist; l++)
-            buf[m++] = bond_hist[tag_j][k][l];
+            buf[m++] = bond_hist[j][k][l];
       }
     }
   } else {
@@ -1332,10 +760,9 @@ int AtomVecMCA::pack_border(int n, int *list, double *buf,
         buf[m++] = ubuf(bond_mca[j][k]).d;
       }
       if(atom->n_bondhist) {
-        int tag_j = tag[j] - 1;
         for (k = 0; k < num_bond[j]; k++)
           for (l = 0; l < atom->n_bondhist; l++)
-            buf[m++] = bond_hist[tag_j][k][l];
+            buf[m++] = bond_hist[j][k][l];
       }
     }
   }
@@ -1405,12 +832,11 @@ int AtomVecMCA::pack_border_vel(int n, int *list, double *buf,
         buf[m++] = ubuf(bond_index[j][k]).d;
         buf[m++] = ubuf(bond_mca[j][k]).d;
       }
-///      if(atom->n_bondhist) {
-///        int tag_j = tag[j] - 1;
-///        for (k = 0; k < num_bond[j]; k++)
-///          for (l = 0; l < atom->n_bondhist; l++)
-///            ;///buf[m++] = bond_hist[tag_j][k][l];
-///      }
+      if(atom->n_bondhist) {
+        for (k = 0; k < num_bond[j]; k++)
+          for (l = 0; l < atom->n_bondhist; l++)
+            buf[m++] = bond_hist[j][k][l];
+      }
     }
   } else {
     if (domain->triclinic == 0) {
@@ -1469,12 +895,11 @@ int AtomVecMCA::pack_border_vel(int n, int *list, double *buf,
           buf[m++] = ubuf(bond_mca[j][k]).d;
 //if(tag[j]==10) if (logfile) fprintf(logfile,"\tbond_atom[j][%d]=%d m=%d buf[m]=%+20.14e\n",k,bond_atom[j][k],m-1,buf[m-1]);
         }
-///        if(atom->n_bondhist) {
-///          int tag_j = tag[j] - 1;
-///          for (k = 0; k < num_bond[j]; k++)
-///            for (l = 0; l < atom->n_bondhist; l++)
-///              ;///buf[m++] = bond_hist[tag_j][k][l];
-///        }
+        if(atom->n_bondhist) {
+          for (k = 0; k < num_bond[j]; k++)
+            for (l = 0; l < atom->n_bondhist; l++)
+              buf[m++] = bond_hist[j][k][l];
+        }
       }
     } else {
       dvx = pbc[0]*h_rate[0] + pbc[5]*h_rate[5] + pbc[4]*h_rate[4];
@@ -1528,12 +953,11 @@ int AtomVecMCA::pack_border_vel(int n, int *list, double *buf,
           buf[m++] = ubuf(bond_index[j][k]).d;
           buf[m++] = ubuf(bond_mca[j][k]).d;
         }
-///        if(atom->n_bondhist) {
-///          int tag_j = tag[j] - 1;
-///          for (k = 0; k < num_bond[j]; k++)
-///            for (l = 0; l < atom->n_bondhist; l++)
-///              ;///buf[m++] = bond_hist[tag_j][k][l];
-///        }
+        if(atom->n_bondhist) {
+          for (k = 0; k < num_bond[j]; k++)
+            for (l = 0; l < atom->n_bondhist; l++)
+              buf[m++] = bond_hist[j][k][l];
+        }
       }
     }
   }
@@ -1583,10 +1007,9 @@ int AtomVecMCA::pack_border_hybrid(int n, int *list, double *buf)
       buf[m++] = ubuf(bond_mca[j][k]).d;
     }
     if(atom->n_bondhist) {
-      int tag_j = tag[j] - 1;
       for (k = 0; k < num_bond[j]; k++)
         for (l = 0; l < atom->n_bondhist; l++)
-          buf[m++] = bond_hist[tag_j][k][l];
+          buf[m++] = bond_hist[j][k][l];
     }
   }
   return m;
@@ -1636,10 +1059,9 @@ void AtomVecMCA::unpack_border(int n, int first, double *buf)
       bond_mca[i][k] = (int) ubuf(buf[m++]).i;
     }
     if(atom->n_bondhist) {
-      int tag_i = tag[i] - 1;
       for (k = 0; k < num_bond[i]; k++)
         for (l = 0; l < atom->n_bondhist; l++)
-          bond_hist[tag_i][k][l] = buf[m++];
+          bond_hist[i][k][l] = buf[m++];
     }
   }
 
@@ -1703,12 +1125,11 @@ void AtomVecMCA::unpack_border_vel(int n, int first, double *buf)
       bond_mca[i][k] = (int) ubuf(buf[m++]).i;
 //if(tag[i]==10) if (logfile) fprintf(logfile,"\tbond_atom[i][%d]=%d m=%d buf[m]=%+20.14e\n",k,bond_atom[i][k],m-1,buf[m-1]);
     }
-///    if(atom->n_bondhist) {
-///      int tag_i = tag[i] - 1;
-///      for (k = 0; k < num_bond[i]; k++)
-///        for (l = 0; l < atom->n_bondhist; l++)
-///          ;///bond_hist[tag_i][k][l] = buf[m++];
-///    }
+    if(atom->n_bondhist) {
+      for (k = 0; k < num_bond[i]; k++)
+        for (l = 0; l < atom->n_bondhist; l++)
+          bond_hist[i][k][l] = buf[m++];
+    }
   }
 
 if (atom->nextra_border)
@@ -1753,10 +1174,9 @@ int AtomVecMCA::unpack_border_hybrid(int n, int first, double *buf)
       bond_mca[i][k] = (int) ubuf(buf[m++]).i;
     }
     if(atom->n_bondhist) {
-      int tag_i = tag[i] - 1;
       for (k = 0; k < num_bond[i]; k++)
         for (l = 0; l < atom->n_bondhist; l++)
-          bond_hist[tag_i][k][l] = buf[m++];
+          bond_hist[i][k][l] = buf[m++];
     }
   }
   return m;
@@ -1816,10 +1236,9 @@ int AtomVecMCA::pack_exchange(int i, double *buf)
 //if(tag[i]==10) if (logfile) fprintf(logfile,"\tbond_atom[i][%d]=%d m=%d buf[m]=%+20.14e\n",k,bond_atom[i][k],m-1,buf[m-1]);
   }
   if(atom->n_bondhist) {
-    int tag_i = tag[i] - 1;
     for (k = 0; k < num_bond[i]; k++)
       for (l = 0; l < atom->n_bondhist; l++)
-        buf[m++] = bond_hist[tag_i][k][l];
+        buf[m++] = bond_hist[i][k][l];
   }
 
   buf[m++] = ubuf(nspecial[i][0]).d;
@@ -1890,10 +1309,9 @@ int AtomVecMCA::unpack_exchange(double *buf)
 //if(tag[nlocal]==10) if (logfile) fprintf(logfile,"\tbond_atom[nlocal][%d]=%d m=%d buf[m]=%+20.14e\n",k,bond_atom[nlocal][k],m-1,buf[m-1]);
   }
   if(atom->n_bondhist) {
-    int tag_l = tag[nlocal] - 1;
     for (k = 0; k < num_bond[nlocal]; k++)
       for (l = 0; l < atom->n_bondhist; l++)
-        bond_hist[tag_l][k][l] = buf[m++];
+        bond_hist[nlocal][k][l] = buf[m++];
   }
 
   nspecial[nlocal][0] = (int) ubuf(buf[m++]).i;
@@ -1996,11 +1414,12 @@ int AtomVecMCA::pack_restart(int i, double *buf)
   }
 
   if(atom->n_bondhist) {
+    // the double buffered values are written in the order of generation 0
+    const int * const hs = BOND_HIST_SLOT[atom->bond_hist_gen];
     buf[m++] = ubuf(atom->n_bondhist).d;
-    int tag_i = tag[i] - 1;
     for (k = 0; k < num_bond[i]; k++)
       for (l = 0; l < atom->n_bondhist; l++)
-        buf[m++] = bond_hist[tag_i][k][l];
+        buf[m++] = bond_hist[i][k][hs[l]];
   }
 
   if (atom->nextra_restart)
@@ -2073,10 +1492,10 @@ int AtomVecMCA::unpack_restart(double *buf)
   if(atom->n_bondhist) {
     if(atom->n_bondhist != (int) ubuf(buf[m++]).i)
           error->all(FLERR,"Incompatible restart file: file was created using a bond model with a different number of history values");
-    int tag_l = tag[nlocal] - 1;
+    const int * const hs = BOND_HIST_SLOT[atom->bond_hist_gen]; // see pack_restart()
     for (k = 0; k < num_bond[nlocal]; k++)
       for (l = 0; l < atom->n_bondhist; l++)
-        atom->bond_hist[tag_l][k][l] = buf[m++];
+        atom->bond_hist[nlocal][k][hs[l]] = buf[m++];
   }
 
   double **extra = atom->extra;
@@ -2149,6 +1568,7 @@ void AtomVecMCA::create_atom(int itype, double *coord)
   for(int k = 0; k < atom->bond_per_atom; k++) { ///num_bond[nlocal]; k++) {
       bond_index[nlocal][k] = -1;
       bond_mca[nlocal][k] = -1;
+      bond_partner[nlocal][k] = -1;
       for (int l = 0; l < atom->n_bondhist; l++)
         atom->bond_hist[nlocal][k][l] = 0.0;
   }
@@ -2506,6 +1926,7 @@ bigint AtomVecMCA::memory_usage()
   if (atom->memcheck("bond_atom")) bytes += memory->usage(bond_atom,nmax,atom->bond_per_atom);
   if (atom->memcheck("bond_index")) bytes += memory->usage(bond_index,nmax,atom->bond_per_atom);
   if (atom->memcheck("bond_mca")) bytes += memory->usage(bond_mca,nmax,atom->bond_per_atom);
+  if (atom->memcheck("bond_partner")) bytes += memory->usage(bond_partner,nmax,atom->bond_per_atom);
   if (atom->n_bondhist) bytes += nmax*(atom->bond_per_atom)*BOND_HIST_LEN*sizeof(double);  //!! not sure about atom->n_bondhist
 
   return bytes;
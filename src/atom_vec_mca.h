@@ -168,6 +168,7 @@ bond_coeff  N ${COF} ${CrackVelo} ${FRACT_CRITERION} ${FRACT_PARAM} ${BIND_CRITE
   int **bond_type,**bond_atom;
   int **bond_index; //  corresponding index of bondlist[index] in neighbor
   int **bond_mca;   //  local # of bonded automaton
+  int **bond_partner; //  slot of the reverse bond in bond_atom[bond_mca[i][k]], rebuilt at reneighboring
   int n_bondhist;
   double ***bond_hist; //???
 
@@ -220,6 +221,26 @@ namespace MCAAtomConst {
   static const int SY       = 30;// shear force of i
   static const int SZ       = 31;// shear force of i
   static const int BOND_HIST_LEN = 32;// 31 in total
+  // current and _PREV values of R, P, N*, Y* and SH* are double buffered:
+  // the value X is stored in slot BOND_HIST_SLOT[atom->bond_hist_gen][X] of bond_hist,
+  // FixMCAMeanStress::swap_prev() flips atom->bond_hist_gen instead of copying the values
+  static const int BOND_HIST_SLOT[2][BOND_HIST_LEN] = {
+    {0,1,2,3,4,5,6,7, 8, 9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31},
+    {0,1,3,2,4,5,7,6,11,12,13, 8, 9,10,17,18,19,14,15,16,23,24,25,20,21,22,26,27,28,29,30,31}
+  };
+
+  // a bond which keeps its elastic history in a step carries the _PREV values
+  // of P, Y* and SH* over to the current generation
+  inline void keep_elastic_hist(double * const bond_hist_ik, const int * const hs)
+  {
+    bond_hist_ik[hs[P]] = bond_hist_ik[hs[P_PREV]];
+    bond_hist_ik[hs[YX]] = bond_hist_ik[hs[YX_PREV]];
+    bond_hist_ik[hs[YY]] = bond_hist_ik[hs[YY_PREV]];
+    bond_hist_ik[hs[YZ]] = bond_hist_ik[hs[YZ_PREV]];
+    bond_hist_ik[hs[SHX]] = bond_hist_ik[hs[SHX_PREV]];
+    bond_hist_ik[hs[SHY]] = bond_hist_ik[hs[SHY_PREV]];
+    bond_hist_ik[hs[SHZ]] = bond_hist_ik[hs[SHZ_PREV]];
+  }
 /* if newton is 'on' we need also these
   EJ,     // 4 normal strain of j
   PJ,     // 7 normal force of j
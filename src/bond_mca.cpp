@@ -54,6 +54,7 @@
 #include "update.h"
 #include "vector_liggghts.h"
 #include "atom_vec_mca.h"
+#include "bond_mca_break.h"
 #include <string.h>
 
 using namespace LAMMPS_NS;
@@ -66,21 +67,8 @@ using namespace LAMMPS_NS;
 + need evtally implemetation
 */
 
-enum{
-     BREAKSTYLE_NONE,
-     BREAKSTYLE_EQUIV_STRAIN,
-     BREAKSTYLE_EQUIV_STRESS,
-     BREAKSTYLE_DRUCKER_PRAGER
-    };
-
-enum{
-     BINDSTYLE_NONE,
-     BINDSTYLE_PRESSURE,
-     BINDSTYLE_PLASTIC_HEAT,
-     BINDSTYLE_COMBINED,
-    };
-
 using namespace MCAAtomConst;
+using namespace MCABondConst;
 
 /* ---------------------------------------------------------------------- */
 
@@ -106,6 +94,8 @@ BondMCA::BondMCA(LAMMPS *lmp) : Bond(lmp)
     if(comm->me == 0)
         error->warning(FLERR,"BondMCA: This is a beta version - be careful!");
     fix_Temp = NULL;
+    fused = 0;
+    breakstyle = BREAKSTYLE_NONE;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -162,21 +152,12 @@ void  BondMCA::init_style()
 
 void BondMCA::compute(int eflag, int vflag)
 {
-  int *num_bond = atom->num_bond;
-  int **bond_atom = atom->bond_atom;
-  int *tag = atom->tag; // tag of atom is their ID number
-  double ***bond_hist = atom->bond_hist;
-  double **x = atom->x;
-  double *cont_distance = atom->cont_distance;
-
-  int nbondlist = neighbor->nbondlist;
-  int **bondlist = neighbor->bondlist;
-  double cutoff=neighbor->skin;
-  ///AS I do not whant to use it, because it requires to be copied every step/// double **bondhistlist = neighbor->bondhistlist;
-
 //if (logfile) fprintf(logfile, "BondMCA::compute \n"); ///AS DEBUG
 
-  comm->reverse_comm(); /// We copy only contact distances
+  // the bonds have been updated in the force loop of PairMCA::compute_total_force()
+  if (fused) return;
+
+  // contact distances of ghosts are forwarded by PairMCA::compute()
 
 /* TODO AS: It seems we do not need this
   if(breakmode == BREAKSTYLE_STRESS_TEMP) {
@@ -184,173 +165,44 @@ void BondMCA::compute(int eflag, int vflag)
     Temp = fix_Temp->vector_atom;
   } */
 
-//if (logfile) fprintf(logfile,"boxlo[0]=%g boxhi[0]=%g cutoff=%g \n",domain->boxlo[0],domain->boxhi[0],cutoff);
-//if (logfile) fprintf(logfile,"boxlo[1]=%g boxhi[1]=%g cutoff=%g \n",domain->boxlo[1],domain->boxhi[1],cutoff);
-//if (logfile) fprintf(logfile,"boxlo[2]=%g boxhi[2]=%g cutoff=%g \n",domain->boxlo[2],domain->boxhi[2],cutoff);
+  switch (breakstyle) {
+    case BREAKSTYLE_NONE:           compute_eval<BREAKSTYLE_NONE>(); break;
+    case BREAKSTYLE_EQUIV_STRAIN:   compute_eval<BREAKSTYLE_EQUIV_STRAIN>(); break;
+    case BREAKSTYLE_EQUIV_STRESS:   compute_eval<BREAKSTYLE_EQUIV_STRESS>(); break;
+    case BREAKSTYLE_DRUCKER_PRAGER: compute_eval<BREAKSTYLE_DRUCKER_PRAGER>(); break;
+    default:                        compute_eval<BREAKSTYLE_MIXED>(); break;
+  }
+}
 
-  for (int n = 0; n < nbondlist; n++) {
+/* ---------------------------------------------------------------------- */
 
-    int i1 = bondlist[n][0];
-    int i2 = bondlist[n][1];
-    int bond_state = bondlist[n][3];
-    int b_type = bondlist[n][2];
-    int brk_mode = breakmode[b_type];
-    int bind_mode = bindmode[b_type];
+template<int BREAKSTYLE>
+void BondMCA::compute_eval()
+{
+  const int nbondlist = neighbor->nbondlist;
 
-    int n1, n2;
+  // a bond only changes its own state and the STATE slots of its two ends,
+  // so the bonds are independent of each other
+#if defined (_OPENMP)
+#pragma omp parallel for default(shared) schedule(static)
+#endif
+  for (int n = 0; n < nbondlist; n++)
+    update_bond<BREAKSTYLE>(n);
+}
 
-    for (n1 = 0; n1 < num_bond[i1]; n1++) {
-      if (bond_atom[i1][n1]==tag[i2]) break;
-//if (logfile) fprintf(logfile, "BondMCA::compute bond_atom[%d][%d]=%d \n", i1, n1, bond_atom[i1][n1]); ///AS DEBUG
-    }
-    if (n1 == num_bond[i1]) error->all(FLERR,"Internal error in BondMCA::compute(): n1 not found");
-    double *bond_hist1 = bond_hist[tag[i1]-1][n1];
-    for (n2 = 0; n2 < num_bond[i2]; n2++) {
-      if (bond_atom[i2][n2]==tag[i1]) break;
-//if (logfile) fprintf(logfile, "BondMCA::compute bond_atom[%d][%d]=%d \n", i1, n1, bond_atom[i1][n1]); ///AS DEBUG
-    }
-    if (n2 == num_bond[i2]) error->all(FLERR,"Internal error in BondMCA::compute(): n2 not found");
-    double *bond_hist2 = bond_hist[tag[i2]-1][n2];
-    double rIJ = bond_hist1[R];
-    double rJI = bond_hist2[R];
-    if (fabs(rIJ-rJI) > 5.0E-12*(atom->mca_radius)) if (logfile) fprintf(logfile,"BondMCA::compute(): bond %d(%d-%d) rIJ(%-1.16e) != rJI(%-1.16e)\n",n,i1,i2,rIJ,rJI);
-
-    double cont_distance1 = cont_distance[i1];
-    double cont_distance2 = cont_distance[i2];
-
-    //1st check if the bond has been already broken,
-    if(bond_state) { //AS TODO may be corrected in case of slow fracture using crackVelo
-      if(bond_state == NOT_INTERACT) {
-        if(rIJ <= (cont_distance1 + cont_distance2)) {
-          bond_state = bondlist[n][3] = UNBONDED;
-          bond_hist1[STATE] = double(bond_state);
-          bond_hist2[STATE] = double(bond_state);
-///          if (logfile) fprintf(logfile,"BondMCA::compute(): bond %d is contacting\n",n);
-        }
-        else continue;
-      } else {
-        if(rIJ > (cont_distance1 + cont_distance2)) {
-          bond_state = bondlist[n][3] = NOT_INTERACT;
-          bond_hist1[STATE] = double(bond_state);
-          bond_hist2[STATE] = double(bond_state);
-//if (logfile) fprintf(logfile,"BondMCA::compute(): bond %d(%d-%d) of %d : rIJ(%-1.16e) > cont_distance1(%-1.16e)\n",n,i1,i2,nbondlist,rIJ,(cont_distance1 + cont_distance2));
-///          if (logfile) fprintf(logfile,"BondMCA::compute(): bond %d is not interacting\n",n);
-          continue;
-        }
-        if(bind_mode==BINDSTYLE_NONE) continue;
-        else {
-///          if (logfile) fprintf(logfile,"BondMCA::compute(): binding has not been implemented so far\n");
-          continue; // TODO
-        }
-      }
-    }
+/* ----------------------------------------------------------------------
+   choose the break criterion once for all bond types if they agree
+------------------------------------------------------------------------- */
 
-    // breaking the bond if criterion met
-    if(brk_mode == BREAKSTYLE_NONE) continue;
-    else
-    {
-      const PairMCA * const mca_pair = (PairMCA*) force->pair;
-      const double * const mean_stress = atom->mean_stress;
-      const int * const a_type = atom->type;
-      int type1 = a_type[i1];
-      int type2 = a_type[i2];
-      double rT1 = 0.0;
-      double rT2 = 0.0;
-      double criterion_mag = 0.0;
-      bool broken = false;
-      if(brk_mode == BREAKSTYLE_EQUIV_STRAIN) {
-        if(bond_hist1[P] < 0.0) { // In compression we do not break the bond!
-          rT1 = 0.0;
-        } else {
-          rT1 = bond_hist1[E] - mean_stress[i1] / (3.0 * mca_pair->K[type1][type2]);
-        }
-        if(bond_hist2[P] < 0.0) { // In compression we do not break the bond!
-          rT2 = 0.0;
-        } else {
-          rT2 = bond_hist2[E] - mean_stress[i2] / (3.0 * mca_pair->K[type2][type1]);
-        }
-        double vY[3];
-        const double * const vN1 = &(bond_hist1[NX]);       // normal unit vector
-        const double * const vShear1 =  &(bond_hist1[SHX_PREV]); // shear strain
-        vectorCross3D(vShear1, vN1, vY);        // shear
-        rT1 = rT1*rT1 + vectorMag3DSquared(vY); // strain of shape change
-        const double * const vN2 = &(bond_hist2[NX]);       // normal unit vector
-        const double * const vShear2 =  &(bond_hist2[SHX_PREV]); // shear strain
-        vectorCross3D(vShear2, vN2, vY);        // shear
-        rT2 = rT2*rT2 + vectorMag3DSquared(vY); // strain of shape change
-        double mult = 4.0 / 3.0;
-        rT1 = sqrt(mult*rT1);
-        rT2 = sqrt(mult*rT2);
-//fprintf(stderr,"I eps=%g dVVo/=%g rT1= %g\n",apzNbr[iNbrx_I].rE,arMS[iAx_I]/(3.0*azSL[si].rK), rT1);
-//fprintf(stderr,"J eps=%g dVVo/=%g rT2= %g\n",apzNbr[iNbrx_J].rE,arMS[iAx_J]/(3.0*azSL[sj].rK), rT2);
-        criterion_mag = rT1 > rT2 ? rT1 : rT2; //0.5*fabs(rT1 + rT2);
-        broken = breakVal1[b_type] < criterion_mag;
-//if (logfile) fprintf(logfile,"bond# %d EQUIV_STRAIN: breakVal1[%d]=%g  rT1=%g rT2=%g\n", n,  b_type, breakVal1[b_type], rT1, rT2);
-        if(broken) {
-          bond_state = bondlist[n][3] = UNBONDED;
-          bond_hist1[STATE] = double(bond_state);
-          bond_hist2[STATE] = double(bond_state);
-///          if (logfile) fprintf(logfile,"broken bond %d at step %d\n",n,update->ntimestep);
-///          if (logfile) fprintf(logfile,"   it was EQUIV_STRAIN: breakVal1[%d]=%g < criterion_mag=%g\n", b_type, breakVal1[b_type], criterion_mag);
-        }
-      }
-      if(brk_mode == BREAKSTYLE_EQUIV_STRESS) {
-        if(bond_hist1[P] < 0.0) { // In compression we do not break the bond!
-          rT1 = 0.0;
-        } else {
-          rT1 = bond_hist1[P] - mean_stress[i1];
-        }
-        if(bond_hist2[P] < 0.0) { // In compression we do not break the bond!
-          rT2 = 0.0;
-        } else {
-          rT2 = bond_hist2[P] - mean_stress[i2];
-        }
-        const double * const vShF1 =  &(bond_hist1[SX]); // shear force
-        rT1 = rT1*rT1 + vectorMag3DSquared(vShF1); // analogue of equivalent stress
-        const double * const vShF2 =  &(bond_hist2[SX]); // shear force
-        rT2 = rT2*rT2 + vectorMag3DSquared(vShF2); // analogue of equivalent stress
-        double mult = 3.0;
-        rT1 = sqrt(mult*rT1);
-        rT2 = sqrt(mult*rT2);
-        criterion_mag = rT1 > rT2 ? rT1 : rT2;
-        broken = breakVal1[b_type] < criterion_mag;
-        if(broken) {
-          bond_state = bondlist[n][3] = UNBONDED;
-          bond_hist1[STATE] = bond_hist2[STATE] = double(bond_state);
-///          if (logfile) fprintf(logfile,"broken bond %d at step %d\n",n,update->ntimestep);
-///          if (logfile) fprintf(logfile,"   it was EQUIV_STRESS: breakVal1[%d]=%g < criterion_mag=%g\n", b_type, breakVal1[b_type], criterion_mag);
-        }
-      }
-      if(brk_mode == BREAKSTYLE_DRUCKER_PRAGER) {
-        rT1 = bond_hist1[P] - mean_stress[i1];
-        rT2 = bond_hist2[P] - mean_stress[i2];
-        const double * const vShF1 =  &(bond_hist1[SX]); // shear force
-        rT1 = rT1*rT1 + vectorMag3DSquared(vShF1); // analogue of equivalent stress
-        const double * const vShF2 =  &(bond_hist2[SX]); // shear force
-        rT2 = rT2*rT2 + vectorMag3DSquared(vShF2); // analogue of equivalent stress
-        double mult = 3.0;
-        rT1 = sqrt(mult*rT1);
-        rT2 = sqrt(mult*rT2);
-        double q1 = 1.0 + bond_hist1[E];
-        double q2 = 1.0 + bond_hist2[E];
-        rT1 = (rT1 * q1 + rT2 * q2) * 0.5; // Equivalent Stress
-        rT2 = (mean_stress[i1] * q1 + mean_stress[i2] * q2) * 0.5; // Mean Stress
-        criterion_mag = shapeDrPr[b_type] * rT1 + volumeDrPr[b_type] * rT2;
-        broken = breakVal2[b_type] < criterion_mag;
-        if(broken) {
-          bond_state = bondlist[n][3] = UNBONDED;
-          bond_hist1[STATE] = bond_hist2[STATE] = double(bond_state);
-///          if (logfile) fprintf(logfile,"broken bond %d at step %d\n",n,update->ntimestep);
-/////////          if (logfile) fprintf(logfile,"   it was DRUCKER_PRAGER: breakVal1[%d]=%g breakVal2[%d]=%g < criterion_mag=%g\n", b_type, breakVal1[b_type], breakVal2[b_type], criterion_mag);
-        }
-      }
-      if((broken)  && (rIJ > (cont_distance1 + cont_distance2))) {
-          bond_state = bondlist[n][3] = NOT_INTERACT;
-          bond_hist1[STATE] = bond_hist2[STATE] = double(bond_state);
-//          if (logfile) fprintf(logfile,"BondMCA::compute(): bond %d is broken and not interacting\n",n);
-      }
-    }
+void BondMCA::set_breakstyle()
+{
+  breakstyle = -1;
+  for (int i = 1; i <= atom->nbondtypes; i++) {
+    if (!setflag[i]) continue;
+    if (breakstyle < 0) breakstyle = breakmode[i];
+    else if (breakstyle != breakmode[i]) breakstyle = BREAKSTYLE_MIXED;
   }
+  if (breakstyle < 0) breakstyle = BREAKSTYLE_NONE;
 }
 
 /* ----------------------------------------------------------------------
@@ -372,6 +224,7 @@ void BondMCA::build_bond_index()
     const int * const num_bond = atom->num_bond;
     int ** const bond_atom = atom->bond_atom;
     int ** bond_index = atom->bond_index;
+    int ** bond_partner = atom->bond_partner;
     double ***bond_hist = atom->bond_hist;
     const int nlocal = atom->nlocal;
     const int nmax = atom->nmax;
@@ -381,12 +234,10 @@ void BondMCA::build_bond_index()
 
     i1 = bondlist[n][0];
     i2 = bondlist[n][1];
-    for (n1 = 0; n1 < num_bond[i1]; n1++) {
-      const int ib1 = bond_atom[i1][n1];
-      if (ib1==tag[i2]) break;
-    }
-    if (n1 == num_bond[i1]) error->all(FLERR,"Internal error in BondMCA::build_bond_index: n1 not found");
+    n1 = bondlist[n][4]; // slot of the bond in bond_atom[i1], set in Neighbor::bond_all()
+    if (bond_atom[i1][n1] != tag[i2]) error->all(FLERR,"Internal error in BondMCA::build_bond_index: n1 not found");
 
+    // the only search for the reverse bond, kernels use bond_partner afterwards
     for (n2 = 0; n2 < num_bond[i2]; n2++) {
       const int ib2 = bond_atom[i2][n2];
       if (ib2==tag[i1]) break;
@@ -396,8 +247,10 @@ void BondMCA::build_bond_index()
     if (i1 < nmax && i2 < nmax) { /// (i1 < nlocal && i2 < nlocal) { ///??????
       bond_index[i1][n1] = n;
       bond_index[i2][n2] = n;
-      int b_state1 = int(bond_hist[tag[i1]-1][n1][STATE]);
-      int b_state2 = int(bond_hist[tag[i2]-1][n2][STATE]);
+      bond_partner[i1][n1] = n2;
+      bond_partner[i2][n2] = n1;
+      int b_state1 = int(bond_hist[i1][n1][STATE]);
+      int b_state2 = int(bond_hist[i2][n2][STATE]);
       if(b_state1 != b_state2) error->all(FLERR,"Internal error in BondMCA::build_bond_index: b_state1 != b_state2");
       bondlist[n][3] = b_state1;
 //if (logfile) fprintf(logfile, "BondMCA::build_bond_index bond_index[%d][%d]=%d\n",i1,i2,n);///AS DEBUG
@@ -444,9 +297,8 @@ void BondMCA::build_bond_index()
 
     if (num_bond[i] == 0) continue;
 
-    int tag_i = tag[i] - 1;
     int size_bondhist = n_bondhist*sizeof(double);
-    double **bond_hist_i = &(bond_hist[tag_i][0]);
+    double **bond_hist_i = &(bond_hist[i][0]);
     double ** bufTmp = memory->create(bufTmp,bond_per_atom,n_bondhist,"bond_mca:bufTmp");
     memcpy(&(bufTmp[0][0]),&(bond_hist_i[0][0]),bond_per_atom*size_bondhist);
 
@@ -594,6 +446,8 @@ void BondMCA::coeff(int narg, char **arg)
   }
 
   if (count == 0) error->all(FLERR,"Incorrect args for bond coefficients - or the bonds are not initialized in create_atoms");
+
+  set_breakstyle();
 }
 
 /* ----------------------------------------------------------------------
@@ -655,6 +509,7 @@ void BondMCA::read_restart(FILE *fp)
   MPI_Bcast(&bindPlastHeat[1],atom->nbondtypes,MPI_DOUBLE,0,world);
 
   for (int i = 1; i <= atom->nbondtypes; i++) setflag[i] = 1;
+  set_breakstyle();
 }
 
 /* ---------------------------------------------------------------------- */
@@ -52,13 +52,41 @@ BondStyle(mca,BondMCA)
 
 namespace LAMMPS_NS {
 
+namespace MCABondConst {
+  enum{
+       BREAKSTYLE_NONE,
+       BREAKSTYLE_EQUIV_STRAIN,
+       BREAKSTYLE_EQUIV_STRESS,
+       BREAKSTYLE_DRUCKER_PRAGER,
+       BREAKSTYLE_MIXED           // bond types differ, the criterion is chosen per bond
+      };
+
+  enum{
+       BINDSTYLE_NONE,
+       BINDSTYLE_PRESSURE,
+       BINDSTYLE_PLASTIC_HEAT,
+       BINDSTYLE_COMBINED,
+      };
+}
+
+namespace MCABondBreak {
+  template<int BREAKSTYLE> struct Criterion; // see bond_mca_break.h
+}
+
 class BondMCA : public Bond {
+  template<int BREAKSTYLE> friend struct MCABondBreak::Criterion;
+
  public:
   BondMCA(class LAMMPS *);
   ~BondMCA();
   void init_style();
   void compute(int, int);
   void build_bond_index();
+
+  // state update of one bond, defined in bond_mca_break.h
+  template<int BREAKSTYLE> inline void update_bond(const int);
+  int break_style() const { return breakstyle; }
+  int fused; // 1 if PairMCA updates the bonds in its force loop, set by PairMCA::init_style()
   void coeff(int, char **);
   double equilibrium_distance(int);
   void write_restart(FILE *);
@@ -74,7 +102,10 @@ class BondMCA : public Bond {
   double *breakVal1,*breakVal2; // Ultimate value for bond braking. It may be Equivalent Strain OR Equivalent Stress OR Tensile Strength and Compression Strength
   double *shapeDrPr,*volumeDrPr; // Coefficients for computing Drucker-Prager criterion
   double *bindPressure,*bindPlastHeat; // Ultimate value for binding new bond.
+  int breakstyle; // break criterion common to all bond types or BREAKSTYLE_MIXED
   void allocate();
+  void set_breakstyle();
+  template<int BREAKSTYLE> void compute_eval();
 
   class FixPropertyAtom *fix_Temp; ///AS TODO We do not use it for now in MCA
   double *Temp;
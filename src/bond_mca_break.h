@@ -0,0 +1,216 @@
+/* ----------------------------------------------------------------------
+    This is the
+
+    ██╗     ██╗ ██████╗  ██████╗  ██████╗ ██╗  ██╗████████╗███████╗
+    ██║     ██║██╔════╝ ██╔════╝ ██╔════╝ ██║  ██║╚══██╔══╝██╔════╝
+    ██║     ██║██║  ███╗██║  ███╗██║  ███╗███████║   ██║   ███████╗
+    ██║     ██║██║   ██║██║   ██║██║   ██║██╔══██║   ██║   ╚════██║
+    ███████╗██║╚██████╔╝╚██████╔╝╚██████╔╝██║  ██║   ██║   ███████║
+    ╚══════╝╚═╝ ╚═════╝  ╚═════╝  ╚═════╝ ╚═╝  ╚═╝   ╚═╝   ╚══════╝®
+
+    DEM simulation engine, released by
+    DCS Computing Gmbh, Linz, Austria
+    http://www.dcs-computing.com, office@dcs-computing.com
+
+    LIGGGHTS® is part of CFDEM®project:
+    http://www.liggghts.com | http://www.cfdem.com
+
+    Core developer and main author:
+    Christoph Kloss, christoph.kloss@dcs-computing.com
+
+    LIGGGHTS® is open-source, distributed under the terms of the GNU Public
+    License, version 2 or later. It is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. You should have
+    received a copy of the GNU General Public License along with LIGGGHTS®.
+    If not, see http://www.gnu.org/licenses . See also top-level README
+    and LICENSE files.
+
+    LIGGGHTS® and CFDEM® are registered trade marks of DCS Computing GmbH,
+    the producer of the LIGGGHTS® software and the CFDEM®coupling software
+    See http://www.cfdem.com/terms-trademark-policy for details.
+
+-------------------------------------------------------------------------
+    Contributing author and copyright for this file:
+
+    Alexey Smolin (ISPMS SB RAS, Tomsk, Russia, http://www.ispms.ru)
+
+    Copyright 2016-     ISPMS SB RAS, Tomsk, Russia
+------------------------------------------------------------------------- */
+
+
+#ifndef LMP_BOND_MCA_BREAK_H
+#define LMP_BOND_MCA_BREAK_H
+
+#include "math.h"
+#include "stdio.h"
+#include "atom.h"
+#include "force.h"
+#include "neighbor.h"
+#include "bond_mca.h"
+#include "pair_mca.h"
+#include "atom_vec_mca.h"
+#include "vector_liggghts.h"
+
+namespace LAMMPS_NS {
+
+namespace MCABondBreak {
+
+using namespace MCAAtomConst;
+using namespace MCABondConst;
+
+/* ----------------------------------------------------------------------
+   break criteria of MCA bonds, the policy is chosen once in
+   BondMCA::coeff(), BREAKSTYLE_MIXED dispatches per bond type
+   h1,h2 = histories of both ends, ms1,ms2 = their mean stresses
+   K12,K21 = bulk moduli of the type pairs of both ends
+   returns true if the bond is broken
+------------------------------------------------------------------------- */
+
+template<int BREAKSTYLE> struct Criterion;
+
+template<> struct Criterion<BREAKSTYLE_NONE> {
+  static inline bool broken(const BondMCA &, const int, const double * const, const double * const,
+                            const int * const, const double, const double, const double, const double)
+  { return false; }
+};
+
+template<> struct Criterion<BREAKSTYLE_EQUIV_STRAIN> {
+  static inline bool broken(const BondMCA &bond, const int b_type,
+                            const double * const h1, const double * const h2, const int * const hs,
+                            const double ms1, const double ms2, const double K12, const double K21)
+  {
+    // In compression we do not break the bond!
+    double rT1 = h1[hs[P]] < 0.0 ? 0.0 : h1[E] - ms1 / (3.0 * K12);
+    double rT2 = h2[hs[P]] < 0.0 ? 0.0 : h2[E] - ms2 / (3.0 * K21);
+    double vY[3];
+    vectorCross3D(&(h1[hs[SHX_PREV]]), &(h1[hs[NX]]), vY); // shear
+    rT1 = rT1*rT1 + vectorMag3DSquared(vY);                // strain of shape change
+    vectorCross3D(&(h2[hs[SHX_PREV]]), &(h2[hs[NX]]), vY);
+    rT2 = rT2*rT2 + vectorMag3DSquared(vY);
+    // sqrt is monotonic, the root of the larger end is the larger equivalent strain
+    const double mult = 4.0 / 3.0;
+    return bond.breakVal1[b_type] < sqrt(mult * (rT1 > rT2 ? rT1 : rT2));
+  }
+};
+
+template<> struct Criterion<BREAKSTYLE_EQUIV_STRESS> {
+  static inline bool broken(const BondMCA &bond, const int b_type,
+                            const double * const h1, const double * const h2, const int * const hs,
+                            const double ms1, const double ms2, const double, const double)
+  {
+    // In compression we do not break the bond!
+    double rT1 = h1[hs[P]] < 0.0 ? 0.0 : h1[hs[P]] - ms1;
+    double rT2 = h2[hs[P]] < 0.0 ? 0.0 : h2[hs[P]] - ms2;
+    rT1 = rT1*rT1 + vectorMag3DSquared(&(h1[SX])); // analogue of equivalent stress
+    rT2 = rT2*rT2 + vectorMag3DSquared(&(h2[SX]));
+    const double mult = 3.0;
+    return bond.breakVal1[b_type] < sqrt(mult * (rT1 > rT2 ? rT1 : rT2));
+  }
+};
+
+template<> struct Criterion<BREAKSTYLE_DRUCKER_PRAGER> {
+  static inline bool broken(const BondMCA &bond, const int b_type,
+                            const double * const h1, const double * const h2, const int * const hs,
+                            const double ms1, const double ms2, const double, const double)
+  {
+    double rT1 = h1[hs[P]] - ms1;
+    double rT2 = h2[hs[P]] - ms2;
+    rT1 = rT1*rT1 + vectorMag3DSquared(&(h1[SX])); // analogue of equivalent stress
+    rT2 = rT2*rT2 + vectorMag3DSquared(&(h2[SX]));
+    const double mult = 3.0;
+    rT1 = sqrt(mult*rT1);
+    rT2 = sqrt(mult*rT2);
+    const double q1 = 1.0 + h1[E];
+    const double q2 = 1.0 + h2[E];
+    const double rEquiv = (rT1 * q1 + rT2 * q2) * 0.5; // Equivalent Stress
+    const double rMean = (ms1 * q1 + ms2 * q2) * 0.5;  // Mean Stress
+    return bond.breakVal2[b_type] < bond.shapeDrPr[b_type] * rEquiv + bond.volumeDrPr[b_type] * rMean;
+  }
+};
+
+template<> struct Criterion<BREAKSTYLE_MIXED> {
+  static inline bool broken(const BondMCA &bond, const int b_type,
+                            const double * const h1, const double * const h2, const int * const hs,
+                            const double ms1, const double ms2, const double K12, const double K21)
+  {
+    switch (bond.breakmode[b_type]) {
+      case BREAKSTYLE_EQUIV_STRAIN:
+        return Criterion<BREAKSTYLE_EQUIV_STRAIN>::broken(bond,b_type,h1,h2,hs,ms1,ms2,K12,K21);
+      case BREAKSTYLE_EQUIV_STRESS:
+        return Criterion<BREAKSTYLE_EQUIV_STRESS>::broken(bond,b_type,h1,h2,hs,ms1,ms2,K12,K21);
+      case BREAKSTYLE_DRUCKER_PRAGER:
+        return Criterion<BREAKSTYLE_DRUCKER_PRAGER>::broken(bond,b_type,h1,h2,hs,ms1,ms2,K12,K21);
+      default:
+        return false;
+    }
+  }
+};
+
+}
+
+/* ----------------------------------------------------------------------
+   update the state of bond n of the bondlist, called once per step either
+   from BondMCA::compute() or from the force loop of PairMCA
+   a bond only changes its own state and the STATE slots of its two ends
+------------------------------------------------------------------------- */
+
+template<int BREAKSTYLE>
+inline void BondMCA::update_bond(const int n)
+{
+  using namespace MCAAtomConst;
+
+  int ** const bondlist = neighbor->bondlist;
+  double *** const bond_hist = atom->bond_hist;
+  const int * const hs = BOND_HIST_SLOT[atom->bond_hist_gen]; // double buffered slots
+  const double * const cont_distance = atom->cont_distance;
+
+  const int i1 = bondlist[n][0];
+  const int i2 = bondlist[n][1];
+  const int b_type = bondlist[n][2];
+  int bond_state = bondlist[n][3];
+
+  const int n1 = bondlist[n][4];
+  const int n2 = atom->bond_partner[i1][n1];
+  double * const bond_hist1 = bond_hist[i1][n1];
+  double * const bond_hist2 = bond_hist[i2][n2];
+  const double rIJ = bond_hist1[hs[R]];
+  const double rJI = bond_hist2[hs[R]];
+  // R of ghosts is not forwarded every step, see PairMCA::pack_comm()
+  if (i2 < atom->nlocal && fabs(rIJ-rJI) > 5.0E-12*(atom->mca_radius)) if (logfile) fprintf(logfile,"BondMCA::compute(): bond %d(%d-%d) rIJ(%-1.16e) != rJI(%-1.16e)\n",n,i1,i2,rIJ,rJI);
+
+  const double rContact = cont_distance[i1] + cont_distance[i2];
+
+  //1st check if the bond has been already broken,
+  if (bond_state) { //AS TODO may be corrected in case of slow fracture using crackVelo
+    if (bond_state == NOT_INTERACT) {
+      if (rIJ > rContact) return;
+      bond_state = UNBONDED;     // contacting again
+    } else {
+      if (rIJ <= rContact) return; // binding (bindmode) has not been implemented so far
+      bond_state = NOT_INTERACT;
+    }
+    bondlist[n][3] = bond_state;
+    bond_hist1[STATE] = bond_hist2[STATE] = double(bond_state);
+    return;
+  }
+
+  // breaking the bond if criterion met
+  if (BREAKSTYLE == MCABondConst::BREAKSTYLE_NONE) return;
+
+  const int type1 = atom->type[i1];
+  const int type2 = atom->type[i2];
+  const double * const mean_stress = atom->mean_stress;
+  double ** const K = ((PairMCA *) force->pair)->K;
+  if (!MCABondBreak::Criterion<BREAKSTYLE>::broken(*this,b_type,bond_hist1,bond_hist2,hs,
+                                                   mean_stress[i1],mean_stress[i2],
+                                                   K[type1][type2],K[type2][type1])) return;
+
+  bond_state = (rIJ > rContact) ? NOT_INTERACT : UNBONDED;
+  bondlist[n][3] = bond_state;
+  bond_hist1[STATE] = bond_hist2[STATE] = double(bond_state);
+}
+
+}
+
+#endif
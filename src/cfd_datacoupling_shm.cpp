@@ -0,0 +1,396 @@
+/* ----------------------------------------------------------------------
+    This is the
+
+    ██╗     ██╗ ██████╗  ██████╗  ██████╗ ██╗  ██╗████████╗███████╗
+    ██║     ██║██╔════╝ ██╔════╝ ██╔════╝ ██║  ██║╚══██╔══╝██╔════╝
+    ██║     ██║██║  ███╗██║  ███╗██║  ███╗███████║   ██║   ███████╗
+    ██║     ██║██║   ██║██║   ██║██║   ██║██╔══██║   ██║   ╚════██║
+    ███████╗██║╚██████╔╝╚██████╔╝╚██████╔╝██║  ██║   ██║   ███████║
+    ╚══════╝╚═╝ ╚═════╝  ╚═════╝  ╚═════╝ ╚═╝  ╚═╝   ╚═╝   ╚══════╝®
+
+    DEM simulation engine, released by
+    DCS Computing Gmbh, Linz, Austria
+    http://www.dcs-computing.com, office@dcs-computing.com
+
+    LIGGGHTS® is part of CFDEM®project:
+    http://www.liggghts.com | http://www.cfdem.com
+
+    Core developer and main author:
+    Christoph Kloss, christoph.kloss@dcs-computing.com
+
+    LIGGGHTS® is open-source, distributed under the terms of the GNU Public
+    License, version 2 or later. It is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. You should have
+    received a copy of the GNU General Public License along with LIGGGHTS®.
+    If not, see http://www.gnu.org/licenses . See also top-level README
+    and LICENSE files.
+
+    LIGGGHTS® and CFDEM® are registered trade marks of DCS Computing GmbH,
+    the producer of the LIGGGHTS® software and the CFDEM®coupling software
+    See http://www.cfdem.com/terms-trademark-policy for details.
+
+-------------------------------------------------------------------------
+    Contributing author and copyright for this file:
+    (if not contributing author is listed, this file has been contributed
+    by the core developer)
+
+    Copyright 2012-     DCS Computing GmbH, Linz
+    Copyright 2009-2012 JKU Linz
+------------------------------------------------------------------------- */
+
+#include "string.h"
+#include "stdlib.h"
+#include "atom.h"
+#include "update.h"
+#include "error.h"
+#include "memory.h"
+#include "comm.h"
+#include "force.h"
+#include "fix_cfd_coupling.h"
+#include "cfd_datacoupling_shm.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+#define CFD_SHM_NOT_SUPPORTED
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+using namespace LAMMPS_NS;
+
+#define DELTA 10000
+#define ALIGN 64
+#define NSPIN 1000
+#define MAXNAP 1000
+
+// per-atom properties from the atom class that are stored as int
+static const char *int_atom_props[] = {"id","type","mask","image","molecule",NULL};
+
+/* ---------------------------------------------------------------------- */
+
+static int64_t align_up(int64_t n)
+{
+  return (n + ALIGN - 1) / ALIGN * ALIGN;
+}
+
+/* ---------------------------------------------------------------------- */
+
+CfdDatacouplingShm::CfdDatacouplingShm(LAMMPS *lmp, int iarg, int narg, char **arg, FixCfdCoupling *fc) :
+  CfdDatacoupling(lmp, iarg, narg, arg, fc),
+  path_(NULL),
+  fd_(-1),
+  seg_(NULL),
+  segsize_(0),
+  nmax_(0),
+  seq_(0),
+  timeout_(0.)
+{
+#ifdef CFD_SHM_NOT_SUPPORTED
+    error->all(FLERR,"Cfd shm coupling is not supported on this platform");
+#else
+    iarg_ = iarg;
+    if(narg - iarg_ < 1) error->all(FLERR,"Cfd shm coupling: wrong # arguments");
+
+    liggghts_is_active = true;
+    is_parallel = true;
+    this->fc_ = fc;
+
+    if(!atom->tag_enable) error->all(FLERR,"CFD-DEM coupling via shm requires particles to have tags");
+
+    // one segment per proc, <path>.<proc>
+    path_ = new char[strlen(arg[iarg_])+16];
+    sprintf(path_,"%s.%d",arg[iarg_],comm->me);
+    iarg_++;
+
+    if(iarg_ < narg && strcmp(arg[iarg_],"timeout") == 0)
+    {
+        if(narg < iarg_+2) error->all(FLERR,"Cfd shm coupling: not enough arguments for 'timeout'");
+        timeout_ = force->numeric(FLERR,arg[iarg_+1]);
+        iarg_ += 2;
+    }
+
+    fd_ = open(path_,O_RDWR | O_CREAT | O_TRUNC,0600);
+    if(fd_ < 0)
+    {
+        char str[512];
+        sprintf(str,"Cfd shm coupling: cannot open segment %s",path_);
+        error->one(FLERR,str);
+    }
+
+    // empty segment, solver may attach already
+    map(align_up(sizeof(CfdShmHeader)));
+    CfdShmHeader *h = header();
+    memcpy(h->magic,CFD_SHM_MAGIC,8);
+    h->version = CFD_SHM_VERSION;
+    h->nfield = 0;
+    h->size = segsize_;
+    h->me = comm->me;
+    h->nprocs = comm->nprocs;
+#endif
+}
+
+/* ---------------------------------------------------------------------- */
+
+CfdDatacouplingShm::~CfdDatacouplingShm()
+{
+#ifndef CFD_SHM_NOT_SUPPORTED
+    if(seg_)
+    {
+        // tell the solver we are done
+        __atomic_store_n(&header()->seq_dem,(int64_t)-1,__ATOMIC_RELEASE);
+        munmap(seg_,segsize_);
+    }
+    if(fd_ >= 0)
+    {
+        close(fd_);
+        unlink(path_);
+    }
+#endif
+    delete [] path_;
+}
+
+/* ----------------------------------------------------------------------
+   (re)map segment with at least size bytes
+   segment never shrinks so a solver with an old mapping stays valid
+------------------------------------------------------------------------- */
+
+void CfdDatacouplingShm::map(int64_t size)
+{
+#ifndef CFD_SHM_NOT_SUPPORTED
+    if(size < segsize_) size = segsize_;
+    if(seg_ && size == segsize_) return;
+
+    if(seg_) munmap(seg_,segsize_);
+    seg_ = NULL;
+
+    if(ftruncate(fd_,size))
+        error->one(FLERR,"Cfd shm coupling: cannot resize segment");
+    void *ptr = mmap(NULL,size,PROT_READ | PROT_WRITE,MAP_SHARED,fd_,0);
+    if(ptr == MAP_FAILED)
+        error->one(FLERR,"Cfd shm coupling: cannot map segment");
+
+    seg_ = ptr;
+    segsize_ = size;
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   set up field table for current push/pull lists and # of local atoms
+   only rewritten if something changed
+------------------------------------------------------------------------- */
+
+void CfdDatacouplingShm::layout()
+{
+    int nfield = 1 + npush_ + npull_;
+    while(nmax_ < atom->nlocal) nmax_ += DELTA;
+
+    CfdShmField *desc = new CfdShmField[nfield];
+    memset(desc,0,nfield*sizeof(CfdShmField));
+
+    // atom tags first so the solver can identify rows
+
+    strcpy(desc[0].name,"id");
+    strcpy(desc[0].type,"scalar-atom");
+    desc[0].isint = 1;
+    desc[0].peratom = 1;
+    desc[0].len2 = 1;
+
+    int64_t offset = align_up(sizeof(CfdShmHeader) + nfield*sizeof(CfdShmField));
+
+    for(int ifield = 0; ifield < nfield; ifield++)
+    {
+        CfdShmField &d = desc[ifield];
+
+        if(ifield > 0)
+        {
+            int pull = ifield > npush_;
+            const char *name = pull ? pullnames_[ifield-1-npush_] : pushnames_[ifield-1];
+            const char *type = pull ? pulltypes_[ifield-1-npush_] : pushtypes_[ifield-1];
+
+            int len1 = -1, len2 = -1;
+            if(pull) find_pull_property(name,type,len1,len2);
+            else find_push_property(name,type,len1,len2);
+
+            if(strstr(type,"-atom")) d.peratom = 1;
+            else if(!strstr(type,"-global"))
+            {
+                if(screen) fprintf(screen,"Cfd shm coupling: type %s of property %s is not supported\n",type,name);
+                error->one(FLERR,"This is fatal");
+            }
+
+            // names and types are the same on all procs
+            if(strlen(name) >= CFD_SHM_NAMELEN || strlen(type) >= CFD_SHM_NAMELEN)
+            {
+                if(screen) fprintf(screen,"Cfd shm coupling: property %s of type %s, names are limited to %d characters\n",
+                                   name,type,CFD_SHM_NAMELEN-1);
+                error->all(FLERR,"This is fatal");
+            }
+
+            strcpy(d.name,name);
+            strcpy(d.type,type);
+            d.pull = pull;
+            d.len1 = d.peratom ? 0 : len1;
+            d.len2 = len2;
+
+            int len;
+            atom->extract(name,len);
+            if(d.peratom && len >= 0)
+                for(int k = 0; int_atom_props[k]; k++)
+                    if(strcmp(name,int_atom_props[k]) == 0) d.isint = 1;
+        }
+
+        if(d.len1 < 0 || d.len2 < 0)
+            error->one(FLERR,"Cfd shm coupling: property has illegal length");
+
+        int64_t nrows = d.peratom ? nmax_ : d.len1;
+        d.offset = offset;
+        offset += align_up(nrows * d.len2 * (d.isint ? sizeof(int) : sizeof(double)));
+    }
+
+    CfdShmHeader *h = header();
+    if(h->nfield != nfield || h->nmax != nmax_ ||
+       memcmp(fields(),desc,nfield*sizeof(CfdShmField)))
+    {
+        map(offset);
+        h = header();
+        memcpy(fields(),desc,nfield*sizeof(CfdShmField));
+        h->nfield = nfield;
+        h->nmax = nmax_;
+        h->size = segsize_;
+    }
+
+    delete [] desc;
+}
+
+/* ---------------------------------------------------------------------- */
+
+CfdShmField* CfdDatacouplingShm::find_field(const char *name, int pull)
+{
+    CfdShmField *f = fields();
+    int nfield = header()->nfield;
+    for(int ifield = 0; ifield < nfield; ifield++)
+        if(f[ifield].pull == pull && strcmp(f[ifield].name,name) == 0)
+            return &f[ifield];
+    return NULL;
+}
+
+/* ----------------------------------------------------------------------
+   copy between a LIGGGHTS array and its column in the segment
+   per-atom and matrix arrays are contiguous behind their row pointers
+------------------------------------------------------------------------- */
+
+void CfdDatacouplingShm::copy_field(CfdShmField *field, void *ptr, bool to_segment)
+{
+    int64_t nrows = field->peratom ? atom->nlocal : field->len1;
+    int64_t nbytes = nrows * field->len2 * (field->isint ? sizeof(int) : sizeof(double));
+    if(!ptr || nbytes == 0) return;
+
+    bool flat = strcmp(field->type,"scalar-atom") == 0 ||
+                strcmp(field->type,"scalar-global") == 0 ||
+                strcmp(field->type,"vector-global") == 0;
+
+    void *data = flat ? ptr : ((void**)ptr)[0];
+    void *col = (char*)seg_ + field->offset;
+
+    if(to_segment) memcpy(col,data,nbytes);
+    else memcpy(data,col,nbytes);
+}
+
+/* ----------------------------------------------------------------------
+   wait for the solver to answer the current step
+   spin a little first, then back off with growing sleeps
+------------------------------------------------------------------------- */
+
+void CfdDatacouplingShm::wait_solver()
+{
+#ifndef CFD_SHM_NOT_SUPPORTED
+    CfdShmHeader *h = header();
+    double tstart = MPI_Wtime();
+    int nspin = 0;
+    int nap = 1;
+
+    while(__atomic_load_n(&h->seq_cfd,__ATOMIC_ACQUIRE) != seq_)
+    {
+        if(++nspin < NSPIN) continue;
+
+        usleep(nap);
+        if(nap < MAXNAP) nap *= 2;
+
+        if(timeout_ > 0. && MPI_Wtime()-tstart > timeout_)
+        {
+            char str[512];
+            sprintf(str,"Cfd shm coupling: no answer from solver on %s",path_);
+            error->one(FLERR,str);
+        }
+    }
+#endif
+}
+
+/* ---------------------------------------------------------------------- */
+
+void CfdDatacouplingShm::exchange()
+{
+    void *dummy = NULL;
+
+    layout();
+
+    CfdShmHeader *h = header();
+    h->ntimestep = update->ntimestep;
+    h->nlocal = atom->nlocal;
+    h->dt = update->dt;
+
+    copy_field(&fields()[0],atom->tag,true);
+
+    // write to segment
+    for(int i = 0; i < npush_; i++)
+       push(pushnames_[i],pushtypes_[i],dummy,"");
+
+    // publish, solver works in place
+    seq_++;
+    __atomic_store_n(&h->seq_dem,seq_,__ATOMIC_RELEASE);
+    wait_solver();
+
+    // read from segment
+    for(int i = 0; i < npull_; i++)
+       pull(pullnames_[i],pulltypes_[i],dummy,"");
+}
+
+/* ---------------------------------------------------------------------- */
+
+void CfdDatacouplingShm::pull(const char *name, const char *type, void *&from, const char *datatype)
+{
+    CfdDatacoupling::pull(name,type,from,datatype);
+
+    int len1 = -1, len2 = -1;
+    void *to = find_pull_property(name,type,len1,len2);
+    CfdShmField *field = find_field(name,1);
+
+    if(!field || (!to && atom->nlocal))
+    {
+        if(screen) fprintf(screen,"LIGGGHTS could not find property %s to write data from calling program to.\n",name);
+        error->one(FLERR,"This error is fatal");
+    }
+
+    copy_field(field,to,false);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void CfdDatacouplingShm::push(const char *name, const char *type, void *&to, const char *datatype)
+{
+    CfdDatacoupling::push(name,type,to,datatype);
+
+    int len1 = -1, len2 = -1;
+    void *from = find_push_property(name,type,len1,len2);
+    CfdShmField *field = find_field(name,0);
+
+    if(!field || (!from && atom->nlocal))
+    {
+        if(screen) fprintf(screen,"LIGGGHTS could not find property %s to write to calling program.\n",name);
+        error->one(FLERR,"This error is fatal");
+    }
+
+    copy_field(field,from,true);
+}
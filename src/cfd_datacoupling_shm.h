@@ -0,0 +1,136 @@
+/* ----------------------------------------------------------------------
+    This is the
+
+    ██╗     ██╗ ██████╗  ██████╗  ██████╗ ██╗  ██╗████████╗███████╗
+    ██║     ██║██╔════╝ ██╔════╝ ██╔════╝ ██║  ██║╚══██╔══╝██╔════╝
+    ██║     ██║██║  ███╗██║  ███╗██║  ███╗███████║   ██║   ███████╗
+    ██║     ██║██║   ██║██║   ██║██║   ██║██╔══██║   ██║   ╚════██║
+    ███████╗██║╚██████╔╝╚██████╔╝╚██████╔╝██║  ██║   ██║   ███████║
+    ╚══════╝╚═╝ ╚═════╝  ╚═════╝  ╚═════╝ ╚═╝  ╚═╝   ╚═╝   ╚══════╝®
+
+    DEM simulation engine, released by
+    DCS Computing Gmbh, Linz, Austria
+    http://www.dcs-computing.com, office@dcs-computing.com
+
+    LIGGGHTS® is part of CFDEM®project:
+    http://www.liggghts.com | http://www.cfdem.com
+
+    Core developer and main author:
+    Christoph Kloss, christoph.kloss@dcs-computing.com
+
+    LIGGGHTS® is open-source, distributed under the terms of the GNU Public
+    License, version 2 or later. It is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. You should have
+    received a copy of the GNU General Public License along with LIGGGHTS®.
+    If not, see http://www.gnu.org/licenses . See also top-level README
+    and LICENSE files.
+
+    LIGGGHTS® and CFDEM® are registered trade marks of DCS Computing GmbH,
+    the producer of the LIGGGHTS® software and the CFDEM®coupling software
+    See http://www.cfdem.com/terms-trademark-policy for details.
+
+-------------------------------------------------------------------------
+    Contributing author and copyright for this file:
+    (if not contributing author is listed, this file has been contributed
+    by the core developer)
+
+    Copyright 2012-     DCS Computing GmbH, Linz
+    Copyright 2009-2012 JKU Linz
+------------------------------------------------------------------------- */
+
+#ifdef CFD_DATACOUPLING_CLASS
+
+   CfdDataCouplingStyle(shm,CfdDatacouplingShm)
+
+#else
+
+#ifndef LMP_CFD_DATACOUPLING_SHM_H
+#define LMP_CFD_DATACOUPLING_SHM_H
+
+#include "cfd_datacoupling.h"
+#include "stdint.h"
+
+namespace LAMMPS_NS {
+
+/* ----------------------------------------------------------------------
+   coupling through a memory-mapped segment per proc, <path>.<proc>
+   (use a path on tmpfs such as /dev/shm for POSIX shared memory)
+
+   segment layout, native byte order, all offsets from segment start:
+     CfdShmHeader, then nfield x CfdShmField, then the data columns
+   field 0 is always "id" (push, int), the atom tags in local order
+   per-atom columns hold nlocal rows of len2 values, capacity nmax rows
+   global columns hold len1 rows of len2 values
+
+   handshake per coupling step, no locks:
+     LIGGGHTS writes header + push columns, then stores seq_dem = n
+     solver reads push columns, writes pull columns in place,
+       then stores seq_cfd = n
+     LIGGGHTS waits for seq_cfd == n, then reads pull columns
+   seq_dem = -1 signals that LIGGGHTS is done
+   size and nmax may grow between steps, solver has to remap then
+------------------------------------------------------------------------- */
+
+#define CFD_SHM_MAGIC "LGCFDSHM"
+#define CFD_SHM_VERSION 1
+#define CFD_SHM_NAMELEN 32
+
+struct CfdShmHeader {
+  char magic[8];
+  int32_t version;
+  int32_t nfield;
+  int64_t size;            // bytes in the segment
+  int64_t nmax;            // row capacity of per-atom columns
+  int64_t seq_dem;         // last step published by LIGGGHTS
+  int64_t seq_cfd;         // last step answered by the solver
+  int64_t ntimestep;
+  int64_t nlocal;
+  int32_t me,nprocs;
+  double dt;
+};
+
+struct CfdShmField {
+  char name[CFD_SHM_NAMELEN];
+  char type[CFD_SHM_NAMELEN];
+  int32_t pull;            // 0 = LIGGGHTS -> solver, 1 = solver -> LIGGGHTS
+  int32_t isint;           // 1 = int32 values, 0 = double
+  int32_t peratom;         // 1 = nlocal rows, 0 = len1 rows
+  int32_t len1,len2;
+  int32_t pad;
+  int64_t offset;
+};
+
+class CfdDatacouplingShm : public CfdDatacoupling {
+ public:
+  CfdDatacouplingShm(class LAMMPS *, int, int, char **,class FixCfdCoupling*);
+  ~CfdDatacouplingShm();
+
+  void pull(const char *, const char *, void *&, const char *);
+  void push(const char *, const char *, void *&, const char *);
+
+  void exchange();
+
+ private:
+  char *path_;
+  int fd_;
+  void *seg_;
+  int64_t segsize_;
+  int64_t nmax_;
+  int64_t seq_;
+  double timeout_;
+
+  CfdShmHeader *header() {return (CfdShmHeader*)seg_;}
+  CfdShmField *fields() {return (CfdShmField*)((char*)seg_ + sizeof(CfdShmHeader));}
+  CfdShmField *find_field(const char *name, int pull);
+
+  void map(int64_t);
+  void layout();
+  void wait_solver();
+  void copy_field(CfdShmField *, void *, bool);
+};
+
+}
+
+#endif
+#endif
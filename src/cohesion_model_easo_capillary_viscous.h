@@ -87,7 +87,7 @@ namespace ContactModels {
   class CohesionModel<COHESION_EASO_CAPILLARY_VISCOUS> : protected Pointers {
 
   public:
-    static const int MASK = CM_CONNECT_TO_PROPERTIES | CM_SURFACES_INTERSECT | CM_SURFACES_CLOSE;
+    static const int MASK = CM_CONNECT_TO_PROPERTIES | CM_SURFACES_INTERSECT | CM_SURFACES_CLOSE | CM_WRITES_ATOM_DATA; // liquidFlux[i], liquidFlux[j]
 
     int bond_history_offset() {return -1; }
 
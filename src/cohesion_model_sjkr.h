@@ -59,7 +59,7 @@ namespace ContactModels {
   template<>
   class CohesionModel<COHESION_SJKR> : protected Pointers {
   public:
-    static const int MASK = CM_CONNECT_TO_PROPERTIES | CM_SURFACES_INTERSECT;
+    static const int MASK = CM_CONNECT_TO_PROPERTIES | CM_SURFACES_INTERSECT | CM_SURFACES_CLOSE;
 
     int bond_history_offset() {return -1;}
 
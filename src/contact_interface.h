@@ -150,6 +150,62 @@ struct SurfacesIntersectData : SurfacesCloseData {
   SurfacesIntersectData() : Fn(0.0), Ft(0.0) {}
 };
 
+// block of touching pairs as structure of arrays, for contact models which
+// evaluate a whole block in one vectorised loop (see CM_SURFACES_INTERSECT_BATCH)
+// particle-particle contacts of spherical particles only, the force on j is -f
+
+struct SurfacesIntersectBatch {
+  static const int SIZE = 32;
+
+  int n; // number of pairs in the block
+  int computeflag;
+  int shearupdate;
+
+  int i[SIZE];
+  int j[SIZE];
+  int itype[SIZE];
+  int jtype[SIZE];
+  int *contact_flags[SIZE];
+  double *contact_history[SIZE];
+
+  // filled in by the pair style
+  double radi[SIZE];
+  double radj[SIZE];
+  double radsum[SIZE];
+  double deltax[SIZE];
+  double deltay[SIZE];
+  double deltaz[SIZE];
+  double r[SIZE];
+  double rinv[SIZE];
+  double enx[SIZE];
+  double eny[SIZE];
+  double enz[SIZE];
+  double meff[SIZE];
+  double vix[SIZE], viy[SIZE], viz[SIZE];
+  double vjx[SIZE], vjy[SIZE], vjz[SIZE];
+  double omegaix[SIZE], omegaiy[SIZE], omegaiz[SIZE];
+  double omegajx[SIZE], omegajy[SIZE], omegajz[SIZE];
+
+  // surface model
+  double deltan[SIZE];
+  double vn[SIZE];
+  double cri[SIZE];
+  double crj[SIZE];
+  double vtr1[SIZE], vtr2[SIZE], vtr3[SIZE];
+
+  // normal model
+  double kn[SIZE];
+  double kt[SIZE];
+  double gamman[SIZE];
+  double gammat[SIZE];
+  double Fn[SIZE];
+
+  // resulting force on i and torques on i and j
+  double fx[SIZE], fy[SIZE], fz[SIZE];
+  double torqueix[SIZE], torqueiy[SIZE], torqueiz[SIZE];
+  double torquejx[SIZE], torquejy[SIZE], torquejz[SIZE];
+};
+
 struct ForceData {
   double delta_F[3];       // total force acting on particle
   double delta_torque[3];  // torque acting on a particle
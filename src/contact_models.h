@@ -66,6 +66,8 @@ namespace ContactModels
   static const int CM_END_PASS               = 1 << 3;
   static const int CM_SURFACES_INTERSECT     = 1 << 4;
   static const int CM_SURFACES_CLOSE         = 1 << 5;
+  static const int CM_WRITES_ATOM_DATA       = 1 << 6; // writes per-atom data of both partners, not thread-safe
+  static const int CM_SURFACES_INTERSECT_BATCH = 1 << 7; // provides surfacesIntersectBatch()
 
   static const int CONTACT_NORMAL_MODEL      = 1 << 0;
   static const int CONTACT_COHESION_MODEL    = 1 << 1;
@@ -213,6 +215,15 @@ namespace ContactModels
     static const int HANDLE_END_PASS              = MASK & CM_END_PASS;
     static const int HANDLE_SURFACES_INTERSECT    = MASK & CM_SURFACES_INTERSECT;
     static const int HANDLE_SURFACES_CLOSE        = MASK & CM_SURFACES_CLOSE;
+    static const int HANDLE_WRITES_ATOM_DATA      = MASK & CM_WRITES_ATOM_DATA;
+
+    // a block of pairs can only be evaluated at once if all models support it
+    static const int HANDLE_SURFACES_INTERSECT_BATCH = SurfaceModel<Style::SURFACE>::MASK &
+                                                       NormalModel<Style::MODEL>::MASK &
+                                                       CohesionModel<Style::COHESION>::MASK &
+                                                       TangentialModel<Style::TANGENTIAL>::MASK &
+                                                       RollingModel<Style::ROLLING>::MASK &
+                                                       CM_SURFACES_INTERSECT_BATCH;
 
     ContactModel(LAMMPS * lmp, IContactHistorySetup * hsetup, bool _is_wall) :
       ContactModelBase(_is_wall),
@@ -315,13 +326,33 @@ namespace ContactModels
       tangentialModel.surfacesClose(scdata, i_forces, j_forces);
       rollingModel.surfacesClose(scdata, i_forces, j_forces);
     }
+
+    // only instantiated if HANDLE_SURFACES_INTERSECT_BATCH is set
+
+    inline bool checkSurfacesIntersectBatch()
+    {
+      return surfaceModel.checkSurfacesIntersectBatch() &&
+             normalModel.checkSurfacesIntersectBatch() &&
+             cohesionModel.checkSurfacesIntersectBatch() &&
+             tangentialModel.checkSurfacesIntersectBatch() &&
+             rollingModel.checkSurfacesIntersectBatch();
+    }
+
+    inline void surfacesIntersectBatch(SurfacesIntersectBatch & batch)
+    {
+      surfaceModel.surfacesIntersectBatch(batch);
+      normalModel.surfacesIntersectBatch(batch);
+      cohesionModel.surfacesIntersectBatch(batch);
+      tangentialModel.surfacesIntersectBatch(batch);
+      rollingModel.surfacesIntersectBatch(batch);
+    }
   };
 
   template<>
   class TangentialModel<TANGENTIAL_OFF> : protected Pointers
   {
   public:
-    static const int MASK = 0;
+    static const int MASK = CM_SURFACES_INTERSECT_BATCH;
 
     TangentialModel(LAMMPS * lmp, IContactHistorySetup*,class ContactModelBase *c) : Pointers(lmp) {}
     void beginPass(SurfacesIntersectData&, ForceData&, ForceData&){}
@@ -330,13 +361,15 @@ namespace ContactModels
     void registerSettings(Settings&){}
     void surfacesIntersect(SurfacesIntersectData&, ForceData&, ForceData&){}
     void surfacesClose(SurfacesCloseData&, ForceData&, ForceData&){}
+    bool checkSurfacesIntersectBatch() { return true; }
+    void surfacesIntersectBatch(SurfacesIntersectBatch&){}
   };
 
   template<>
   class CohesionModel<COHESION_OFF> : protected Pointers
   {
   public:
-    static const int MASK = 0;
+    static const int MASK = CM_SURFACES_INTERSECT_BATCH;
 
     CohesionModel(LAMMPS * lmp, IContactHistorySetup*,class ContactModelBase *c) : Pointers(lmp) {}
     void beginPass(SurfacesIntersectData&, ForceData&, ForceData&){}
@@ -345,6 +378,8 @@ namespace ContactModels
     void registerSettings(Settings&){}
     void surfacesIntersect(SurfacesIntersectData&, ForceData&, ForceData&){}
     void surfacesClose(SurfacesCloseData&, ForceData&, ForceData&){}
+    bool checkSurfacesIntersectBatch() { return true; }
+    void surfacesIntersectBatch(SurfacesIntersectBatch&){}
 
     int bond_history_offset() {return -1;}
   };
@@ -353,7 +388,7 @@ namespace ContactModels
   class RollingModel<ROLLING_OFF> : protected Pointers
   {
   public:
-    static const int MASK = 0;
+    static const int MASK = CM_SURFACES_INTERSECT_BATCH;
 
     RollingModel(LAMMPS * lmp, IContactHistorySetup*,class ContactModelBase *c) : Pointers(lmp) {}
     void beginPass(SurfacesIntersectData&, ForceData&, ForceData&){}
@@ -362,6 +397,8 @@ namespace ContactModels
     void registerSettings(Settings&){}
     void surfacesIntersect(SurfacesIntersectData&, ForceData&, ForceData&){}
     void surfacesClose(SurfacesCloseData&, ForceData&, ForceData&){}
+    bool checkSurfacesIntersectBatch() { return true; }
+    void surfacesIntersectBatch(SurfacesIntersectBatch&){}
   };
 
   class Factory {
@@ -105,6 +105,8 @@ Dump::Dump(LAMMPS *lmp, int narg, char **arg) : Pointers(lmp)
   append_flag = 0;
   buffer_allow = 0;
   buffer_flag = 0;
+  async_allow = 0;
+  async_flag = 0;
   padflag = 0;
 
   maxbuf = maxids = maxsort = maxproc = 0;
@@ -115,6 +117,8 @@ Dump::Dump(LAMMPS *lmp, int narg, char **arg) : Pointers(lmp)
   maxsbuf = 0;
   sbuf = NULL;
 
+  writer = NULL;
+
   // parse filename for special syntax
   // if contains '%', write one file per proc and replace % with proc-ID
   // if contains '*', write one file per timestep and replace * with timestep
@@ -161,6 +165,8 @@ Dump::Dump(LAMMPS *lmp, int narg, char **arg) : Pointers(lmp)
 
 Dump::~Dump()
 {
+  wait_write();
+
   delete [] id;
   delete [] style;
   delete [] filename;
@@ -197,6 +203,7 @@ Dump::~Dump()
 
 void Dump::init()
 {
+  wait_write();
   init_style();
 
   if (!sort_flag) {
@@ -291,6 +298,10 @@ int Dump::count()
 
 void Dump::write()
 {
+  // previous snapshot may still be in flight on the writer thread
+
+  wait_write();
+
   // if file per timestep, open new file
 
   if (multifile) openfile();
@@ -394,6 +405,16 @@ void Dump::write()
   MPI_Status status;
   MPI_Request request;
 
+  // async = gather this snapshot into the frame buffers
+  //   and hand it off to the writer thread instead of writing it here
+
+  int async = async_flag && filewriter;
+  if (async) {
+    framebuf.clear();
+    framesbuf.clear();
+    framelen.clear();
+  }
+
   // comm and output buf of doubles
 
   if (buffer_flag == 0 || binary) {
@@ -407,9 +428,12 @@ void Dump::write()
           nlines /= size_one;
         } else nlines = nme;
 
-        write_data(nlines,buf);
+        if (async) {
+          framelen.push_back(nlines);
+          framebuf.insert(framebuf.end(),buf,buf+nlines*size_one);
+        } else write_data(nlines,buf);
       }
-      if (flush_flag) fflush(fp);
+      if (flush_flag && !async) fflush(fp);
 
     } else {
     MPI_Recv(&tmp,0,MPI_INT,fileproc,0,world,&status);
@@ -428,9 +452,12 @@ void Dump::write()
           MPI_Get_count(&status,MPI_CHAR,&nchars);
         } else nchars = nsme;
 
-        write_data(nchars,(double *) sbuf);
+        if (async) {
+          framelen.push_back(nchars);
+          framesbuf.insert(framesbuf.end(),sbuf,sbuf+nchars);
+        } else write_data(nchars,(double *) sbuf);
       }
-      if (flush_flag) fflush(fp);
+      if (flush_flag && !async) fflush(fp);
 
     } else {
       MPI_Recv(&tmp,0,MPI_INT,fileproc,0,world,&status);
@@ -438,6 +465,11 @@ void Dump::write()
     }
   }
 
+  if (async) {
+    writer = new std::thread(&Dump::write_frame,this);
+    return;
+  }
+
   // if file per timestep, close file if I am filewriter
 
   if (multifile) {
@@ -449,6 +481,52 @@ void Dump::write()
   }
 }
 
+/* ----------------------------------------------------------------------
+   write snapshot gathered by write() from the frame buffers
+   runs on the writer thread of the filewriter proc
+   only touches fp and the frame buffers, format state is fixed until
+   wait_write() returns
+------------------------------------------------------------------------- */
+
+void Dump::write_frame()
+{
+  int nchunk = framelen.size();
+
+  if (buffer_flag == 0 || binary) {
+    double *ptr = framebuf.data();
+    for (int i = 0; i < nchunk; i++) {
+      write_data(framelen[i],ptr);
+      ptr += framelen[i]*size_one;
+    }
+  } else {
+    char *ptr = framesbuf.data();
+    for (int i = 0; i < nchunk; i++) {
+      write_data(framelen[i],(double *) ptr);
+      ptr += framelen[i];
+    }
+  }
+
+  if (flush_flag) fflush(fp);
+
+  if (multifile) {
+    if (compressed) pclose(fp);
+    else fclose(fp);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   block until the writer thread has finished the previous snapshot
+   must be called before fp, formats or the frame buffers are touched
+------------------------------------------------------------------------- */
+
+void Dump::wait_write()
+{
+  if (writer == NULL) return;
+  writer->join();
+  delete writer;
+  writer = NULL;
+}
+
 /* ----------------------------------------------------------------------
    generic opening of a dump file
    ASCII or binary or gzipped
@@ -740,6 +818,8 @@ void Dump::modify_params(int narg, char **arg)
 {
   if (narg == 0) error->all(FLERR,"Illegal dump_modify command");
 
+  wait_write();
+
   int iarg = 0;
   while (iarg < narg) {
     if (strcmp(arg[iarg],"append") == 0) {
@@ -758,6 +838,15 @@ void Dump::modify_params(int narg, char **arg)
         error->all(FLERR,"Dump_modify buffer yes not allowed for this style");
       iarg += 2;
 
+    } else if (strcmp(arg[iarg],"async") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal dump_modify command");
+      if (strcmp(arg[iarg+1],"yes") == 0) async_flag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) async_flag = 0;
+      else error->all(FLERR,"Illegal dump_modify command");
+      if (async_flag && async_allow == 0)
+        error->all(FLERR,"Dump_modify async yes not allowed for this style");
+      iarg += 2;
+
     } else if (strcmp(arg[iarg],"every") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal dump_modify command");
       int idump;
@@ -49,6 +49,8 @@
 #include "mpi.h"
 #include "stdio.h"
 #include "pointers.h"
+#include <vector>
+#include <thread>
 
 namespace LAMMPS_NS {
 
@@ -72,6 +74,7 @@ class Dump : protected Pointers {
   virtual ~Dump();
   void init();
   virtual void write();
+  void wait_write();
 
   virtual int pack_comm(int, int *, double *, int, int *) {return 0;}
   virtual void unpack_comm(int, int, double *) {}
@@ -103,6 +106,8 @@ class Dump : protected Pointers {
   int append_flag;           // 1 if open file in append mode, 0 if not
   int buffer_allow;          // 1 if style allows for buffer_flag, 0 if not
   int buffer_flag;           // 1 if buffer output as one big string, 0 if not
+  int async_allow;           // 1 if style allows for async_flag, 0 if not
+  int async_flag;            // 1 if file writes run in a background thread
   int padflag;               // timestep padding in filename
   int singlefile_opened;     // 1 = one big file, already opened, else 0
   int sortcol;               // 0 to sort on ID, 1-N on columns
@@ -135,6 +140,14 @@ class Dump : protected Pointers {
   int maxsbuf;               // size of sbuf
   char *sbuf;                // memory for atom quantities in string format
 
+  // snapshot gathered by filewriter, written by writer thread if async_flag
+  // one chunk per proc in my cluster, in lines or chars as for write_data()
+
+  std::thread *writer;            // thread writing the previous snapshot
+  std::vector<double> framebuf;   // chunks of atom quantities
+  std::vector<char> framesbuf;    // chunks of atom quantities as strings
+  std::vector<int> framelen;      // # of lines or chars in each chunk
+
   int maxids;                // size of ids
   int maxsort;               // size of bufsort, idsort, index
   int maxproc;               // size of proclist
@@ -154,6 +167,7 @@ class Dump : protected Pointers {
   virtual void write_data(int, double *) = 0;
 
   void sort();
+  void write_frame();
   static int idcompare(const void *, const void *);
   static int bufcompare(const void *, const void *);
   static int bufcompare_reverse(const void *, const void *);
@@ -203,6 +217,11 @@ Self-explanatory.  Check the input script syntax and compare to the
 documentation for the command.  You can use -echo screen as a
 command-line option when running LAMMPS to see the offending line.
 
+E: Dump_modify async yes not allowed for this style
+
+Only dump styles which write their snapshot from the gathered per-atom
+data can hand it off to a background thread.
+
 E: Cannot use dump_modify fileper without % in dump file name
 
 UNDOCUMENTED
@@ -111,6 +111,7 @@ DumpCustom::DumpCustom(LAMMPS *lmp, int narg, char **arg) :
   vtype = new int[nfield];
 
   buffer_allow = 1;
+  async_allow = 1;
   buffer_flag = 1;
   iregion = -1;
   idregion = NULL;
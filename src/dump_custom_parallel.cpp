@@ -0,0 +1,229 @@
+/* ----------------------------------------------------------------------
+    This is the
+
+    ██╗     ██╗ ██████╗  ██████╗  ██████╗ ██╗  ██╗████████╗███████╗
+    ██║     ██║██╔════╝ ██╔════╝ ██╔════╝ ██║  ██║╚══██╔══╝██╔════╝
+    ██║     ██║██║  ███╗██║  ███╗██║  ███╗███████║   ██║   ███████╗
+    ██║     ██║██║   ██║██║   ██║██║   ██║██╔══██║   ██║   ╚════██║
+    ███████╗██║╚██████╔╝╚██████╔╝╚██████╔╝██║  ██║   ██║   ███████║
+    ╚══════╝╚═╝ ╚═════╝  ╚═════╝  ╚═════╝ ╚═╝  ╚═╝   ╚═╝   ╚══════╝®
+
+    DEM simulation engine, released by
+    DCS Computing Gmbh, Linz, Austria
+    http://www.dcs-computing.com, office@dcs-computing.com
+
+    LIGGGHTS® is part of CFDEM®project:
+    http://www.liggghts.com | http://www.cfdem.com
+
+    Core developer and main author:
+    Christoph Kloss, christoph.kloss@dcs-computing.com
+
+    LIGGGHTS® is open-source, distributed under the terms of the GNU Public
+    License, version 2 or later. It is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. You should have
+    received a copy of the GNU General Public License along with LIGGGHTS®.
+    If not, see http://www.gnu.org/licenses . See also top-level README
+    and LICENSE files.
+
+    LIGGGHTS® and CFDEM® are registered trade marks of DCS Computing GmbH,
+    the producer of the LIGGGHTS® software and the CFDEM®coupling software
+    See http://www.cfdem.com/terms-trademark-policy for details.
+
+-------------------------------------------------------------------------
+    Contributing author and copyright for this file:
+    (if no contributing author is listed, this file has been contributed
+    by the core developer)
+
+    Copyright 2012-     DCS Computing GmbH, Linz
+    Copyright 2009-2012 JKU Linz
+------------------------------------------------------------------------- */
+
+#include "stdlib.h"
+#include "string.h"
+#include "dump_custom_parallel.h"
+#include "atom.h"
+#include "domain.h"
+#include "update.h"
+#include "memory.h"
+#include "error.h"
+
+using namespace LAMMPS_NS;
+
+#define BIG 1.0e30
+#define NINFO 8             // # of index values per block
+
+/* ---------------------------------------------------------------------- */
+
+DumpCustomParallel::DumpCustomParallel(LAMMPS *lmp, int narg, char **arg) :
+  DumpCustom(lmp, narg, arg)
+{
+  if (multiproc || multifile)
+    error->all(FLERR,"Dump custom/parallel file name cannot contain % or *");
+  if (compressed)
+    error->all(FLERR,"Dump custom/parallel cannot write gzipped files");
+
+  // blocks are always raw doubles, no formatting or buffering
+
+  binary = 1;
+  buffer_allow = 0;
+  buffer_flag = 0;
+  async_allow = 0;
+
+  fpdata = NULL;
+  offset = 0;
+
+  blockinfo = NULL;
+  if (me == 0) memory->create(blockinfo,NINFO*nprocs,"dump:blockinfo");
+}
+
+/* ---------------------------------------------------------------------- */
+
+DumpCustomParallel::~DumpCustomParallel()
+{
+  if (fpdata) fclose(fpdata);
+  memory->destroy(blockinfo);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void DumpCustomParallel::init_style()
+{
+  if (sort_flag)
+    error->all(FLERR,"Dump custom/parallel does not support sorting");
+
+  DumpCustom::init_style();
+}
+
+/* ----------------------------------------------------------------------
+   open index file on proc 0 and data file on every proc, one time only
+   when appending, new blocks start at the current end of the data file
+------------------------------------------------------------------------- */
+
+void DumpCustomParallel::openfile()
+{
+  if (singlefile_opened) return;
+  singlefile_opened = 1;
+
+  const char *mode = append_flag ? "ab" : "wb";
+
+  if (me == 0) {
+    fp = fopen(filename,mode);
+    if (fp == NULL) error->one(FLERR,"Cannot open dump file");
+    fseek(fp,0,SEEK_END);
+    if (ftell(fp) == 0) {
+      int n = strlen(columns);
+      fwrite("LPDUMP01",sizeof(char),8,fp);
+      fwrite(&size_one,sizeof(int),1,fp);
+      fwrite(&n,sizeof(int),1,fp);
+      fwrite(columns,sizeof(char),n,fp);
+    }
+  }
+
+  char *name = new char[strlen(filename) + 16];
+  sprintf(name,"%s.%d",filename,me);
+  fpdata = fopen(name,mode);
+  delete [] name;
+  if (fpdata == NULL) error->one(FLERR,"Cannot open dump file");
+  fseek(fpdata,0,SEEK_END);
+  offset = ftell(fpdata);
+}
+
+/* ----------------------------------------------------------------------
+   every proc appends its packed atoms to its own data file
+   only the small per-block index entries are gathered to proc 0
+------------------------------------------------------------------------- */
+
+void DumpCustomParallel::write()
+{
+  // simulation box bounds, used by the scaled and unwrapped pack methods
+
+  if (domain->triclinic == 0) {
+    boxxlo = domain->boxlo[0];
+    boxxhi = domain->boxhi[0];
+    boxylo = domain->boxlo[1];
+    boxyhi = domain->boxhi[1];
+    boxzlo = domain->boxlo[2];
+    boxzhi = domain->boxhi[2];
+  } else {
+    boxxlo = domain->boxlo_bound[0];
+    boxxhi = domain->boxhi_bound[0];
+    boxylo = domain->boxlo_bound[1];
+    boxyhi = domain->boxhi_bound[1];
+    boxzlo = domain->boxlo_bound[2];
+    boxzhi = domain->boxhi_bound[2];
+    boxxy = domain->xy;
+    boxxz = domain->xz;
+    boxyz = domain->yz;
+  }
+
+  nme = count();
+
+  bigint bnme = nme;
+  MPI_Allreduce(&bnme,&ntotal,1,MPI_LMP_BIGINT,MPI_SUM,world);
+
+  if (nme > maxbuf) {
+    if ((bigint) nme * size_one > MAXSMALLINT)
+      error->one(FLERR,"Too much per-proc info for dump");
+    maxbuf = nme;
+    memory->destroy(buf);
+    memory->create(buf,maxbuf*size_one,"dump:buf");
+  }
+
+  pack(NULL);
+
+  // index entry = # of lines, byte offset, bounding box of dumped atoms
+
+  double info[NINFO];
+  info[0] = nme;
+  info[1] = offset;
+  info[2] = info[4] = info[6] = BIG;
+  info[3] = info[5] = info[7] = -BIG;
+
+  double **x = atom->x;
+  for (int i = 0; i < nchoose; i++) {
+    double *xi = x[clist[i]];
+    info[2] = MIN(info[2],xi[0]);
+    info[3] = MAX(info[3],xi[0]);
+    info[4] = MIN(info[4],xi[1]);
+    info[5] = MAX(info[5],xi[1]);
+    info[6] = MIN(info[6],xi[2]);
+    info[7] = MAX(info[7],xi[2]);
+  }
+
+  if (nme) fwrite(buf,sizeof(double),nme*size_one,fpdata);
+  if (flush_flag) fflush(fpdata);
+  offset += (bigint) nme * size_one * sizeof(double);
+
+  MPI_Gather(info,NINFO,MPI_DOUBLE,blockinfo,NINFO,MPI_DOUBLE,0,world);
+
+  if (me == 0) {
+    write_header(ntotal);
+    fwrite(blockinfo,sizeof(double),NINFO*nprocs,fp);
+    if (flush_flag) fflush(fp);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   snapshot record of the index file, followed by the block entries
+------------------------------------------------------------------------- */
+
+void DumpCustomParallel::write_header(bigint ndump)
+{
+  fwrite(&update->ntimestep,sizeof(bigint),1,fp);
+  fwrite(&ndump,sizeof(bigint),1,fp);
+  fwrite(&domain->triclinic,sizeof(int),1,fp);
+  fwrite(&domain->boundary[0][0],6*sizeof(int),1,fp);
+  fwrite(&boxxlo,sizeof(double),1,fp);
+  fwrite(&boxxhi,sizeof(double),1,fp);
+  fwrite(&boxylo,sizeof(double),1,fp);
+  fwrite(&boxyhi,sizeof(double),1,fp);
+  fwrite(&boxzlo,sizeof(double),1,fp);
+  fwrite(&boxzhi,sizeof(double),1,fp);
+  if (domain->triclinic) {
+    fwrite(&boxxy,sizeof(double),1,fp);
+    fwrite(&boxxz,sizeof(double),1,fp);
+    fwrite(&boxyz,sizeof(double),1,fp);
+  }
+  fwrite(&nprocs,sizeof(int),1,fp);
+}
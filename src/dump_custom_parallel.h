@@ -0,0 +1,112 @@
+/* ----------------------------------------------------------------------
+    This is the
+
+    ██╗     ██╗ ██████╗  ██████╗  ██████╗ ██╗  ██╗████████╗███████╗
+    ██║     ██║██╔════╝ ██╔════╝ ██╔════╝ ██║  ██║╚══██╔══╝██╔════╝
+    ██║     ██║██║  ███╗██║  ███╗██║  ███╗███████║   ██║   ███████╗
+    ██║     ██║██║   ██║██║   ██║██║   ██║██╔══██║   ██║   ╚════██║
+    ███████╗██║╚██████╔╝╚██████╔╝╚██████╔╝██║  ██║   ██║   ███████║
+    ╚══════╝╚═╝ ╚═════╝  ╚═════╝  ╚═════╝ ╚═╝  ╚═╝   ╚═╝   ╚══════╝®
+
+    DEM simulation engine, released by
+    DCS Computing Gmbh, Linz, Austria
+    http://www.dcs-computing.com, office@dcs-computing.com
+
+    LIGGGHTS® is part of CFDEM®project:
+    http://www.liggghts.com | http://www.cfdem.com
+
+    Core developer and main author:
+    Christoph Kloss, christoph.kloss@dcs-computing.com
+
+    LIGGGHTS® is open-source, distributed under the terms of the GNU Public
+    License, version 2 or later. It is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. You should have
+    received a copy of the GNU General Public License along with LIGGGHTS®.
+    If not, see http://www.gnu.org/licenses . See also top-level README
+    and LICENSE files.
+
+    LIGGGHTS® and CFDEM® are registered trade marks of DCS Computing GmbH,
+    the producer of the LIGGGHTS® software and the CFDEM®coupling software
+    See http://www.cfdem.com/terms-trademark-policy for details.
+
+-------------------------------------------------------------------------
+    Contributing author and copyright for this file:
+    (if no contributing author is listed, this file has been contributed
+    by the core developer)
+
+    Copyright 2012-     DCS Computing GmbH, Linz
+    Copyright 2009-2012 JKU Linz
+------------------------------------------------------------------------- */
+
+#ifdef DUMP_CLASS
+
+DumpStyle(custom/parallel,DumpCustomParallel)
+
+#else
+
+#ifndef LMP_DUMP_CUSTOM_PARALLEL_H
+#define LMP_DUMP_CUSTOM_PARALLEL_H
+
+#include "dump_custom.h"
+
+namespace LAMMPS_NS {
+
+/* ----------------------------------------------------------------------
+   dump custom variant where every proc writes its own binary block
+
+   per-proc data file  <file>.<proc>  holds the raw packed doubles of
+   every snapshot back to back, no gather to a single writer
+
+   index file <file> is written by proc 0 only:
+     header:   char[8] "LPDUMP01", int size_one, int n, char[n] columns
+     snapshot: bigint ntimestep, bigint natoms, int triclinic,
+               int boundary[6], double box[6] (+ xy,xz,yz if triclinic),
+               int nblock, then per block
+               double nlines, double byte offset, double bbox[6]
+   bbox = bounding box of the dumped atoms of that block
+------------------------------------------------------------------------- */
+
+class DumpCustomParallel : public DumpCustom {
+ public:
+  DumpCustomParallel(class LAMMPS *, int, char **);
+  ~DumpCustomParallel();
+
+  void write();
+
+ private:
+  FILE *fpdata;              // this proc's data file
+  bigint offset;             // bytes written to fpdata so far
+  double *blockinfo;         // per-proc index entries, proc 0 only
+
+  void init_style();
+  void openfile();
+  void write_header(bigint);
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Dump custom/parallel file name cannot contain % or *
+
+Every proc writes its own data file for all snapshots already, so
+neither per-proc nor per-timestep file names are supported.
+
+E: Dump custom/parallel cannot write gzipped files
+
+Self-explanatory.
+
+E: Dump custom/parallel does not support sorting
+
+Blocks are written in the order the atoms are stored on each proc.
+
+E: Cannot open dump file
+
+The output file for the dump command cannot be opened.  Check that the
+path and name are correct.
+
+*/
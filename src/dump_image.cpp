@@ -81,6 +81,10 @@ DumpImage::DumpImage(LAMMPS *lmp, int narg, char **arg) :
   binary = 1;
   multifile_override = 0;
 
+  // image is rendered and written by write() itself, no writer thread
+
+  async_allow = 0;
+
   // set filetype based on filename suffix
 
   int n = strlen(filename);
@@ -62,24 +62,45 @@
 
 #define INVOKED_PERATOM 8
 
+// # of columns compute_array() can return
+#define NCOLS 15
+
 using namespace LAMMPS_NS;
 using namespace FixConst;
 
+enum{SHARED_AVERAGE,SHARED_STRESS,SHARED_WEIGHT};
+
 /* ---------------------------------------------------------------------- */
 
 FixAveEuler::FixAveEuler(LAMMPS *lmp, int narg, char **arg) :
   Fix(lmp, narg, arg),
   parallel_(true),
+  distributed_(false),
   exec_every_(1),
   box_change_size_(false),
   box_change_domain_(false),
   cell_size_ideal_rel_(3.),
   cell_size_ideal_(0.),
   ncells_(0),
+  ncells_global_(0),
   ncells_max_(0),
   ncellptr_max_(0),
   cellhead_(NULL),
   cellptr_(NULL),
+  nswap_(0),
+  swapproc_(NULL),
+  swapfirst_(NULL),
+  swapcell_(NULL),
+  nslot_(0),
+  cellslot_(NULL),
+  slotcell_(NULL),
+  sendbuf_(NULL),
+  recvbuf_(NULL),
+  slotbuf_(NULL),
+  nowned_(0),
+  owned_(NULL),
+  array_global_(NULL),
+  gathered_(false),
   idregion_(NULL),
   region_(NULL),
   center_(NULL),
@@ -101,6 +122,8 @@ FixAveEuler::FixAveEuler(LAMMPS *lmp, int narg, char **arg) :
 
   triclinic_ = domain->triclinic;  
 
+  ilo_[0] = ilo_[1] = ilo_[2] = 0;
+
   // random number generator, seed is hardcoded
   random_ = new RanPark(lmp,15485863);
 
@@ -114,6 +137,7 @@ FixAveEuler::FixAveEuler(LAMMPS *lmp, int narg, char **arg) :
   if(exec_every_ < 1)
     error->fix_error(FLERR,this,"'nevery' > 0 required");
   nevery = exec_every_;
+  global_freq = exec_every_;
 
   if(strcmp(arg[iarg++],"cell_size_relative"))
     error->fix_error(FLERR,this,"expecting keyword 'cell_size_relative'");
@@ -127,8 +151,13 @@ FixAveEuler::FixAveEuler(LAMMPS *lmp, int narg, char **arg) :
     parallel_ = true;
   else if(strcmp(arg[iarg],"no") == 0)
     parallel_ = false;
+  else if(strcmp(arg[iarg],"distributed") == 0)
+  {
+    parallel_ = false;
+    distributed_ = true;
+  }
   else
-    error->fix_error(FLERR,this,"expecting 'yes' or 'no' after 'parallel'");
+    error->fix_error(FLERR,this,"expecting 'yes', 'no' or 'distributed' after 'parallel'");
   iarg++;
 
   while(iarg < narg)
@@ -167,6 +196,16 @@ FixAveEuler::~FixAveEuler()
   memory->destroy(ncount_);
   memory->destroy(mass_);
   memory->destroy(stress_);
+  memory->destroy(swapproc_);
+  memory->destroy(swapfirst_);
+  memory->destroy(swapcell_);
+  memory->destroy(cellslot_);
+  memory->destroy(slotcell_);
+  memory->destroy(sendbuf_);
+  memory->destroy(recvbuf_);
+  memory->destroy(slotbuf_);
+  memory->destroy(owned_);
+  memory->destroy(array_global_);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -310,6 +349,25 @@ void FixAveEuler::setup_bins()
 
     }
 
+    for(int dim = 0; dim < 3; dim++)
+        ncells_dim_global_[dim] = ncells_dim_[dim];
+    ncells_global_ = ncells_dim_[0]*ncells_dim_[1]*ncells_dim_[2];
+
+    // distributed: restrict the global grid to the cells overlapping
+    // my subdomain, same cell index rounding as in coord2bin()
+    if(distributed_)
+    {
+        for(int dim = 0; dim < 3; dim++)
+        {
+            int ilo = static_cast<int>((domain->sublo[dim]-lo_[dim])*cell_size_inv_[dim]);
+            int ihi = static_cast<int>((domain->subhi[dim]-lo_[dim])*cell_size_inv_[dim]);
+            ilo = MAX(0,MIN(ilo,ncells_dim_global_[dim]-1));
+            ihi = MAX(ilo,MIN(ihi,ncells_dim_global_[dim]-1));
+            ilo_[dim] = ilo;
+            ncells_dim_[dim] = ihi-ilo+1;
+        }
+    }
+
     ncells_ = ncells_dim_[0]*ncells_dim_[1]*ncells_dim_[2];
     
     cell_volume_ = cell_size_[0]*cell_size_[1]*cell_size_[2];
@@ -345,14 +403,17 @@ void FixAveEuler::setup_bins()
                   domain->lamda2x(center_[ibin],center_[ibin]);
 
                 } else {
-                    center_[ibin][0] = lo_[0] + (static_cast<double>(ix)+0.5) * cell_size_[0];
-                    center_[ibin][1] = lo_[1] + (static_cast<double>(iy)+0.5) * cell_size_[1];
-                    center_[ibin][2] = lo_[2] + (static_cast<double>(iz)+0.5) * cell_size_[2];
+                    center_[ibin][0] = lo_[0] + (static_cast<double>(ix+ilo_[0])+0.5) * cell_size_[0];
+                    center_[ibin][1] = lo_[1] + (static_cast<double>(iy+ilo_[1])+0.5) * cell_size_[1];
+                    center_[ibin][2] = lo_[2] + (static_cast<double>(iz+ilo_[2])+0.5) * cell_size_[2];
                 }
             }
         }
     }
 
+    if(distributed_)
+        setup_shared();
+
     // calculate weight_[icell]
     if(!region_)
     {
@@ -368,14 +429,25 @@ void FixAveEuler::setup_bins()
         int ntry = ncells_ * ntry_per_cell(); // number of MC tries
         double contribution = 1./static_cast<double>(ntry_per_cell());  // contrib of each try
 
+        // extent of the cells stored on this proc
+        double try_lo[3],try_hi[3];
+        for(int dim = 0; dim < 3; dim++)
+        {
+            try_lo[dim] = lo_[dim] + ilo_[dim]*cell_size_[dim];
+            if(ilo_[dim]+ncells_dim_[dim] == ncells_dim_global_[dim])
+                try_hi[dim] = hi_[dim];
+            else
+                try_hi[dim] = lo_[dim] + (ilo_[dim]+ncells_dim_[dim])*cell_size_[dim];
+        }
+
         for(int icell = 0; icell < ncells_max_; icell++)
             weight_[icell] = 0.;
 
         for(int itry = 0; itry < ntry; itry++)
         {
-            x_try[0] = lo_[0]+(hi_[0]-lo_[0])*random_->uniform();
-            x_try[1] = lo_[1]+(hi_[1]-lo_[1])*random_->uniform();
-            x_try[2] = lo_[2]+(hi_[2]-lo_[2])*random_->uniform();
+            x_try[0] = try_lo[0]+(try_hi[0]-try_lo[0])*random_->uniform();
+            x_try[1] = try_lo[1]+(try_hi[1]-try_lo[1])*random_->uniform();
+            x_try[2] = try_lo[2]+(try_hi[2]-try_lo[2])*random_->uniform();
             if(region_->match(x_try[0],x_try[1],x_try[2]))
             {
                 ibin = coord2bin(x_try);
@@ -386,7 +458,10 @@ void FixAveEuler::setup_bins()
         }
 
         // allreduce weights
-        MPI_Sum_Vector(weight_,ncells_,world);
+        if(distributed_)
+            sum_shared(SHARED_WEIGHT);
+        else
+            MPI_Sum_Vector(weight_,ncells_,world);
 
         // limit weight to 1
         for(int icell = 0; icell < ncells_max_; icell++)
@@ -411,7 +486,7 @@ void FixAveEuler::end_of_step()
 {
     
     // have to adapt grid if box size changes
-    if(box_change_size_ || (parallel_ && box_change_domain_))
+    if(box_change_size_ || ((parallel_ || distributed_) && box_change_domain_))
     {
         if(region_)
             error->warning(FLERR,"Fix ave/euler using 'basevolume_region'"
@@ -434,6 +509,10 @@ int FixAveEuler::ncells_pack()
     if (parallel_)
         return ncells_;
 
+    // in distributed mode, each proc packs the cells it owns
+    if (distributed_)
+        return nowned_;
+
     // in serial mode, only proc 0 will pack
     if(0 == comm->me)
         return ncells_;
@@ -511,7 +590,7 @@ inline int FixAveEuler::coord2bin(double *x)
       if(x[i] <= domain->sublo[i] || x[i] >= domain->subhi[i])
         return -1;
       float_iCell[i] = (x[i]-lo_[i])*cell_size_inv_[i];
-      iCell[i] = static_cast<int> (float_iCell[i]);
+      iCell[i] = static_cast<int> (float_iCell[i]) - ilo_[i];
     }
   }
 
@@ -584,7 +663,10 @@ void FixAveEuler::calculate_eu()
     }
 
     // allreduce contributions so far if not parallel
-    if(!parallel_ && ncells_ > 0)
+    // distributed: only sum up cells shared with other procs
+    if(distributed_)
+        sum_shared(SHARED_AVERAGE);
+    else if(!parallel_ && ncells_ > 0)
     {
         MPI_Sum_Vector(&(v_av_[0][0]),3*ncells_,world);
         MPI_Sum_Vector(vol_fr_,ncells_,world);
@@ -634,13 +716,19 @@ void FixAveEuler::calculate_eu()
     // allreduce stress if not parallel
     if(!parallel_ && ncells_ > 0)
     {
-        MPI_Sum_Vector(&(stress_[0][0]),7*ncells_,world);
+        if(distributed_)
+            sum_shared(SHARED_STRESS);
+        else
+            MPI_Sum_Vector(&(stress_[0][0]),7*ncells_,world);
 
         // recalc pressure based on allreduced stress
         for(int icell = 0; icell < ncells_; icell++)
             stress_[icell][0] = -0.333333333333333*(stress_[icell][1]+stress_[icell][2]+stress_[icell][3]);
     }
 
+    // global array is out of date now
+    gathered_ = false;
+
     // wrap with clear/add
     modify->addstep_compute(update->ntimestep + exec_every_);
 }
@@ -654,9 +742,24 @@ void FixAveEuler::calculate_eu()
 
 double FixAveEuler::compute_array(int i, int j)
 {
+  if(distributed_)
+  {
+    if(!gathered_) gather_array();
+    if(i >= ncells_global_ || j >= NCOLS) return 0.0;
+    return array_global_[i][j];
+  }
+
   if(i >= ncells_) return 0.0;
+  return cell_array(i,j);
+}
+
+/* ----------------------------------------------------------------------
+   array value of local cell i
+------------------------------------------------------------------------- */
 
-  else if(j < 3) return center_[i][j];
+double FixAveEuler::cell_array(int i, int j)
+{
+  if(j < 3) return center_[i][j];
   else if(j == 3) return vol_fr_[i];
   else if(j < 7) return v_av_[i][j-4];
   else if(j == 7) return stress_[i][0];
@@ -664,3 +767,262 @@ double FixAveEuler::compute_array(int i, int j)
   else if(j < 15) return radius_[i];
   else return 0.0;
 }
+
+/* ----------------------------------------------------------------------
+   distributed: find procs whose cell range overlaps mine
+   both sides list the shared cells in the same (global) order
+   also find the cells I own, i.e. whose center is in my subdomain
+------------------------------------------------------------------------- */
+
+void FixAveEuler::setup_shared()
+{
+    int me = comm->me;
+    int nprocs = comm->nprocs;
+
+    int range[6],*range_all;
+    for(int dim = 0; dim < 3; dim++)
+    {
+        range[2*dim] = ilo_[dim];
+        range[2*dim+1] = ilo_[dim]+ncells_dim_[dim]-1;
+    }
+    memory->create(range_all,6*nprocs,"ave/euler:range_all");
+    MPI_Allgather(range,6,MPI_INT,range_all,6,MPI_INT,world);
+
+    memory->destroy(swapproc_);
+    memory->destroy(swapfirst_);
+    memory->create(swapproc_,nprocs,"ave/euler:swapproc_");
+    memory->create(swapfirst_,nprocs+1,"ave/euler:swapfirst_");
+
+    // two passes: count shared cells, then list them
+
+    int lo[3],hi[3];
+    for(int pass = 0; pass < 2; pass++)
+    {
+        int n = 0;
+        nswap_ = 0;
+        for(int iproc = 0; iproc < nprocs; iproc++)
+        {
+            if(iproc == me) continue;
+
+            int *other = &range_all[6*iproc];
+            bool overlap = true;
+            for(int dim = 0; dim < 3; dim++)
+            {
+                lo[dim] = MAX(range[2*dim],other[2*dim]);
+                hi[dim] = MIN(range[2*dim+1],other[2*dim+1]);
+                if(lo[dim] > hi[dim]) overlap = false;
+            }
+            if(!overlap) continue;
+
+            swapproc_[nswap_] = iproc;
+            swapfirst_[nswap_] = n;
+            nswap_++;
+
+            for(int iz = lo[2]; iz <= hi[2]; iz++)
+                for(int iy = lo[1]; iy <= hi[1]; iy++)
+                    for(int ix = lo[0]; ix <= hi[0]; ix++)
+                    {
+                        if(pass == 1)
+                            swapcell_[n] = (iz-ilo_[2])*ncells_dim_[1]*ncells_dim_[0] +
+                                           (iy-ilo_[1])*ncells_dim_[0] + (ix-ilo_[0]);
+                        n++;
+                    }
+        }
+        swapfirst_[nswap_] = n;
+
+        if(pass == 0)
+        {
+            memory->destroy(swapcell_);
+            memory->create(swapcell_,MAX(n,1),"ave/euler:swapcell_");
+        }
+    }
+
+    memory->destroy(range_all);
+
+    // distinct shared cells
+
+    memory->destroy(cellslot_);
+    memory->destroy(slotcell_);
+    memory->create(cellslot_,ncells_,"ave/euler:cellslot_");
+    memory->create(slotcell_,ncells_,"ave/euler:slotcell_");
+
+    for(int icell = 0; icell < ncells_; icell++)
+        cellslot_[icell] = -1;
+
+    nslot_ = 0;
+    for(int k = 0; k < swapfirst_[nswap_]; k++)
+    {
+        int icell = swapcell_[k];
+        if(cellslot_[icell] < 0)
+        {
+            cellslot_[icell] = nslot_;
+            slotcell_[nslot_++] = icell;
+        }
+    }
+
+    // owned cells, center in half-open subdomain
+
+    memory->destroy(owned_);
+    memory->create(owned_,ncells_,"ave/euler:owned_");
+
+    double *sublo = domain->sublo;
+    double *subhi = domain->subhi;
+    nowned_ = 0;
+    for(int icell = 0; icell < ncells_; icell++)
+    {
+        double *c = center_[icell];
+        if(c[0] >= sublo[0] && c[0] < subhi[0] &&
+           c[1] >= sublo[1] && c[1] < subhi[1] &&
+           c[2] >= sublo[2] && c[2] < subhi[2])
+            owned_[nowned_++] = icell;
+    }
+
+    // global array has to be regathered on the new grid
+
+    memory->destroy(array_global_);
+    array_global_ = NULL;
+    gathered_ = false;
+}
+
+/* ----------------------------------------------------------------------
+   distributed: sum contributions to cells shared with other procs
+   contributions are added in order of ascending rank, so all procs
+   sharing a cell end up with bitwise identical values
+------------------------------------------------------------------------- */
+
+void FixAveEuler::sum_shared(int which)
+{
+    if(nswap_ == 0) return;
+
+    int me = comm->me;
+    int nper = 1;
+    if(which == SHARED_AVERAGE) nper = 7;
+    else if(which == SHARED_STRESS) nper = 6;
+
+    int nshared = swapfirst_[nswap_];
+    memory->destroy(sendbuf_);
+    memory->destroy(recvbuf_);
+    memory->destroy(slotbuf_);
+    memory->create(sendbuf_,nshared*nper,"ave/euler:sendbuf_");
+    memory->create(recvbuf_,nshared*nper,"ave/euler:recvbuf_");
+    memory->create(slotbuf_,2*nslot_*nper,"ave/euler:slotbuf_");
+
+    for(int k = 0; k < nshared; k++)
+        pack_shared(which,swapcell_[k],&sendbuf_[k*nper]);
+
+    // exchange with each proc sharing cells
+
+    MPI_Request *request = new MPI_Request[nswap_];
+    MPI_Status status;
+
+    for(int iswap = 0; iswap < nswap_; iswap++)
+    {
+        int first = swapfirst_[iswap];
+        int n = (swapfirst_[iswap+1]-first)*nper;
+        MPI_Irecv(&recvbuf_[first*nper],n,MPI_DOUBLE,swapproc_[iswap],0,world,&request[iswap]);
+    }
+    for(int iswap = 0; iswap < nswap_; iswap++)
+    {
+        int first = swapfirst_[iswap];
+        int n = (swapfirst_[iswap+1]-first)*nper;
+        MPI_Send(&sendbuf_[first*nper],n,MPI_DOUBLE,swapproc_[iswap],0,world);
+    }
+    for(int iswap = 0; iswap < nswap_; iswap++)
+        MPI_Wait(&request[iswap],&status);
+
+    delete [] request;
+
+    // sum up own and received contributions in rank order
+
+    double *own = slotbuf_;
+    double *sum = &slotbuf_[nslot_*nper];
+    for(int islot = 0; islot < nslot_; islot++)
+        pack_shared(which,slotcell_[islot],&own[islot*nper]);
+    vectorZeroizeN(sum,nslot_*nper);
+
+    bool own_added = false;
+    for(int iswap = 0; iswap <= nswap_; iswap++)
+    {
+        if(!own_added && (iswap == nswap_ || swapproc_[iswap] > me))
+        {
+            for(int m = 0; m < nslot_*nper; m++)
+                sum[m] += own[m];
+            own_added = true;
+        }
+        if(iswap == nswap_) break;
+
+        for(int k = swapfirst_[iswap]; k < swapfirst_[iswap+1]; k++)
+        {
+            double *recv = &recvbuf_[k*nper];
+            double *dest = &sum[cellslot_[swapcell_[k]]*nper];
+            for(int m = 0; m < nper; m++)
+                dest[m] += recv[m];
+        }
+    }
+
+    for(int islot = 0; islot < nslot_; islot++)
+        unpack_shared(which,slotcell_[islot],&sum[islot*nper]);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixAveEuler::pack_shared(int which, int icell, double *buf)
+{
+    if(which == SHARED_AVERAGE)
+    {
+        vectorCopy3D(v_av_[icell],buf);
+        buf[3] = vol_fr_[icell];
+        buf[4] = radius_[icell];
+        buf[5] = mass_[icell];
+        buf[6] = static_cast<double>(ncount_[icell]);
+    }
+    else if(which == SHARED_STRESS)
+        vectorCopyN(&stress_[icell][1],buf,6);
+    else
+        buf[0] = weight_[icell];
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixAveEuler::unpack_shared(int which, int icell, double *buf)
+{
+    if(which == SHARED_AVERAGE)
+    {
+        vectorCopy3D(buf,v_av_[icell]);
+        vol_fr_[icell] = buf[3];
+        radius_[icell] = buf[4];
+        mass_[icell] = buf[5];
+        ncount_[icell] = static_cast<int>(buf[6]);
+    }
+    else if(which == SHARED_STRESS)
+        vectorCopyN(buf,&stress_[icell][1],6);
+    else
+        weight_[icell] = buf[0];
+}
+
+/* ----------------------------------------------------------------------
+   distributed: assemble global array from the owned cells of all procs
+   only done when the array is accessed, e.g. by a variable or thermo
+------------------------------------------------------------------------- */
+
+void FixAveEuler::gather_array()
+{
+    if(!array_global_)
+        memory->create(array_global_,MAX(ncells_global_,1),NCOLS,"ave/euler:array_global_");
+    vectorZeroizeN(&(array_global_[0][0]),ncells_global_*NCOLS);
+
+    for(int k = 0; k < nowned_; k++)
+    {
+        int icell = owned_[k];
+        int ix = icell % ncells_dim_[0] + ilo_[0];
+        int iy = (icell / ncells_dim_[0]) % ncells_dim_[1] + ilo_[1];
+        int iz = icell / (ncells_dim_[0]*ncells_dim_[1]) + ilo_[2];
+        int iglobal = iz*ncells_dim_global_[1]*ncells_dim_global_[0] +
+                      iy*ncells_dim_global_[0] + ix;
+        for(int j = 0; j < NCOLS; j++)
+            array_global_[iglobal][j] = cell_array(icell,j);
+    }
+
+    MPI_Sum_Vector(&(array_global_[0][0]),ncells_global_*NCOLS,world);
+    gathered_ = true;
+}
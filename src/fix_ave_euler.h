@@ -74,38 +74,51 @@ class FixAveEuler : public Fix {
   int ncells_pack();
 
   // inline access functions for cell based values
+  // i runs over the cells packed by this proc, see ncells_pack()
 
   inline double cell_center(int i, int j)
-  { return center_[i][j]; }
+  { return center_[pack_index(i)][j]; }
 
   inline double cell_v_av(int i, int j)
-  { return v_av_[i][j]; }
+  { return v_av_[pack_index(i)][j]; }
 
   inline double cell_vol_fr(int i)
-  { return vol_fr_[i]; }
+  { return vol_fr_[pack_index(i)]; }
 
   inline double cell_radius(int i)
-  { return radius_[i]; }
+  { return radius_[pack_index(i)]; }
 
   inline double cell_pressure(int i)
-  { return stress_[i][0]; }
+  { return stress_[pack_index(i)][0]; }
 
   inline double cell_stress(int i,int j)
-  { return stress_[i][j+1]; }
+  { return stress_[pack_index(i)][j+1]; }
 
  private:
 
   inline int ntry_per_cell()
   { return 50; }
 
+  inline int pack_index(int i)
+  { return distributed_ ? owned_[i] : i; }
+
   void setup_bins();
+  void setup_shared();
   void bin_atoms();
   void calculate_eu();
-  void allreduce();
+  void sum_shared(int);
+  void pack_shared(int, int, double *);
+  void unpack_shared(int, int, double *);
+  void gather_array();
+  double cell_array(int, int);
   inline int coord2bin(double *x); 
 
   bool parallel_;
 
+  // global grid, but each proc only stores the cells overlapping
+  // its subdomain, cells shared with other procs are summed up
+  bool distributed_;
+
   int exec_every_;
   bool box_change_size_, box_change_domain_;
   int triclinic_; 
@@ -120,6 +133,12 @@ class FixAveEuler : public Fix {
   // number of cells, either globally or locally on each proc
   int ncells_, ncells_dim_[3];
 
+  // number of cells of the whole grid, differs from above if distributed
+  int ncells_global_, ncells_dim_global_[3];
+
+  // global index of first local cell in each dim, 0 unless distributed
+  int ilo_[3];
+
   // extent of grid in xyz, either globally or locally on each proc
   double lo_[3],hi_[3];
   double lo_lamda_[3],hi_lamda_[3]; 
@@ -141,6 +160,27 @@ class FixAveEuler : public Fix {
   int *cellhead_;    // ptr to 1st atom in each cell
   int *cellptr_;       // ptr to next atom in each bin
 
+  // distributed: procs whose cell range overlaps mine, ascending rank
+  int nswap_;
+  int *swapproc_;
+  int *swapfirst_;       // first entry of each proc in swapcell_
+  int *swapcell_;        // local index of each cell shared with that proc
+
+  // distributed: distinct shared cells
+  int nslot_;
+  int *cellslot_;        // slot of each local cell, -1 if not shared
+  int *slotcell_;        // local index of each slot
+
+  double *sendbuf_, *recvbuf_, *slotbuf_;
+
+  // distributed: local cells whose center is in my subdomain
+  int nowned_;
+  int *owned_;
+
+  // distributed: global array, only gathered when accessed
+  double **array_global_;
+  bool gathered_;
+
   // region
   char *idregion_;
   class Region *region_;
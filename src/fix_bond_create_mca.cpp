@@ -109,6 +109,9 @@ FixBondCreateMCA::FixBondCreateMCA(LAMMPS *lmp, int narg, char **arg) :
   init_state = BONDED;
   fraction = 1.0;
   int seed = 12345;
+  active_flag = 0;
+  ndefer = 0;
+  pending_flag = 0;
 
   int iarg = 9;
   while (iarg < narg) {
@@ -142,6 +145,17 @@ FixBondCreateMCA::FixBondCreateMCA(LAMMPS *lmp, int narg, char **arg) :
         error->all(FLERR,"Illegal fix bond/create/mca command");
       if (seed <= 0) error->all(FLERR,"Illegal fix bond/create/mca command");
       iarg += 3;
+    } else if (strcmp(arg[iarg],"active") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal fix bond/create/mca command");
+      if (strcmp(arg[iarg+1],"yes") == 0) active_flag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) active_flag = 0;
+      else error->all(FLERR,"Illegal fix bond/create/mca command");
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"defer") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal fix bond/create/mca command");
+      ndefer = atoi(arg[iarg+1]);
+      if (ndefer < 0) error->all(FLERR,"Illegal fix bond/create/mca command");
+      iarg += 2;
     } else error->all(FLERR,"Illegal fix bond/create/mca command");
   }
 
@@ -177,6 +191,7 @@ FixBondCreateMCA::FixBondCreateMCA(LAMMPS *lmp, int narg, char **arg) :
   npartner = NULL;
   partner = NULL;
   probability = NULL;
+  active = NULL;
   // distsq = NULL;
 
   // zero out stats
@@ -201,6 +216,7 @@ FixBondCreateMCA::~FixBondCreateMCA()
   memory->sfree(npartner);
   memory->destroy(partner);
   memory->sfree(probability);
+  memory->sfree(active);
 
   //NP do _not_  delete this fix here - should stay active
   //NP modify->delete_fix("exchange_bonds_mca");
@@ -242,6 +258,7 @@ int FixBondCreateMCA::setmask()
 //  mask |= PRE_FORCE; - moved it to BondMCA::build_bond_index() caled from Neighbor::bond_all()
   mask |= POST_INTEGRATE;
   mask |= POST_INTEGRATE_RESPA;
+  if (ndefer) mask |= PRE_EXCHANGE; // deferred bonds are created when reneighboring
   return mask;
 }
 
@@ -361,6 +378,53 @@ if (logfile) fprintf(logfile, "FixBondCreateMCA::pre_force \n");///AS DEBUG
 /* ---------------------------------------------------------------------- */
 
 void FixBondCreateMCA::post_integrate()
+{
+  if (nevery == 0 || update->ntimestep % nevery ) {
+    return;
+  }
+//  if (logfile) fprintf(logfile, "FixBondCreateMCA::post_integrate iatomtype=%d jatomtype=%d btype=%d cutsq=%g\n",iatomtype, jatomtype, btype, cutsq);///AS DEBUG
+
+  // the initial bonds of the packing are never deferred
+
+  if (ndefer == 0 || createcounttotal == 0) {
+    create_bonds();
+    return;
+  }
+
+  // deferred creation: only look for new pairs here and schedule a reneighboring
+  // ndefer steps later, the bonds are created by pre_exchange() of the scheduled
+  // reneighboring or of a regular one which comes earlier
+
+  if (next_reneighbor >= update->ntimestep) return;
+
+  int npair = find_partners();
+  int npairall;
+  MPI_Allreduce(&npair,&npairall,1,MPI_INT,MPI_SUM,world);
+  if (npairall) {
+    pending_flag = 1;
+    next_reneighbor = update->ntimestep + ndefer;
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixBondCreateMCA::pre_exchange()
+{
+  // reneighborings without new pairs found since the last one skip the search
+
+  if (ndefer == 0 || nevery == 0 || !pending_flag) return;
+
+  create_bonds();
+  pending_flag = 0;
+  next_reneighbor = -1;
+}
+
+/* ----------------------------------------------------------------------
+   each atom collects the IDs of its eligible bond partners,
+   returns the number of pairs found from my atoms
+------------------------------------------------------------------------- */
+
+int FixBondCreateMCA::find_partners()
 {
   int i,j,k,ii,jj,inum,jnum,itype,jtype,possible;
   double xtmp,ytmp,ztmp,delx,dely,delz;
@@ -368,20 +432,10 @@ void FixBondCreateMCA::post_integrate()
   int flag;
   double *cont_distance = atom->cont_distance;
 
-  if (nevery == 0 || update->ntimestep % nevery ) {
-    return;
-  }
-//  if (logfile) fprintf(logfile, "FixBondCreateMCA::post_integrate iatomtype=%d jatomtype=%d btype=%d cutsq=%g\n",iatomtype, jatomtype, btype, cutsq);///AS DEBUG
-
   // need updated ghost atom positions
 
   comm->forward_comm();
 
-  // forward comm of bondcount, so ghosts have it
-
-  commflag = 0;
-  comm->forward_comm_fix(this);
-
   // resize bond partner list and initialize it
   // probability array overlays distsq array
   // needs to be atom->nmax in length
@@ -391,11 +445,35 @@ void FixBondCreateMCA::post_integrate()
     memory->grow(partner,nmax,maxbondsperatom,"bond/create/mca:partner");
     npartner = (int*) memory->srealloc(npartner,nmax*sizeof(int),"bond/create/mca:npartner");
     probability = (double *)memory->srealloc(probability,nmax*sizeof(double),"bond/create/mca:probability");
+    if (active_flag) active = (int*) memory->srealloc(active,nmax*sizeof(int),"bond/create/mca:active");
   }
 
   int nlocal = atom->nlocal;
   int nall = atom->nlocal + atom->nghost;
 
+  // active atoms lie on a free surface or at a crack: they miss bonds of their
+  // packing or have a bond which is not intact, atoms of the intact bulk can not
+  // get new bonds and are skipped by the search below
+
+  if (active_flag) {
+    int *num_bond = atom->num_bond;
+    double ***bond_hist = atom->bond_hist;
+    const int coord_num = atom->coord_num;
+#if defined (_OPENMP)
+#pragma omp parallel for private(i,k) default(shared) schedule(static)
+#endif
+    for (i = 0; i < nlocal; i++) {
+      active[i] = num_bond[i] < coord_num;
+      for (k = 0; k < num_bond[i] && !active[i]; k++)
+        if (int(bond_hist[i][k][STATE]) != BONDED) active[i] = 1;
+    }
+  }
+
+  // forward comm of bondcount and active flags, so ghosts have it
+
+  commflag = 0;
+  comm->forward_comm_fix(this);
+
 #if defined (_OPENMP)
 #pragma omp parallel for private(i,j) default(shared) schedule(static)
 #endif
@@ -419,6 +497,7 @@ void FixBondCreateMCA::post_integrate()
   firstneigh = list->firstneigh;
 
   flag = 0;
+  int npair = 0;
 
 //if (logfile) fprintf(logfile,"FixBondCreateMCA::post_integrate: nall (%d) = atom->nlocal (%d) + atom->nghost (%d) inum=%d\n",nall,atom->nlocal,atom->nghost,inum);
 ///#if defined (_OPENMP)
@@ -427,6 +506,7 @@ void FixBondCreateMCA::post_integrate()
   for (ii = 0; ii < inum; ii++) {
     i = ilist[ii];
     if (!(mask[i] & groupbit)) continue;
+    if (active_flag && !active[i]) continue;
     itype = type[i];
     xtmp = x[i][0];
     ytmp = x[i][1];
@@ -443,6 +523,7 @@ void FixBondCreateMCA::post_integrate()
       j &= NEIGHMASK;
 //if(tag[i]==10) if (logfile) fprintf(logfile,"%d tag= %d\n",j,tag[j]);
       if (!(mask[j] & groupbit)) continue;
+      if (active_flag && !active[j]) continue;
       jtype = type[j];
 
       possible = 0;
@@ -496,12 +577,33 @@ void FixBondCreateMCA::post_integrate()
       npartner[i]++;
 //#pragma omp atomic
       npartner[j]++;
+      npair++;
 
     }
   }
 
   if(flag) error->warning(FLERR,"FixBondCreateMCA::post_integrate\tCould not generate all possible bonds");
 
+  return npair;
+}
+
+/* ----------------------------------------------------------------------
+   create the bonds between mutual partners,
+   reneighboring is triggered if any bonds were formed
+------------------------------------------------------------------------- */
+
+void FixBondCreateMCA::create_bonds()
+{
+  int i,j,k;
+  double xtmp,ytmp,ztmp,delx,dely,delz;
+
+  find_partners();
+
+  int nlocal = atom->nlocal;
+  double **x = atom->x;
+  int *tag = atom->tag;
+  int *type = atom->type;
+
   // reverse comm of distsq and partner
   // not needed if newton_pair off since I,J pair was seen by both procs
 
@@ -536,6 +638,7 @@ void FixBondCreateMCA::post_integrate()
   int newton_bond = force->newton_bond;
   int n_bondhist = atom->n_bondhist;
   double ***bond_hist = atom->bond_hist;
+  const int * const hs = BOND_HIST_SLOT[atom->bond_hist_gen]; // double buffered slots
   double r,rinv;
 
   int ncreate = 0;
@@ -614,7 +717,7 @@ void FixBondCreateMCA::post_integrate()
           */
 
           //reset history
-          double *tmp = bond_hist[tag[i]-1][num_bond[i]];
+          double *tmp = bond_hist[i][num_bond[i]];
           for (int ih = 0; ih < n_bondhist; ih++) {
               tmp[ih] = 0.;
           }
@@ -625,13 +728,16 @@ void FixBondCreateMCA::post_integrate()
           r = sqrt(delx*delx + dely*dely + delz*delz);
 //if(tag[i]==10) if (logfile) fprintf(logfile,"FixBondCreateMCA::post_integrate: distance btw atoms i=%d and j=%d = %g  (%g %g %g)\n",i,j,r,x[j][0],x[j][1],x[j][2]);
           rinv = -1. / r; // "-" means that unit vector is from i1 to i2
-          tmp[R] = tmp[R_PREV] = r;
-          tmp[NX_PREV] = tmp[NX] = delx * rinv;
-          tmp[NY_PREV] = tmp[NY] = dely * rinv;
-          tmp[NZ_PREV] = tmp[NZ] = delz * rinv;
+          tmp[hs[R]] = tmp[hs[R_PREV]] = r;
+          tmp[hs[NX_PREV]] = tmp[hs[NX]] = delx * rinv;
+          tmp[hs[NY_PREV]] = tmp[hs[NY]] = dely * rinv;
+          tmp[hs[NZ_PREV]] = tmp[hs[NZ]] = delz * rinv;
 
           tmp[TAG] = double(tag[j]);
           tmp[STATE] = double(init_state);
+          atom->bond_mca[i][num_bond[i]] = j;
+          atom->bond_partner[i][num_bond[i]] = -1; // set below once both atoms store the bond
+          atom->bond_index[i][num_bond[i]] = -1; // not in bondlist until the next rebuild
           num_bond[i]++;
         }
         // increment bondcount, convert atom to new type if limit reached
@@ -649,9 +755,25 @@ void FixBondCreateMCA::post_integrate()
     }
   }
 
-  // need updated bonds AS
+  // link the halves of the new bonds if both atoms are here,
+  // bonds with ghost atoms get their partner slots when rebuilding bond index
 
-  comm->forward_comm();
+  int **bond_mca = atom->bond_mca;
+  int **bond_partner = atom->bond_partner;
+  for (i = 0; i < nlocal; i++)
+    for (k = 0; k < num_bond[i]; k++) {
+      if (bond_partner[i][k] >= 0) continue;
+      j = bond_mca[i][k];
+      if (j >= nlocal) continue;
+      for (int jk = 0; jk < num_bond[j]; jk++)
+        if (bond_atom[j][jk] == tag[i]) {
+          bond_partner[i][k] = jk;
+          bond_partner[j][jk] = k;
+          break;
+        }
+    }
+
+  // ghosts get the new bonds with the borders of the reneighboring triggered below
 
   // tally stats
 
@@ -694,9 +816,10 @@ int FixBondCreateMCA::pack_comm(int n, int *list, double *buf,
     for (i = 0; i < n; i++) {
       j = list[i];
       buf[m++] = ubuf(bondcount[j]).d; ///static_cast<int>(bondcount[j]);
+      if (active_flag) buf[m++] = ubuf(active[j]).d;
     }
 //if (stderr) fprintf(stderr,"FixBondCreateMCA::pack_comm m=%d n=%d [%d - %d]\n",m,n,list[0],list[n-1]);
-    return 1;
+    return active_flag ? 2 : 1;
   } else {
     for (i = 0; i < n; i++) {
       j = list[i];
@@ -720,8 +843,10 @@ void FixBondCreateMCA::unpack_comm(int n, int first, double *buf)
   last = first + n;
 
   if (commflag == 0) {
-    for (i = first; i < last; i++)
+    for (i = first; i < last; i++) {
       bondcount[i] = (int) ubuf(buf[m++]).i;///static_cast<int> (buf[m++]);
+      if (active_flag) active[i] = (int) ubuf(buf[m++]).i;
+    }
 
   } else {
     for (i = first; i < last; i++) {
@@ -853,5 +978,6 @@ double FixBondCreateMCA::memory_usage()
   double bytes = nmax*2 * sizeof(int);
   bytes += maxbondsperatom*nmax * sizeof(int);
   bytes += nmax * sizeof(double);
+  if (active_flag) bytes += nmax * sizeof(int);
   return bytes;
 }
@@ -65,6 +65,7 @@ class FixBondCreateMCA : public Fix {
 //  void pre_force(int);- moved it to BondMCA::build_bond_index() caled from Neighbor::bond_all()
   void post_integrate();
   void post_integrate_respa(int, int);
+  void pre_exchange();
   int modify_param(int,char**);
   //virtual
   int pack_comm(int, int *, double *, int, int *);
@@ -85,6 +86,8 @@ class FixBondCreateMCA : public Fix {
 
  private:
   bool already_bonded(int,int);
+  int find_partners();
+  void create_bonds();
 
   int me;
   int init_state;        // initial state of the bond, 1 - unbonded; 0 - bonded (default)
@@ -102,6 +105,10 @@ class FixBondCreateMCA : public Fix {
   int *npartner;         // # of preferred atoms for this atom to bond to
   int **partner;         // IDs of preferred atoms for this atom to bond to
   double *probability;   // random # to use in decision to form bond
+  int active_flag;       // 1 if only surface and crack atoms are searched for partners
+  int *active;           // 1 if atom is on a free surface or at a crack
+  int ndefer;            // max # of steps new bonds may wait for reneighboring, 0 = none
+  int pending_flag;      // 1 if new pairs were found which wait for pre_exchange()
 
   class RanMars *random;
   class NeighList *list;
@@ -72,12 +72,15 @@ FixBondExchangeMCA::FixBondExchangeMCA(LAMMPS *lmp, int narg, char **arg) :
 //    if (logfile) fprintf(logfile,"constructor FixBondExchangeMCA ###########\n");
     restart_global = 1;
     laststep=-1;
+    slot_new = NULL;
+    maxslot_new = 0;
 }
 
 /* ---------------------------------------------------------------------- */
 
 FixBondExchangeMCA::~FixBondExchangeMCA()
 {
+  memory->destroy(slot_new);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -92,7 +95,6 @@ int FixBondExchangeMCA::setmask()
 void FixBondExchangeMCA::pre_exchange()
 {
   int i1,i2,n;
-  bool found;
   int **bondlist = neighbor->bondlist;
   double **bondhistlist = neighbor->bondhistlist;
   int nbondlist = neighbor->nbondlist;
@@ -102,7 +104,6 @@ void FixBondExchangeMCA::pre_exchange()
   double ***bond_hist = atom->bond_hist;
   int n_bondhist = atom->n_bondhist;
   int nlocal = atom->nlocal;
-  int *tag = atom->tag;
 
   int newton_bond = force->newton_bond;
 
@@ -148,78 +149,94 @@ void FixBondExchangeMCA::pre_exchange()
   // task 2: remove broken bonds
   // should be done equally on all processors
 
-  // create list for all BOND-IDs, erase all the broken bonds compress bondlist with new value list
-  std::vector<unsigned int> list_bond_id;
-  std::vector<unsigned int>::iterator it1;
+  if (newton_bond)
+    error->all(FLERR,"FixBondExchangeMCA::pre_exchange does not support 'newton_bond on'");
 
-  for (n=0; n<nbondlist; n++) 
-      if(bondlist[n][3] == NOT_INTERACT) list_bond_id.push_back(n);// load all broken bond ids into the list
+  int nbroken = 0;
+  for (n = 0; n < nbondlist; n++)
+    if(bondlist[n][3] == NOT_INTERACT) nbroken++;
+  if (nbroken == 0) return;
 
-  //DEBUG
-  if (list_bond_id.size()>0) if (logfile) fprintf(logfile,"FixBondExchangeMCA::pre_exchange will delete %ld broken bonds at step %ld\n",list_bond_id.size(),update->ntimestep);
+  if (logfile) fprintf(logfile,"FixBondExchangeMCA::pre_exchange removes %d broken bonds at step " BIGINT_FORMAT "\n",
+                       nbroken,update->ntimestep);
 
-  for (it1=list_bond_id.begin(); it1!=list_bond_id.end(); ++it1)
-  {
-    n = *it1;
-    i1 = bondlist[n][0];
-    i2 = bondlist[n][1];
-
-    if(bondlist[n][3] < NOT_INTERACT) continue;
-
-    if (logfile) fprintf(logfile,"FixBondExchangeMCA::pre_exchange detected bond %d:%d(tag=%d)<->%d(tag=%d) as broken at step %ld\n",n,i1,atom->tag[i1],i2,atom->tag[i2],update->ntimestep);
-    // if the bond is broken, we remove it from both atom data
+  // the bond arrays of local atoms are compacted in place, keeping the order of the
+  // remaining bonds; ghost atoms are rebuilt by the following borders communication
+  if (atom->nmax > maxslot_new) {
+    maxslot_new = atom->nmax;
+    memory->destroy(slot_new);
+    memory->create(slot_new,maxslot_new,atom->bond_per_atom,"bond/exchange/mca:slot_new");
+  }
 
-    // delete bond from atom I if I stores it
-    // atom J will also do this
+  int i;
+  int ** const bond_index = atom->bond_index;
+  int ** const bond_mca = atom->bond_mca;
+  int ** const bond_partner = atom->bond_partner;
+  int ** const bond_type = atom->bond_type;
+
+  // 1st pass: new slot of every bond of local atoms, -1 for broken ones,
+  // bonds created since the last bondlist build have no index and are kept
+#if defined (_OPENMP)
+#pragma omp parallel for private(i) default(shared) schedule(static)
+#endif
+  for (i = 0; i < nlocal; i++) {
+    int m = 0;
+    for (int k = 0; k < num_bond[i]; k++) {
+      const int ib = bond_index[i][k];
+      slot_new[i][k] = (ib >= 0 && bondlist[ib][3] == NOT_INTERACT) ? -1 : m++;
+    }
+  }
 
-    if (newton_bond || i1 < nlocal) {
-        found = false;
-        for(int k = 0; k < num_bond[i1]; k++)
-           if(bond_atom[i1][k] == tag[i2]) {
-             found = true;
-             remove_bond(i1,k,n);
-             break;
-           }
-        if(!found) error->one(FLERR,"Failed to operate on MCA bond history during deletion1");
+  // 2nd pass: partner slots of the remaining bonds point to the new slots,
+  // ghost partners keep their slots, so only their back reference is updated
+#if defined (_OPENMP)
+#pragma omp parallel for private(i) default(shared) schedule(static)
+#endif
+  for (i = 0; i < nlocal; i++) {
+    for (int k = 0; k < num_bond[i]; k++) {
+      if (slot_new[i][k] < 0 || bond_partner[i][k] < 0) continue;
+      const int j = bond_mca[i][k];
+      if (j < nlocal) bond_partner[i][k] = slot_new[j][bond_partner[i][k]];
+      else bond_partner[j][bond_partner[i][k]] = slot_new[i][k];
     }
-    if (newton_bond || i2 < nlocal) {
-        found = false;
-        for(int k = 0; k < num_bond[i2]; k++)
-           if(bond_atom[i2][k] == tag[i1]) {
-             found = true;
-             remove_bond(i2,k,n);
-             int nbondlist = neighbor->nbondlist;
-             if(n<nbondlist) {
-               neighbor->nbondlist = (nbondlist-1);                               // delete one bond -> reduce nbondlist by one
-               for(int i = 0; i <= 3; i++)
-                  neighbor->bondlist[n][i] = neighbor->bondlist[nbondlist-1][i];  // also change in neighbor bondlist
-               break;
-             } else if(n == nbondlist) {
-               neighbor->nbondlist = (nbondlist-1);
-               break;
-             }
-             break;
-           }
-        if(!found) error->one(FLERR,"Failed to operate on MCA bond history during deletion2");
+  }
+
+  // 3rd pass: move the remaining bonds to their new slots
+#if defined (_OPENMP)
+#pragma omp parallel for private(i) default(shared) schedule(static)
+#endif
+  for (i = 0; i < nlocal; i++) {
+    int m = 0;
+    for (int k = 0; k < num_bond[i]; k++) {
+      if (slot_new[i][k] < 0) continue;
+      if (m != k) {
+        bond_atom[i][m] = bond_atom[i][k];
+        bond_type[i][m] = bond_type[i][k];
+        bond_index[i][m] = bond_index[i][k];
+        bond_mca[i][m] = bond_mca[i][k];
+        bond_partner[i][m] = bond_partner[i][k];
+        memcpy(bond_hist[i][m],bond_hist[i][k],n_bondhist*sizeof(double));
+      }
+      m++;
     }
+    num_bond[i] = m;
   }
-}
 
-inline void FixBondExchangeMCA::remove_bond(int ilocal, int ibond, int bondnumber)
-{
-    const int * const tag = atom->tag;
-    int *bond_atom = atom->bond_atom[ilocal];
-    int *bond_type = atom->bond_type[ilocal];
-    int *bond_mca = atom->bond_mca[ilocal];
-    double **bond_hist = atom->bond_hist[tag[ilocal] - 1];
-    if (logfile) fprintf(logfile,"FixBondExchangeMCA::remove_bond #%d : ilocal=%d ibond=%d global=%d\n",bondnumber,ilocal,ibond,atom->map(bond_atom[ibond]));
-    ///error->one(FLERR,"romoving bond");
-    int nbond = atom->num_bond[ilocal] - 1;
-    bond_atom[ibond] = bond_atom[nbond];
-    bond_mca[ibond] = bond_mca[nbond];
-    bond_type[ibond] = bond_type[nbond];
-    for(int k = 0; k < atom->n_bondhist; k++) bond_hist[ibond][k] = bond_hist[nbond][k];
-    atom->num_bond[ilocal]--;
+  // compress bondlist, the slot of the first atom and bond_index of both atoms follow
+  int nkeep = 0;
+  for (n = 0; n < nbondlist; n++) {
+    if(bondlist[n][3] == NOT_INTERACT) continue;
+    i1 = bondlist[n][0];
+    i2 = bondlist[n][1];
+    if (i1 < nlocal) bondlist[n][4] = slot_new[i1][bondlist[n][4]];
+    if(n != nkeep)
+      for(int l = 0; l < 5; l++) bondlist[nkeep][l] = bondlist[n][l];
+    const int k1 = bondlist[nkeep][4];
+    bond_index[i1][k1] = nkeep;
+    bond_index[i2][bond_partner[i1][k1]] = nkeep;
+    nkeep++;
+  }
+  neighbor->nbondlist = nkeep;
 }
 
 /* ----------------------------------------------------------------------
@@ -61,8 +61,9 @@ class FixBondExchangeMCA : public Fix {
   void restart(char *);
 
  private:
-  void remove_bond(int ilocal,int ibond, int bondnumber);
   bigint laststep;
+  int **slot_new;  // new slot of each bond of local atoms after removing broken ones
+  int maxslot_new;
 };
 
 }
@@ -87,7 +87,12 @@ FixContactHistory::FixContactHistory(LAMMPS *lmp, int narg, char **arg) :
   pgsize_(0),
   oneatom_(0),
   ipage_(0),
-  dpage_(0)
+  dpage_(0),
+  partner_hash_(0),
+  hash_size_(0),
+  hash_bits_(0),
+  maxhash_(0),
+  hash_atom_(-1)
 {
   restart_global = 1;
   restart_peratom = 1;
@@ -178,6 +183,7 @@ FixContactHistory::~FixContactHistory()
   memory->destroy(npartner_);
   memory->sfree(partner_);
   memory->sfree(contacthistory_);
+  memory->destroy(partner_hash_);
   if(ipage_) delete [] ipage_;
   if(dpage_) delete [] dpage_;
 
@@ -447,10 +453,41 @@ double FixContactHistory::memory_usage()
     bytes += ipage_[i].size();
     bytes += dpage_[i].size();
   }
+  bytes += maxhash_ * sizeof(int);
 
   return bytes;
 }
 
+/* ----------------------------------------------------------------------
+   hash the partner list of atom i for find_partner()
+   partners are inserted in list order, so a tag which is listed twice
+   resolves to the same index as with a linear scan
+------------------------------------------------------------------------- */
+
+void FixContactHistory::build_partner_hash(int i)
+{
+  const int np = npartner_[i];
+  const int *p = partner_[i];
+
+  hash_bits_ = 1;
+  while ((1 << hash_bits_) < 2*np) hash_bits_++;
+  hash_size_ = 1 << hash_bits_;
+  if (hash_size_ > maxhash_) {
+    maxhash_ = hash_size_;
+    memory->destroy(partner_hash_);
+    memory->create(partner_hash_,maxhash_,"contact_history:partner_hash");
+  }
+
+  std::fill_n(partner_hash_, hash_size_, -1);
+  const int hmask = hash_size_ - 1;
+  for (int m = 0; m < np; m++) {
+    int h = hash_tag(p[m]);
+    while (partner_hash_[h] >= 0) h = (h+1) & hmask;
+    partner_hash_[h] = m;
+  }
+  hash_atom_ = i;
+}
+
 /* ----------------------------------------------------------------------
    allocate local atom-based arrays
 ------------------------------------------------------------------------- */
@@ -106,6 +106,31 @@ class FixContactHistory : public Fix {
   inline double* contacthistory(int i,int j)
   { return &(contacthistory_[i][j*dnum_]); }
 
+  // index of the partner with ID tag in partner_[i], -1 if none
+  // atoms with many partners are looked up in a hash table of their partner
+  // list, which is built once per atom and neighbor list build
+  // reset_partner_lookup() must be called whenever partner_ changed
+  inline int find_partner(int i,int tag)
+  {
+    const int np = npartner_[i];
+    const int *p = partner_[i];
+
+    if (np < PARTNER_HASH_MIN) {
+      for (int m = 0; m < np; m++)
+        if (p[m] == tag) return m;
+      return -1;
+    }
+
+    if (hash_atom_ != i) build_partner_hash(i);
+    const int hmask = hash_size_ - 1;
+    for (int h = hash_tag(tag); partner_hash_[h] >= 0; h = (h+1) & hmask)
+      if (p[partner_hash_[h]] == tag) return partner_hash_[h];
+    return -1;
+  }
+
+  inline void reset_partner_lookup()
+  { hash_atom_ = -1; }
+
  protected:
 
   int iarg_;
@@ -130,6 +155,21 @@ class FixContactHistory : public Fix {
 
   virtual void allocate_pages();
 
+  // open-addressing table of the partner list of atom hash_atom_
+  // slots hold indices into partner_[hash_atom_], -1 if empty
+
+  static const int PARTNER_HASH_MIN = 8; // below, a linear scan is faster
+  int *partner_hash_;
+  int hash_size_;                // power of 2, at least twice npartner
+  int hash_bits_;
+  int maxhash_;                  // allocated length of partner_hash_
+  int hash_atom_;
+
+  void build_partner_hash(int i);
+
+  inline int hash_tag(int tag)
+  { return (int) (((unsigned int) tag * 2654435761u) >> (32 - hash_bits_)); }
+
 };
 
 }
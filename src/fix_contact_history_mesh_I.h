@@ -103,14 +103,20 @@
     int *tri = partner_[iP];
     const int nneighs = fix_nneighs_->get_vector_atom_int(iP);
 
-    for(int i = 0; i < nneighs; i++)
+    // npartner_ counts the occupied slots, stop once all were seen
+    int nleft = npartner_[iP];
+
+    for(int i = 0; i < nneighs && nleft > 0; i++)
     {
+        if(tri[i] < 0)
+            continue;
         if(tri[i] == idTri)
         {
             if(dnum_ > 0) history = &(contacthistory_[iP][i*dnum_]);
             keepflag_[iP][i] = true;
             return true;
         }
+        nleft--;
     }
     return false;
   }
@@ -120,12 +126,16 @@
   inline bool FixContactHistoryMesh::coplanarContactAlready(int iP, int idTri)
   {
     const int nneighs = fix_nneighs_->get_vector_atom_int(iP);
-    for(int i = 0; i < nneighs; i++)
+    int nleft = npartner_[iP];
+    for(int i = 0; i < nneighs && nleft > 0; i++)
     {
       
       int idPartnerTri = partner_[iP][i];
+      if(idPartnerTri < 0)
+        continue;
+      nleft--;
 
-      if(idPartnerTri >= 0 && idPartnerTri != idTri && mesh_->map(idPartnerTri) >= 0 && mesh_->areCoplanarNodeNeighs(idPartnerTri,idTri))
+      if(idPartnerTri != idTri && mesh_->map(idPartnerTri) >= 0 && mesh_->areCoplanarNodeNeighs(idPartnerTri,idTri))
       {
         
         // other coplanar contact handled already - do not handle this contact
@@ -143,11 +153,15 @@
   {
     int *tri = partner_[iP];
     const int nneighs = fix_nneighs_->get_vector_atom_int(iP);
+    int nleft = npartner_[iP];
 
-    for(int i = 0; i < nneighs; i++)
+    for(int i = 0; i < nneighs && nleft > 0; i++)
     {
-      
-      if(tri[i] >= 0 && tri[i] != idTri && mesh_->map(tri[i]) >= 0 && mesh_->areCoplanarNodeNeighs(tri[i],idTri))
+      if(tri[i] < 0)
+        continue;
+      nleft--;
+
+      if(tri[i] != idTri && mesh_->map(tri[i]) >= 0 && mesh_->areCoplanarNodeNeighs(tri[i],idTri))
       {
           
           // copy contact history
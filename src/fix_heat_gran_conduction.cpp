@@ -56,13 +56,6 @@
 using namespace LAMMPS_NS;
 using namespace FixConst;
 
-// modes for conduction contact area calaculation
-// same as in fix_wall_gran.cpp
-
-enum{ CONDUCTION_CONTACT_AREA_OVERLAP,
-      CONDUCTION_CONTACT_AREA_CONSTANT,
-      CONDUCTION_CONTACT_AREA_PROJECTION};
-
 /* ---------------------------------------------------------------------- */
 
 FixHeatGranCond::FixHeatGranCond(class LAMMPS *lmp, int narg, char **arg) :
@@ -72,7 +65,9 @@ FixHeatGranCond::FixHeatGranCond(class LAMMPS *lmp, int narg, char **arg) :
   area_calculation_mode_(CONDUCTION_CONTACT_AREA_OVERLAP),
   fixed_contact_area_(0.),
   area_correction_flag_(0),
-  deltan_ratio_(0)
+  deltan_ratio_(0),
+  fused_flag_(0),
+  fused_pass_(false)
 {
   iarg_ = 5;
 
@@ -108,6 +103,15 @@ FixHeatGranCond::FixHeatGranCond(class LAMMPS *lmp, int narg, char **arg) :
       else error->fix_error(FLERR,this,"expecting 'yes' or 'no' after 'area_correction'");
       iarg_ += 2;
       hasargs = true;
+    } else if(strcmp(arg[iarg_],"fused") == 0) {
+      if (iarg_+2 > narg) error->fix_error(FLERR,this,"not enough arguments for keyword 'fused'");
+      if(strcmp(arg[iarg_+1],"yes") == 0)
+        fused_flag_ = 1;
+      else if(strcmp(arg[iarg_+1],"no") == 0)
+        fused_flag_ = 0;
+      else error->fix_error(FLERR,this,"expecting 'yes' or 'no' after 'fused'");
+      iarg_ += 2;
+      hasargs = true;
     } else if(strcmp(style,"heat/gran/conduction") == 0)
         error->fix_error(FLERR,this,"unknown keyword");
   }
@@ -140,6 +144,12 @@ void FixHeatGranCond::pre_delete(bool unfixflag)
   // tell cpl that this fix is deleted
   if(cpl && unfixflag) cpl->reference_deleted();
 
+  // stop the pair style from calling back
+  // (on exit, the pair style is deleted before the fixes)
+  if(!unfixflag) return;
+  PairGran *pair = static_cast<PairGran*>(force->pair_match("gran", 0));
+  if(pair) pair->unregister_fix_heat_gran_cond(this);
+
 }
 
 /* ---------------------------------------------------------------------- */
@@ -147,6 +157,7 @@ void FixHeatGranCond::pre_delete(bool unfixflag)
 int FixHeatGranCond::setmask()
 {
   int mask = FixHeatGran::setmask();
+  if(fused_flag_) mask |= PRE_FORCE;
   mask |= POST_FORCE;
   return mask;
 }
@@ -211,14 +222,40 @@ void FixHeatGranCond::init()
 
   updatePtrs();
 
+  // the fluxes of touching particle pairs are evaluated by the pair style
+  // in its force pass, this fix then only does the communication
+  if(fused_flag_)
+  {
+    if (strcmp(force->pair_style,"hybrid")==0 || strcmp(force->pair_style,"hybrid/overlay")==0)
+      error->fix_error(FLERR,this,"'fused yes' does not work with pair style hybrid");
+    pair_gran->register_fix_heat_gran_cond(this);
+  }
+
   // error checks on coarsegraining
   
 }
 
 /* ---------------------------------------------------------------------- */
 
+void FixHeatGranCond::pre_force(int vflag)
+{
+  // the force pass of this time-step adds the fluxes, atom arrays
+  // may have been re-allocated since the last one
+  updatePtrs();
+  fused_pass_ = true;
+}
+
+/* ---------------------------------------------------------------------- */
+
 void FixHeatGranCond::post_force(int vflag)
 {
+  if(fused_flag_)
+  {
+    fused_pass_ = false;
+    if(force->newton_pair) fix_heatFlux->do_reverse_comm();
+    if(force->newton_pair) fix_directionalHeatFlux->do_reverse_comm();
+    return;
+  }
 
   if(history_flag == 0 && CONDUCTION_CONTACT_AREA_OVERLAP == area_calculation_mode_)
     post_force_eval<0,CONDUCTION_CONTACT_AREA_OVERLAP>(vflag,0);
@@ -263,10 +300,10 @@ void FixHeatGranCond::cpl_evaluate(ComputePairGranLocal *caller)
 template <int HISTFLAG,int CONTACTAREA>
 void FixHeatGranCond::post_force_eval(int vflag,int cpl_flag)
 {
-  double hc,contactArea,delta_n,flux,dirFlux[3];
+  double flux;
   int i,j,ii,jj,inum,jnum;
   double xtmp,ytmp,ztmp,delx,dely,delz;
-  double radi,radj,radsum,rsq,r,tcoi,tcoj;
+  double radi,radj,radsum,rsq,r;
   int *ilist,*jlist,*numneigh,**firstneigh;
   int *contact_flag,**first_contact_flag;
 
@@ -285,8 +322,6 @@ void FixHeatGranCond::post_force_eval(int vflag,int cpl_flag)
 
   double *radius = atom->radius;
   double **x = atom->x;
-  int *type = atom->type;
-  int nlocal = atom->nlocal;
   int *mask = atom->mask;
 
   updatePtrs();
@@ -333,53 +368,9 @@ void FixHeatGranCond::post_force_eval(int vflag,int cpl_flag)
 
         r = sqrt(rsq);
 
-        if(CONTACTAREA == CONDUCTION_CONTACT_AREA_OVERLAP)
-        {
-            
-            if(area_correction_flag_)
-            {
-              delta_n = radsum - r;
-              delta_n *= deltan_ratio_[type[i]-1][type[j]-1];
-              r = radsum - delta_n;
-            }
-
-            //contact area of the two spheres
-            contactArea = - M_PI/4 * ( (r-radi-radj)*(r+radi-radj)*(r-radi+radj)*(r+radi+radj) )/(r*r);
-        }
-        else if (CONTACTAREA == CONDUCTION_CONTACT_AREA_CONSTANT)
-            contactArea = fixed_contact_area_;
-        else if (CONTACTAREA == CONDUCTION_CONTACT_AREA_PROJECTION)
-        {
-            double rmax = MathExtraLiggghts::max(radi,radj);
-            contactArea = M_PI*rmax*rmax;
-        }
-
-        tcoi = conductivity_[type[i]-1];
-        tcoj = conductivity_[type[j]-1];
-        if (tcoi < SMALL || tcoj < SMALL) hc = 0.;
-        else hc = 4.*tcoi*tcoj/(tcoi+tcoj)*sqrt(contactArea);
-
-        flux = (Temp[j]-Temp[i])*hc;
+        flux = pair_flux<CONTACTAREA>(i,j,r,radi,radj);
 
-        dirFlux[0] = flux*delx;
-        dirFlux[1] = flux*dely;
-        dirFlux[2] = flux*delz;
-        if(!cpl_flag)
-        {
-          //Add half of the flux (located at the contact) to each particle in contact
-          heatFlux[i] += flux;
-          directionalHeatFlux[i][0] += 0.50 * dirFlux[0];
-          directionalHeatFlux[i][1] += 0.50 * dirFlux[1];
-          directionalHeatFlux[i][2] += 0.50 * dirFlux[2];
-          if (newton_pair || j < nlocal)
-          {
-            heatFlux[j] -= flux;
-            directionalHeatFlux[j][0] += 0.50 * dirFlux[0];
-            directionalHeatFlux[j][1] += 0.50 * dirFlux[1];
-            directionalHeatFlux[j][2] += 0.50 * dirFlux[2];
-          }
-
-        }
+        if(!cpl_flag) add_flux(i,j,flux,delx,dely,delz);
 
         if(cpl_flag && cpl) cpl->add_heat(i,j,flux);
       }
@@ -50,6 +50,10 @@ FixStyle(heat/gran,FixHeatGranCond)
 #define LMP_FIX_HEATGRAN_CONDUCTION_H
 
 #include "fix_heat_gran.h"
+#include "atom.h"
+#include "force.h"
+#include "math_extra_liggghts.h"
+#include <cmath>
 
 namespace LAMMPS_NS {
 
@@ -62,18 +66,105 @@ namespace LAMMPS_NS {
 
     int setmask();
     void init();
+    virtual void pre_force(int);
     virtual void post_force(int);
 
     void cpl_evaluate(class ComputePairGranLocal *);
     void register_compute_pair_local(ComputePairGranLocal *);
     void unregister_compute_pair_local(ComputePairGranLocal *);
 
+    // per-contact callback of the granular pair style for 'fused yes',
+    // called for every touching pair of the force pass of a time-step
+    inline bool fused_pass() const
+    { return fused_pass_; }
+
+    inline void add_pair(const int i, const int j, const double * const delta,
+                         const double r, const double radi, const double radj)
+    {
+      if (!(atom->mask[i] & groupbit) && !(atom->mask[j] & groupbit)) return;
+
+      double flux;
+      if (CONDUCTION_CONTACT_AREA_OVERLAP == area_calculation_mode_)
+        flux = pair_flux<CONDUCTION_CONTACT_AREA_OVERLAP>(i,j,r,radi,radj);
+      else if (CONDUCTION_CONTACT_AREA_CONSTANT == area_calculation_mode_)
+        flux = pair_flux<CONDUCTION_CONTACT_AREA_CONSTANT>(i,j,r,radi,radj);
+      else
+        flux = pair_flux<CONDUCTION_CONTACT_AREA_PROJECTION>(i,j,r,radi,radj);
+
+      add_flux(i,j,flux,delta[0],delta[1],delta[2]);
+    }
+
   protected:
     int iarg_;
 
   private:
+    // modes for conduction contact area calaculation
+    // same as in fix_wall_gran.cpp
+    enum{ CONDUCTION_CONTACT_AREA_OVERLAP,
+          CONDUCTION_CONTACT_AREA_CONSTANT,
+          CONDUCTION_CONTACT_AREA_PROJECTION};
+
     template <int,int> void post_force_eval(int,int);
 
+    // heat flux from j to i over their contact, r = distance of the centers
+    template <int CONTACTAREA>
+    inline double pair_flux(const int i, const int j, double r,
+                            const double radi, const double radj) const
+    {
+      const int *type = atom->type;
+      double contactArea,hc;
+
+      if(CONTACTAREA == CONDUCTION_CONTACT_AREA_OVERLAP)
+      {
+          if(area_correction_flag_)
+          {
+            const double radsum = radi + radj;
+            double delta_n = radsum - r;
+            delta_n *= deltan_ratio_[type[i]-1][type[j]-1];
+            r = radsum - delta_n;
+          }
+
+          //contact area of the two spheres
+          contactArea = - M_PI/4 * ( (r-radi-radj)*(r+radi-radj)*(r-radi+radj)*(r+radi+radj) )/(r*r);
+      }
+      else if (CONTACTAREA == CONDUCTION_CONTACT_AREA_CONSTANT)
+          contactArea = fixed_contact_area_;
+      else
+      {
+          const double rmax = MathExtraLiggghts::max(radi,radj);
+          contactArea = M_PI*rmax*rmax;
+      }
+
+      const double tcoi = conductivity_[type[i]-1];
+      const double tcoj = conductivity_[type[j]-1];
+      if (tcoi < SMALL || tcoj < SMALL) hc = 0.;
+      else hc = 4.*tcoi*tcoj/(tcoi+tcoj)*sqrt(contactArea);
+
+      return (Temp[j]-Temp[i])*hc;
+    }
+
+    // add half of the flux (located at the contact) to each particle in contact
+    inline void add_flux(const int i, const int j, const double flux,
+                         const double delx, const double dely, const double delz)
+    {
+      double dirFlux[3];
+      dirFlux[0] = flux*delx;
+      dirFlux[1] = flux*dely;
+      dirFlux[2] = flux*delz;
+
+      heatFlux[i] += flux;
+      directionalHeatFlux[i][0] += 0.50 * dirFlux[0];
+      directionalHeatFlux[i][1] += 0.50 * dirFlux[1];
+      directionalHeatFlux[i][2] += 0.50 * dirFlux[2];
+      if (force->newton_pair || j < atom->nlocal)
+      {
+        heatFlux[j] -= flux;
+        directionalHeatFlux[j][0] += 0.50 * dirFlux[0];
+        directionalHeatFlux[j][1] += 0.50 * dirFlux[1];
+        directionalHeatFlux[j][2] += 0.50 * dirFlux[2];
+      }
+    }
+
     class FixPropertyGlobal* fix_conductivity_;
     double *conductivity_;
 
@@ -85,6 +176,10 @@ namespace LAMMPS_NS {
     // for heat transfer area correction
     int area_correction_flag_;
     double const* const* deltan_ratio_;
+
+    // evaluate the fluxes in the force pass of the pair style
+    int fused_flag_;
+    bool fused_pass_;
   };
 
 }
@@ -59,6 +59,7 @@
 #include "sph_kernels.h"
 #include "fix_property_atom.h"
 #include "timer.h"
+#include "vector_liggghts.h"
 #include "fix_mca_meanstress.h"
 #include "atom_vec_mca.h"
 
@@ -106,23 +107,16 @@ void FixMCAMeanStress::init()
   if(!(force->bond_match("mca")))
      error->all(FLERR,"Fix mca/meanstress can only be used together with dedicated 'mca' bond styles");
 
-  comm_forward = 10 + MAX_BONDS*(2 + BOND_HIST_LEN);  // theta[j][3] + theta_prev[j][3] + mean_stress[j] +
-                                                      // mean_stress_prev[j] + equiv_stress_prev[j] + equiv_strain[j];
+  comm_forward = 7;  // theta[j][3] + theta_prev[j][3] + mean_stress[j]; the bond history of ghosts is
+                     // forwarded by PairMCA and becomes _PREV in swap_prev()
 }
 
 /* ---------------------------------------------------------------------- */
 
 inline void  FixMCAMeanStress::swap_prev()
 {
-  int i,k;
 //if (logfile) fprintf(logfile,"FixMCAMeanStress::swap_prev\n"); ///AS DEBUG TRACE
 
-  const int * const num_bond = atom->num_bond;
-  double ***bond_hist = atom->bond_hist;
-  const int * const tag = atom->tag;
-  const int nlocal = atom->nlocal;
-///  const int nmax = atom->nmax;
-
   {
     double *tmp;
     tmp = atom->mean_stress;
@@ -134,29 +128,11 @@ inline void  FixMCAMeanStress::swap_prev()
     atom->equiv_stress_prev = tmp;
   }
 
-#if defined (_OPENMP)
-#pragma omp parallel for private(i,k) shared (bond_hist) default(none) schedule(static)
-#endif
-  for (i = 0; i < nlocal; i++) {/// i < nmax; i++) {///
-    if (num_bond[i] == 0) continue;
-
-    for(k = 0; k < num_bond[i]; k++)
-    {
-      double *bond_hist_ik = bond_hist[tag[i]-1][k];
-///if(i == 13) if (logfile) fprintf(logfile,"PairMCA::swap_prev i=%d j=%d nv_pre= %20.12e %20.12e %20.12e nv= %20.12e %20.12e %20.12e \n",i,k,bond_hist_ik[NX_PREV],bond_hist_ik[NY_PREV],bond_hist_ik[NZ_PREV],bond_hist_ik[NX],bond_hist_ik[NY],bond_hist_ik[NZ]); ///AS DEBUG
-      bond_hist_ik[R_PREV] = bond_hist_ik[R];
-      bond_hist_ik[P_PREV] = bond_hist_ik[P];
-      bond_hist_ik[NX_PREV] = bond_hist_ik[NX];
-      bond_hist_ik[NY_PREV] = bond_hist_ik[NY];
-      bond_hist_ik[NZ_PREV] = bond_hist_ik[NZ];
-      bond_hist_ik[YX_PREV] = bond_hist_ik[YX];
-      bond_hist_ik[YY_PREV] = bond_hist_ik[YY];
-      bond_hist_ik[YZ_PREV] = bond_hist_ik[YZ];
-      bond_hist_ik[SHX_PREV] = bond_hist_ik[SHX];
-      bond_hist_ik[SHY_PREV] = bond_hist_ik[SHY];
-      bond_hist_ik[SHZ_PREV] = bond_hist_ik[SHZ];
-    }
-  }
+  // the current values of R, P, N*, Y* and SH* become the _PREV ones for all atoms
+  // (ghosts hold the values forwarded by PairMCA in the previous step), see BOND_HIST_SLOT.
+  // the new current slots hold outdated values, so every bond has to either
+  // overwrite them or carry the _PREV values over within the step
+  atom->bond_hist_gen ^= 1;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -170,13 +146,12 @@ inline void  FixMCAMeanStress::predict_mean_stress()
   double *mean_stress = atom->mean_stress;
   double *plastic_heat = atom->plastic_heat;
   const double mca_radius = atom->mca_radius;
-  const int * const tag = atom->tag;
   const int * const type = atom->type;
 
-  int **bond_atom = atom->bond_atom;
   const int * const num_bond = atom->num_bond;
   const int newton_bond = force->newton_bond;
   double ***bond_hist = atom->bond_hist;
+  const int * const hs = BOND_HIST_SLOT[atom->bond_hist_gen]; // double buffered slots
   const int nbondlist = neighbor->nbondlist;
   int ** const bondlist = neighbor->bondlist;
   int ** const bond_index = atom->bond_index;
@@ -189,12 +164,13 @@ inline void  FixMCAMeanStress::predict_mean_stress()
 //if (logfile) fprintf(logfile,"FixMCAMeanStress::predict_mean_stress\n"); ///AS DEBUG TRACE
   // first loop for computing distance (R) normal vector (NX,NY,NZ) and mean strain increment
 #if defined (_OPENMP)
-#pragma omp parallel for private(i,j,k,jk,itype) shared(x,v,mean_stress,bond_atom,bond_hist) default(shared) schedule(static)
+#pragma omp parallel for private(i,j,k,jk,itype) shared(x,v,mean_stress,bond_hist) default(shared) schedule(static)
 #endif
   for (i = 0; i < nlocal; i++) {/// i < nmax; i++) {///
     if (num_bond[i] == 0) continue;
 
     int ** const bond_mca = atom->bond_mca;
+    int ** const bond_partner = atom->bond_partner;
     double xtmp,ytmp,ztmp,vxtmp,vytmp,vztmp;
     double rHi;  // 2*G for atom i (j)
     double rK1, rKn;
@@ -228,15 +204,8 @@ inline void  FixMCAMeanStress::predict_mean_stress()
       }
       j = domain->closest_image(i,j);
 */
-      int found = 0;
-      int i_tag = tag[i];
+      jk = bond_partner[i][k];
       int Nj = num_bond[j];
-///if (logfile) fprintf(logfile,"FixMCAMeanStress::mean_stress_predict: i=%d j=%d num_bond[j]=%d\n",i,j,Nj);
-      for(jk = 0; jk < Nj; jk++) {
-///if (logfile) fprintf(logfile,"FixMCAMeanStress::mean_stress_predict: i=%d j=%d jk=%d num_bond[j]=%d\n",i,j,jk,Nj);
-        if(bond_atom[j][jk] == i_tag) {found = 1; break; }
-      }
-      if (!found) error->all(FLERR,"FixMCAMeanStress::mean_stress_predict 'jk' not found");
 
       if (Nj > Nc) Nj = Nc; // not increse "rigidity" if atom has more bonds
       double rM_J = (double)(Nj-1) / (double)(Nc-1);
@@ -252,12 +221,16 @@ inline void  FixMCAMeanStress::predict_mean_stress()
       r = sqrt(rsq);
       rinv = -1. / r; // "-" means that unit vector is from i1 to i2
 
-      double *bond_hist_ik = bond_hist[i_tag-1][k];
-      double r0 = bond_hist_ik[R_PREV];
-      double pi = bond_hist_ik[P_PREV];
-      double pj = bond_hist[tag[j]-1][jk][P_PREV];
+      double *bond_hist_ik = bond_hist[i][k];
+      double r0 = bond_hist_ik[hs[R_PREV]];
+      double pi = bond_hist_ik[hs[P_PREV]];
+      double pj = bond_hist[j][jk][hs[P_PREV]];
       int bond_state = bondlist[bond_index[i][k]][3];
-      if((bond_state == UNBONDED) && ((pi > 0.0)||(pj > 0.0))) continue; // 01.08.18 this is free surface
+      if((bond_state == UNBONDED) && ((pi > 0.0)||(pj > 0.0))) { // 01.08.18 this is free surface
+        bond_hist_ik[hs[R]] = r0; // R and N are not updated, carry them over to the current generation
+        vectorCopy3D(&(bond_hist_ik[hs[NX_PREV]]), &(bond_hist_ik[hs[NX]]));
+        continue;
+      }
       if (newton_bond) {
         //pj = bond_hist_ik[PJ_PREV]; it means we store bonds only for i < j, but allocate memory for both. why?
         error->all(FLERR,"FixMCAMeanStress::mean_stress_predict does not support 'newton_bond on'");
@@ -267,11 +240,11 @@ inline void  FixMCAMeanStress::predict_mean_stress()
       double d_e  = (pj - pi + rHj*d_e0) / (rHi + rHj);
       rDeltaEpsMean_I += d_e;
 
-      bond_hist_ik[R] = r;
+      bond_hist_ik[hs[R]] = r;
 //      bond_hist[j][jk][R] = r; //TODO do we need it for j?
-      bond_hist_ik[NX] = delx*rinv; ///TODO will do it later in PairMCA::compute_total_force because here we use implicit distance
-      bond_hist_ik[NY] = dely*rinv;
-      bond_hist_ik[NZ] = delz*rinv;
+      bond_hist_ik[hs[NX]] = delx*rinv; ///TODO will do it later in PairMCA::compute_total_force because here we use implicit distance
+      bond_hist_ik[hs[NY]] = dely*rinv;
+      bond_hist_ik[hs[NZ]] = delz*rinv;
     }
 #ifdef NO_MEANSTRESS
     mean_stress[i] = 0.0;
@@ -296,12 +269,13 @@ inline void  FixMCAMeanStress::predict_mean_stress()
 #ifndef NO_MEANSTRESS
    // Second loop for computing mean stress
 #if defined (_OPENMP)
-#pragma omp parallel for private(i,j,k,jk,itype) shared(x,v,mean_stress,plastic_heat,bond_atom,bond_hist) default(shared) schedule(static)
+#pragma omp parallel for private(i,j,k,jk,itype) shared(x,v,mean_stress,plastic_heat,bond_hist) default(shared) schedule(static)
 #endif
   for (i = 0; i < nlocal; i++) {/// i < nmax; i++) {///
     if (num_bond[i] == 0) continue;
 
     int ** const bond_mca = atom->bond_mca;
+    int ** const bond_partner = atom->bond_partner;
     double rKHi,rKHj;// 1-2*G/(3*K) for atom i (j)
     double rHi,rHj;  // 2*G for atom i (j)
     double pi,pj;
@@ -333,22 +307,19 @@ inline void  FixMCAMeanStress::predict_mean_stress()
         continue;
       }
 
-      double *bond_hist_ik = &(bond_hist[tag[i]-1][k][0]);
-      int found = 0;
-      for(jk = 0; jk < num_bond[j]; jk++)
-        if(bond_atom[j][jk] == tag[i]) {found = 1; break; }
-      if (!found) error->all(FLERR,"FixMCAMeanStress::mean_stress_predict 'jk' not found");
-      double *bond_hist_jk = &(bond_hist[tag[j]-1][jk][0]);
+      double *bond_hist_ik = &(bond_hist[i][k][0]);
+      jk = bond_partner[i][k];
+      double *bond_hist_jk = &(bond_hist[j][jk][0]);
 
       int jtype = type[j];
       rHj = 2. * mca_pair->G[jtype][jtype];
       rKHj = mca_pair->K[jtype][jtype]; rKHj = 1. - rHj / (3. * rKHj);
 
-      r = bond_hist_ik[R];
-      r0 = bond_hist_ik[R_PREV];
-      pi = bond_hist_ik[P_PREV];
+      r = bond_hist_ik[hs[R]];
+      r0 = bond_hist_ik[hs[R_PREV]];
+      pi = bond_hist_ik[hs[P_PREV]];
       if((bond_state == UNBONDED) && (pi > 0.0)) pi = 0.0; // 01.08.18 this is free surface
-      pj = bond_hist_jk[P_PREV];
+      pj = bond_hist_jk[hs[P_PREV]];
       if((bond_state == UNBONDED) && (pj > 0.0)) pj = 0.0; // 01.08.18 this is free surface
       if (newton_bond) {
         //pj = bond_hist_ik[PJ_PREV];
@@ -394,18 +365,10 @@ int FixMCAMeanStress::pack_comm(int n, int *list, double *buf,
                              int pbc_flag, int *pbc)
 {
   int i,j,m;
-  int k,l;
 
-  const int * const num_bond = atom->num_bond;
-  const int * const tag = atom->tag;
   double ** const theta = atom->theta;
   double ** const theta_prev = atom->theta_prev;
   const double * const mean_stress = atom->mean_stress;
-  const double * const mean_stress_prev = atom->mean_stress_prev;
-//  const double * const equiv_stress = atom->equiv_stress;
-  const double * const equiv_stress_prev = atom->equiv_stress_prev;
-  const double * const equiv_strain = atom->equiv_strain;
-  double *** const bond_hist = atom->bond_hist;
 
   m = 0;
   for (i = 0; i < n; i++) {
@@ -417,20 +380,8 @@ int FixMCAMeanStress::pack_comm(int n, int *list, double *buf,
     buf[m++] = theta_prev[j][1];
     buf[m++] = theta_prev[j][2];
     buf[m++] = mean_stress[j];
-    buf[m++] = mean_stress_prev[j];
-//    buf[m++] = equiv_stress[j];
-    buf[m++] = equiv_stress_prev[j];
-    buf[m++] = equiv_strain[j];
-
-    if(atom->n_bondhist) {
-      int tag_j = tag[j] - 1;
-      for (k = 0; k < num_bond[j]; k++)
-        for (l = 0; l < MX; l++)
-          buf[m++] = bond_hist[tag_j][k][l];
-    }
   }
-//if (logfile) fprintf(logfile,"FixMCAMeanStress::pack_comm m=%d n=%d [%d - %d]\n",m,n,list[0],list[n-1]);
-  return comm_forward; //m; for last versions of lammps !!!
+  return comm_forward;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -438,23 +389,14 @@ int FixMCAMeanStress::pack_comm(int n, int *list, double *buf,
 void FixMCAMeanStress::unpack_comm(int n, int first, double *buf)
 {
   int i,m,last;
-  int k,l;
 
-  const int *num_bond = atom->num_bond;
-  const int * const tag = atom->tag;
   double **theta = atom->theta;
   double **theta_prev = atom->theta_prev;
   double *mean_stress = atom->mean_stress;
-  double *mean_stress_prev = atom->mean_stress_prev;
-//  double *equiv_stress = atom->equiv_stress;
-  double *equiv_stress_prev = atom->equiv_stress_prev;
-  double *equiv_strain = atom->equiv_strain;
-  double ***bond_hist = atom->bond_hist;
 
   m = 0;
   last = first + n;
   for (i = first; i < last; i++) {
-    if (i == atom->nmax) error->all(FLERR,"FixMCAMeanStress::unpack_comm i==atom->nmax");
     theta[i][0] = buf[m++];
     theta[i][1] = buf[m++];
     theta[i][2] = buf[m++];
@@ -462,19 +404,7 @@ void FixMCAMeanStress::unpack_comm(int n, int first, double *buf)
     theta_prev[i][1] = buf[m++];
     theta_prev[i][2] = buf[m++];
     mean_stress[i] = buf[m++];
-    mean_stress_prev[i] = buf[m++];
-//    equiv_stress[i] = buf[m++];
-    equiv_stress_prev[i] = buf[m++];
-    equiv_strain[i] = buf[m++];
-
-    if(atom->n_bondhist) {
-      int tag_i = tag[i] - 1;
-      for (k = 0; k < num_bond[i]; k++)
-        for (l = 0; l < MX; l++)
-          bond_hist[tag_i][k][l] = buf[m++];
-    }
   }
-//if (logfile) fprintf(logfile,"FixMCAMeanStress::unpack_comm m=%d n=%d [%d - %d]\n",m,n,first,last);
 }
 
 /* ----------------------------------------------------------------------
@@ -510,10 +440,9 @@ int FixMCAMeanStress::pack_exchange(int i, double *buf)
     buf[m++] = equiv_strain[i];
 
     if(atom->n_bondhist) {
-      int tag_i = tag[i] - 1;
       for (k = 0; k < num_bond[i]; k++)
         for (l = 0; l < MX; l++)
-          buf[m++] = bond_hist[tag_i][k][l];
+          buf[m++] = bond_hist[i][k][l];
     }
 
 if (logfile) fprintf(logfile,"FixMCAMeanStress::pack_exchange m=%d i=%d \n",m,i);
@@ -552,10 +481,9 @@ int FixMCAMeanStress::unpack_exchange(int nlocal, double *buf)
     equiv_strain[nlocal] = buf[m++];
 
     if(atom->n_bondhist) {
-      int tag_i = tag[nlocal] - 1;
       for (k = 0; k < num_bond[nlocal]; k++)
         for (l = 0; l < MX; l++)
-          bond_hist[tag_i][k][l] = buf[m++];
+          bond_hist[nlocal][k][l] = buf[m++];
     }
 
 if (logfile) fprintf(logfile,"FixMCAMeanStress::unpack_exchange m=%d nlocal=%d\n",m,nlocal);
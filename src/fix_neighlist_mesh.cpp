@@ -54,9 +54,14 @@
 #include "vector_liggghts.h"
 #include "update.h"
 #include <stdio.h>
+#include "comm.h"
 #include <algorithm>
 #include "atom_vec_ellipsoid.h"
 
+#if defined(_OPENMP)
+#include "omp.h"
+#endif
+
 using namespace LAMMPS_NS;
 using namespace FixConst;
 
@@ -69,6 +74,8 @@ FixNeighlistMesh::FixNeighlistMesh(LAMMPS *lmp, int narg, char **arg)
   buildNeighList(false),
   numAllContacts_(0),
   globalNumAllContacts_(false),
+  particleList_(false),
+  particleOffsets_(1,0),
   mbinx(0),
   mbiny(0),
   mbinz(0),
@@ -283,16 +290,28 @@ void FixNeighlistMesh::pre_force(int)
       generate_bin_list(nall);
     }
 
-    // manually trigger binning if no pairwise neigh lists exist
-    if(0 == neighbor->n_blist() && bins)
-        neighbor->bin_atoms();
-    else if(!bins)
-        error->one(FLERR,"wrong neighbor setting for fix neighlist/mesh");
+    if(changingMesh || changingDomain)
+    {
+      // the triangles move relative to the bins, query a tree over the
+      // triangles for each particle instead of sweeping bins per triangle
+      handleParticlesBVH(nall);
+    }
+    else
+    {
+      // manually trigger binning if no pairwise neigh lists exist
+      if(0 == neighbor->n_blist() && bins)
+          neighbor->bin_atoms();
+      else if(!bins)
+          error->one(FLERR,"wrong neighbor setting for fix neighlist/mesh");
 
-    for(size_t iTri = 0; iTri < nall; iTri++) {
-      TriangleNeighlist & triangle = triangles[iTri];
-      handleTriangle(iTri);
-      numAllContacts_ += triangle.contacts.size();
+      for(size_t iTri = 0; iTri < nall; iTri++) {
+        TriangleNeighlist & triangle = triangles[iTri];
+        handleTriangle(iTri);
+        numAllContacts_ += triangle.contacts.size();
+      }
+
+      if(particleList_)
+        buildParticleList(nall);
     }
 
     if(globalNumAllContacts_) {
@@ -300,6 +319,50 @@ void FixNeighlistMesh::pre_force(int)
     }
 }
 
+/* ----------------------------------------------------------------------
+   neighbor criterion for triangle iTri and owned particle iAtom
+------------------------------------------------------------------------- */
+
+inline bool FixNeighlistMesh::isNeighbor(int iTri, int iAtom)
+{
+    const double contactDistanceFactor = neighbor->contactDistanceFactor;
+
+    #ifdef TRI_LINE_ACTIVE_FLAG
+    if(atom->ellipsoid) //if non-spherical, check line interaction as well
+    {
+        double *lineOrientation; //keep empty, not needed
+        double *shape = avec->bonus[atom->ellipsoid[iAtom]].shape;
+        double length = 2.*MathExtraLiggghts::max(shape[0],shape[1],shape[2]);
+        double cylRadius = MathExtraLiggghts::min(shape[0],shape[1],shape[2]);
+        return mesh_->resolveTriSegmentNeighbuild(iTri, lineOrientation ,x[iAtom], length*contactDistanceFactor, cylRadius, skin );
+    }
+    #endif
+
+    return mesh_->resolveTriSphereNeighbuild(iTri,r ? r[iAtom]*contactDistanceFactor : 0. ,x[iAtom],r ? skin : (distmax+skin) );
+}
+
+/* ----------------------------------------------------------------------
+   max distance of particle iAtom to a triangle for which isNeighbor()
+   can be true
+------------------------------------------------------------------------- */
+
+inline double FixNeighlistMesh::neighborReach(int iAtom)
+{
+    const double contactDistanceFactor = neighbor->contactDistanceFactor;
+
+    #ifdef TRI_LINE_ACTIVE_FLAG
+    if(atom->ellipsoid)
+    {
+        double *shape = avec->bonus[atom->ellipsoid[iAtom]].shape;
+        double length = 2.*MathExtraLiggghts::max(shape[0],shape[1],shape[2]);
+        double cylRadius = MathExtraLiggghts::min(shape[0],shape[1],shape[2]);
+        return length*contactDistanceFactor + cylRadius + skin;
+    }
+    #endif
+
+    return r ? r[iAtom]*contactDistanceFactor + skin : distmax + skin;
+}
+
 /* ---------------------------------------------------------------------- */
 
 void FixNeighlistMesh::handleTriangle(int iTri)
@@ -308,19 +371,7 @@ void FixNeighlistMesh::handleTriangle(int iTri)
     std::vector<int> & neighbors = triangle.contacts;
     int & nchecked = triangle.nchecked;
     int *mask = atom->mask;
-    int ixMin(0),ixMax(0),iyMin(0),iyMax(0),izMin(0),izMax(0);
     int nlocal = atom->nlocal;
-    double contactDistanceFactor = neighbor->contactDistanceFactor;
-
-    int                     *ellipsoid  = atom->ellipsoid;
-    AtomVecEllipsoid::Bonus *bonus;
-    double *shape;
-    bool    haveNonSpherical = false;
-    if(ellipsoid)
-    {
-        haveNonSpherical = true;
-        bonus = avec->bonus;
-    }
 
     neighbors.clear();
     nchecked = 0;
@@ -328,59 +379,6 @@ void FixNeighlistMesh::handleTriangle(int iTri)
     // only do this if I own particles
     if(nlocal)
     {
-      if(changingMesh || changingDomain)
-      {
-        getBinBoundariesForTriangle(iTri,ixMin,ixMax,iyMin,iyMax,izMin,izMax);
-    
-        for(int ix=ixMin;ix<=ixMax;ix++) {
-          for(int iy=iyMin;iy<=iyMax;iy++) {
-            for(int iz=izMin;iz<=izMax;iz++) {
-              int iBin = iz*mbiny*mbinx + iy*mbinx + ix;
-              if(iBin < 0 || iBin >= maxhead) continue;
-
-              int iAtom = binhead[iBin];
-              
-              while(iAtom != -1 && iAtom < nlocal)
-              {
-                if(! (mask[iAtom] & groupbit_wall_mesh))
-                {
-                    if(bins) iAtom = bins[iAtom];
-                    else iAtom = -1;
-                    continue;
-                }
-                nchecked++;
-
-                if(0) {}
-                #ifdef TRI_LINE_ACTIVE_FLAG
-                else if(haveNonSpherical) //if non-spherical, check line interaction as well
-                {
-                    double *lineOrientation; //keep empty, not needed
-                    double length;
-                    double cylRadius;
-                    shape     = bonus[ellipsoid[iAtom]].shape;
-                    length    = 2.*MathExtraLiggghts::max(shape[0],shape[1],shape[2]);
-                    cylRadius =    MathExtraLiggghts::min(shape[0],shape[1],shape[2]);
-                    if( mesh_->resolveTriSegmentNeighbuild(iTri, lineOrientation ,x[iAtom], length*contactDistanceFactor, cylRadius, skin ) )
-                    {
-                      neighbors.push_back(iAtom);
-                      fix_nneighs_->set_vector_atom_int(iAtom, fix_nneighs_->get_vector_atom_int(iAtom)+1); // num_neigh++
-                    }
-                }
-                #endif
-                else if(mesh_->resolveTriSphereNeighbuild(iTri,r ? r[iAtom]*contactDistanceFactor : 0. ,x[iAtom],r ? skin : (distmax+skin) ))
-                {
-                  
-                  neighbors.push_back(iAtom);
-                  fix_nneighs_->set_vector_atom_int(iAtom, fix_nneighs_->get_vector_atom_int(iAtom)+1); // num_neigh++
-                  
-                }
-                if(bins) iAtom = bins[iAtom];
-                else iAtom = -1;
-              }
-            }
-          }
-        }
-      } else {
         const std::vector<int> & triangleBins = triangle.bins;
         const int bincount = triangleBins.size();
         for(int i = 0; i < bincount; i++) {
@@ -397,24 +395,7 @@ void FixNeighlistMesh::handleTriangle(int iTri)
             }
             nchecked++;
 
-            if(0) {}
-            #ifdef TRI_LINE_ACTIVE_FLAG
-            else if(haveNonSpherical) //if non-spherical, check line interaction as well
-            {
-                    double *lineOrientation; //keep empty, not needed
-                    double length;
-                    double cylRadius;
-                    shape     = bonus[ellipsoid[iAtom]].shape;
-                    length    = 2.*MathExtraLiggghts::max(shape[0],shape[1],shape[2]);
-                    cylRadius =    MathExtraLiggghts::min(shape[0],shape[1],shape[2]);
-                    if( mesh_->resolveTriSegmentNeighbuild(iTri, lineOrientation ,x[iAtom], length*contactDistanceFactor, cylRadius, skin ) )
-                    {
-                      neighbors.push_back(iAtom);
-                      fix_nneighs_->set_vector_atom_int(iAtom, fix_nneighs_->get_vector_atom_int(iAtom)+1); // num_neigh++
-                    }
-            }
-            #endif
-			else if(mesh_->resolveTriSphereNeighbuild(iTri,r ? r[iAtom]*contactDistanceFactor : 0. ,x[iAtom],r ? skin : (distmax+skin) ))
+            if(isNeighbor(iTri,iAtom))
             {
               
               neighbors.push_back(iAtom);
@@ -424,9 +405,131 @@ void FixNeighlistMesh::handleTriangle(int iTri)
             else iAtom = -1;
           }
         }
+    }
+
+}
+
+/* ----------------------------------------------------------------------
+   neighbor list build for moving meshes or changing domains
+   each owned particle queries the tree for triangles in reach, this
+   directly yields the particle list, the triangle lists are its transpose
+   particles are split into contiguous blocks per thread, so the result
+   does not depend on the number of threads
+------------------------------------------------------------------------- */
+
+void FixNeighlistMesh::handleParticlesBVH(size_t nall)
+{
+    const int nlocal = atom->nlocal;
+    int *mask = atom->mask;
+
+    if(bvh_.needsRebuild(mesh_))
+      bvh_.build(mesh_);
+    else
+      bvh_.refit(mesh_);
+
+    for(size_t iTri = 0; iTri < nall; iTri++) {
+      triangles[iTri].contacts.clear();
+      triangles[iTri].nchecked = 0;
+    }
+
+    particleOffsets_.assign(nlocal+1,0);
+
+#if defined (_OPENMP)
+    const int nthreads = comm->nthreads;
+#else
+    const int nthreads = 1;
+#endif
+    if(static_cast<int>(particleTriangles_thr_.size()) < nthreads)
+      particleTriangles_thr_.resize(nthreads);
+
+#if defined (_OPENMP)
+#pragma omp parallel num_threads(nthreads) default(shared)
+#endif
+    {
+#if defined (_OPENMP)
+      const int tid = omp_get_thread_num();
+#else
+      const int tid = 0;
+#endif
+      const int ifrom = static_cast<int>(static_cast<bigint>(nlocal)*tid/nthreads);
+      const int ito = static_cast<int>(static_cast<bigint>(nlocal)*(tid+1)/nthreads);
+      std::vector<int> & hits = particleTriangles_thr_[tid];
+      std::vector<int> candidates;
+      hits.clear();
+
+      for(int iAtom = ifrom; iAtom < ito; iAtom++)
+      {
+        if(! (mask[iAtom] & groupbit_wall_mesh))
+          continue;
+
+        candidates.clear();
+        bvh_.query(x[iAtom],neighborReach(iAtom),candidates);
+        std::sort(candidates.begin(),candidates.end());
+
+        const int ncandidates = candidates.size();
+        for(int k = 0; k < ncandidates; k++)
+        {
+          if(isNeighbor(candidates[k],iAtom))
+          {
+            hits.push_back(candidates[k]);
+            particleOffsets_[iAtom+1]++;
+          }
+        }
       }
     }
 
+    for(int i = 0; i < nlocal; i++)
+    {
+      fix_nneighs_->set_vector_atom_int(i, particleOffsets_[i+1]);
+      particleOffsets_[i+1] += particleOffsets_[i];
+    }
+    numAllContacts_ = particleOffsets_[nlocal];
+
+    particleTriangles_.resize(numAllContacts_);
+    int n = 0;
+    for(int t = 0; t < nthreads; t++)
+    {
+      std::copy(particleTriangles_thr_[t].begin(),particleTriangles_thr_[t].end(),particleTriangles_.begin()+n);
+      n += particleTriangles_thr_[t].size();
+    }
+
+    for(int i = 0; i < nlocal; i++)
+      for(int k = particleOffsets_[i]; k < particleOffsets_[i+1]; k++)
+        triangles[particleTriangles_[k]].contacts.push_back(i);
+}
+
+/* ----------------------------------------------------------------------
+   transpose the triangle lists into one list per owned particle
+   triangles are visited in ascending order, so each particle sees its
+   triangles in the same order as a loop over the triangle lists
+------------------------------------------------------------------------- */
+
+void FixNeighlistMesh::buildParticleList(size_t nall)
+{
+    const int nlocal = atom->nlocal;
+
+    particleOffsets_.assign(nlocal+1,0);
+    for(size_t iTri = 0; iTri < nall; iTri++) {
+      const std::vector<int> & neighbors = triangles[iTri].contacts;
+      const int numneigh = neighbors.size();
+      for(int iCont = 0; iCont < numneigh; iCont++)
+        if(neighbors[iCont] < nlocal)
+          particleOffsets_[neighbors[iCont]+1]++;
+    }
+
+    for(int i = 0; i < nlocal; i++)
+      particleOffsets_[i+1] += particleOffsets_[i];
+
+    particleTriangles_.resize(particleOffsets_[nlocal]);
+    particleFill_.assign(particleOffsets_.begin(),particleOffsets_.end()-1);
+
+    for(size_t iTri = 0; iTri < nall; iTri++) {
+      const std::vector<int> & neighbors = triangles[iTri].contacts;
+      const int numneigh = neighbors.size();
+      for(int iCont = 0; iCont < numneigh; iCont++)
+        if(neighbors[iCont] < nlocal)
+          particleTriangles_[particleFill_[neighbors[iCont]]++] = iTri;
+    }
 }
 
 /* ---------------------------------------------------------------------- */
@@ -448,27 +551,6 @@ void FixNeighlistMesh::getBinBoundariesFromBoundingBox(BoundingBox &b,
 
 /* ---------------------------------------------------------------------- */
 
-void FixNeighlistMesh::getBinBoundariesForTriangle(int iTri, int &ixMin,int &ixMax,int &iyMin,int &iyMax,int &izMin,int &izMax)
-{
-  // disable optimization for movingMesh or shrink-wrapped domain
-  if(changingMesh || changingDomain) {
-    BoundingBox b = mesh_->getElementBoundingBoxOnSubdomain(iTri);
-    // extend bbox by cutneighmax and get bin boundaries
-    getBinBoundariesFromBoundingBox(b,ixMin,ixMax,iyMin,iyMax,izMin,izMax);
-  } else {
-    // use cached boundary information
-    const BinBoundary & b = triangles[iTri].boundary;
-    ixMin = b.xlo;
-    ixMax = b.xhi;
-    iyMin = b.ylo;
-    iyMax = b.yhi;
-    izMin = b.zlo;
-    izMax = b.zhi;
-  }
-}
-
-/* ---------------------------------------------------------------------- */
-
 void FixNeighlistMesh::post_run()
 {
   last_bin_update = -1; // reset binning for possible next run
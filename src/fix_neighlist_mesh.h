@@ -53,6 +53,7 @@ FixStyle(neighlist/mesh,FixNeighlistMesh)
 
 #include "fix.h"
 #include "container.h"
+#include "tri_mesh_bvh.h"
 #include <vector>
 #include <algorithm>
 
@@ -102,6 +103,26 @@ class FixNeighlistMesh : public Fix
       return triangles[iTri].contacts;
     }
 
+    // particle-major (CSR) copy of the contact lists, built if enabled and
+    // always for moving meshes or changing domains
+    // candidate triangles of owned particle i are
+    // get_particle_triangles()[get_particle_offsets()[i] ... get_particle_offsets()[i+1]-1]
+    // in ascending order, as if the triangle lists were looped in order
+    void enableParticleList(bool enable)
+    {
+      particleList_ = enable;
+    }
+
+    const int * get_particle_offsets() const
+    { return &particleOffsets_[0]; }
+
+    const int * get_particle_triangles() const
+    { return particleTriangles_.empty() ? NULL : &particleTriangles_[0]; }
+
+    // number of owned particles the particle list was built for
+    int getSizeParticleList() const
+    { return static_cast<int>(particleOffsets_.size()) - 1; }
+
     virtual int getSizeNumContacts();
 
     void enableTotalNumContacts(bool enable)
@@ -126,8 +147,11 @@ class FixNeighlistMesh : public Fix
   protected:
 
     void handleTriangle(int iTri);
+    void handleParticlesBVH(size_t nall);
+    void buildParticleList(size_t nall);
+    inline bool isNeighbor(int iTri, int iAtom);
+    inline double neighborReach(int iAtom);
     void getBinBoundariesFromBoundingBox(class BoundingBox &b, int &ixMin,int &ixMax,int &iyMin,int &iyMax,int &izMin,int &izMax);
-    void getBinBoundariesForTriangle(int iTri, int &ixMin,int &ixMax,int &iyMin,int &iyMax,int &izMin,int &izMax);
 
     class FixMeshSurface *caller_;
     class TriMesh *mesh_;
@@ -142,6 +166,15 @@ class FixNeighlistMesh : public Fix
     int numAllContacts_;
     bool globalNumAllContacts_;
 
+    bool particleList_;
+    std::vector<int> particleOffsets_;
+    std::vector<int> particleTriangles_;
+    std::vector<int> particleFill_;
+    std::vector<std::vector<int> > particleTriangles_thr_;
+
+    // tree over the triangles for moving meshes and changing domains
+    TriMeshBVH bvh_;
+
     int mbinx,mbiny,mbinz,maxhead, *bins, *binhead;
     double skin;
 
@@ -120,7 +120,7 @@ void FixNVEMCA::initial_integrate(int vflag)
 //if (logfile) fprintf(logfile, "rmass[%d]= %20.12e mca_radius= %g\n",nlocal,rmass[nlocal-1],atom->mca_radius); ///AS DEBUG
   int i;
 #if defined (_OPENMP)
-#pragma omp parallel for private(i,dtfm,dtirotate) shared (nlocal,x,v,f,omega,torque,theta) default(none) schedule(static)
+#pragma omp parallel for private(i,dtfm,dtirotate) shared (nlocal,x,v,f,omega,torque,theta) default(shared) schedule(static)
 #endif
 ///  for (i = 0; i < nmax; i++) {
   for (i = 0; i < nlocal; i++) {
@@ -174,7 +174,7 @@ void FixNVEMCA::final_integrate()
 
   int i;
 #if defined (_OPENMP)
-#pragma omp parallel for private(i,dtfm,dtirotate) shared (nlocal,v,f,omega,torque) default(none) schedule(static)
+#pragma omp parallel for private(i,dtfm,dtirotate) shared (nlocal,v,f,omega,torque) default(shared) schedule(static)
 #endif
 ///  for (i = 0; i < nmax; i++) {
   for (i = 0; i < nlocal; i++)
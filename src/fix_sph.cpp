@@ -68,9 +68,11 @@ FixSph::FixSph(LAMMPS *lmp, int narg, char **arg) :
   Fix(lmp, narg, arg)
 {
   kernel_flag = 1;  // default: kernel is used
+  list_flag = 1;    // default: own neighbor list
   kernel_id = -1;   // default value
   kernel_cut = -1;
   kernel_style = NULL;
+  kernel_table_size = 0;
 
   fppaSl = NULL;
   fppaSlType = NULL;
@@ -104,9 +106,11 @@ void FixSph::init()
   int ntypes = atom->ntypes;
   // need a half neighbor list, built when ever re-neighboring occurs
 
-  int irequest = neighbor->request((void *) this);
-  neighbor->requests[irequest]->pair = 0;
-  neighbor->requests[irequest]->fix = 1;
+  if (list_flag) {
+    int irequest = neighbor->request((void *) this);
+    neighbor->requests[irequest]->pair = 0;
+    neighbor->requests[irequest]->fix = 1;
+  }
 
   if (strcmp(update->integrate_style,"respa") == 0)
     nlevels_respa = ((Respa *) update->integrate)->nlevels;
@@ -116,6 +120,12 @@ void FixSph::init()
   // set kernel_cut
   kernel_cut = SPH_KERNEL_NS::sph_kernel_cut(kernel_id);
 
+  // sample kernel if requested
+  if (kernel_flag && kernel_table_size > 0) {
+    if (!kernel_table.setup(kernel_id,kernel_table_size))
+      error->all(FLERR,"Sph kernel can not be tabulated, it does not scale with a power of 1/h");
+  } else kernel_table.clear();
+
   // get the fix_property containing the smoothing length
   if (mass_type) {
     if (fppaSlType == NULL) {
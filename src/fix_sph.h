@@ -41,6 +41,7 @@
 #define LMP_FIX_SPH
 
 #include "fix.h"
+#include "sph_kernels.h"
 
 namespace LAMMPS_NS {
 
@@ -59,6 +60,7 @@ class FixSph : public Fix {
   inline void set_kernel_id(int newid){kernel_id = newid;};
 
   int kernel_flag;        // 1 if Fix uses sph kernel, 0 if not
+  int list_flag;          // 1 if Fix requests its own neighbor list, 0 if not
 
  protected:
   inline double interpDist(double disti, double distj) {return 0.5*(disti+distj);};
@@ -72,6 +74,9 @@ class FixSph : public Fix {
   double kernel_cut;
   char *kernel_style;
 
+  int kernel_table_size;  // # of intervals of the tabulated kernel, 0 if analytic
+  SPH_KERNEL_NS::KernelTable kernel_table;
+
   class NeighList *list;
   int nlevels_respa;
 
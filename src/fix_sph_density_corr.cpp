@@ -105,6 +105,12 @@ FixSphDensityCorr::FixSphDensityCorr(LAMMPS *lmp, int narg, char **arg) :
 
           iarg += 2;
 
+    } else if (strcmp(arg[iarg],"kernel_table") == 0) {
+          if (iarg+2 > narg) error->fix_error(FLERR,this,"Illegal use of keyword 'kernel_table'. Not enough input arguments");
+          kernel_table_size = force->inumeric(FLERR,arg[iarg+1]);
+          if (kernel_table_size < 0) error->fix_error(FLERR,this,"'kernel_table' value must be >= 0");
+          iarg += 2;
+
     } else error->fix_error(FLERR,this,"Illegal fix sph/density/continuity command");
   }
 
@@ -191,17 +197,31 @@ void FixSphDensityCorr::init()
 
 /* ---------------------------------------------------------------------- */
 
+struct FixSphDensityCorr::Eval
+{
+  FixSphDensityCorr *fix;
+  Eval(FixSphDensityCorr *f) : fix(f) {}
+
+  template <class KERNEL> void operator()(const KERNEL &kernel) const
+  {
+    if (fix->mass_type) fix->pre_force_eval<1>(kernel);
+    else fix->pre_force_eval<0>(kernel);
+  }
+};
+
+/* ---------------------------------------------------------------------- */
+
 void FixSphDensityCorr::pre_force(int)
 {
   //template function for using per atom or per atomtype smoothing length
-  if (mass_type) pre_force_eval<1>();
-  else pre_force_eval<0>();
+  //and the kernel
+  SPH_KERNEL_NS::sph_kernel_dispatch(kernel_id,kernel_table,Eval(this));
 }
 
 /* ---------------------------------------------------------------------- */
 
-template <int MASSFLAG>
-void FixSphDensityCorr::pre_force_eval()
+template <int MASSFLAG,class KERNEL>
+void FixSphDensityCorr::pre_force_eval(const KERNEL kernel)
 {
   int i,j,ii,jj,inum,jnum,itype,jtype;
   double xtmp,ytmp,ztmp,delx,dely,delz,rsq,r,s=0.0,W;
@@ -249,7 +269,7 @@ void FixSphDensityCorr::pre_force_eval()
 
         // this gets a value for W at self, perform error check
 
-        W = SPH_KERNEL_NS::sph_kernel(kernel_id,0.,sli,sliInv);
+        W = kernel.W(0.,sli,sliInv);
         if (W < 0.)
         {
           fprintf(screen,"s = %f, W = %f\n",s,W);
@@ -314,7 +334,7 @@ void FixSphDensityCorr::pre_force_eval()
 
         // this gets a value for W at self, perform error check
 
-        W = SPH_KERNEL_NS::sph_kernel(kernel_id,s,slCom,slComInv);
+        W = kernel.W(s,slCom,slComInv);
         if (W < 0.)
         {
           fprintf(screen,"s = %f, W = %f\n",s,W);
@@ -346,7 +366,7 @@ void FixSphDensityCorr::pre_force_eval()
 
         // this gets a value for W at self, perform error check
 
-        W = SPH_KERNEL_NS::sph_kernel(kernel_id,0.,sli,sliInv);
+        W = kernel.W(0.,sli,sliInv);
         if (W < 0.)
         {
           fprintf(screen,"s = %f, W = %f\n",s,W);
@@ -416,7 +436,7 @@ void FixSphDensityCorr::pre_force_eval()
 
         // this gets a value for W at self, perform error check
 
-        W = SPH_KERNEL_NS::sph_kernel(kernel_id,s,slCom,slComInv);
+        W = kernel.W(s,slCom,slComInv);
         if (W < 0.)
         {
           fprintf(screen,"s = %f, W = %f\n",s,W);
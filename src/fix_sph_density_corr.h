@@ -64,7 +64,8 @@ class FixSphDensityCorr : public FixSph {
   virtual void pre_force(int vflag);
 
  private:
-  template <int> void pre_force_eval();
+  template <int MASSFLAG,class KERNEL> void pre_force_eval(const KERNEL);
+  struct Eval;
 
   class FixPropertyAtom* fix_quantity;
   char *quantity_name;
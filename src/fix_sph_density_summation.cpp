@@ -57,15 +57,33 @@
 #include "error.h"
 #include "sph_kernels.h"
 #include "fix_property_atom.h"
+#include "fix_sph_pressure.h"
+#include "pair_sph.h"
 #include "timer.h"
 
+#if defined(_OPENMP)
+#include "omp.h"
+#endif
+
 using namespace LAMMPS_NS;
 using namespace FixConst;
 
 /* ---------------------------------------------------------------------- */
 
 FixSPHDensitySum::FixSPHDensitySum(LAMMPS *lmp, int narg, char **arg) :
-  FixSph(lmp, narg, arg)
+  FixSph(lmp, narg, arg),
+  fused_flag(0),
+  fused_pass_(false),
+  eos_flag(false),
+  fix_pressure(NULL),
+  pair_sph(NULL),
+  maxcache(0),
+  maxoffset(0),
+  cache(NULL),
+  offset(NULL),
+  nthr(0),
+  maxthr(0),
+  rho_thr(NULL)
 {
   int iarg = 0;
 
@@ -94,15 +112,44 @@ FixSPHDensitySum::FixSPHDensitySum(LAMMPS *lmp, int narg, char **arg) :
 
           iarg += 2;
 
+    } else if (strcmp(arg[iarg],"kernel_table") == 0) {
+          if (iarg+2 > narg) error->fix_error(FLERR,this,"Illegal use of keyword 'kernel_table'. Not enough input arguments");
+          kernel_table_size = force->inumeric(FLERR,arg[iarg+1]);
+          if (kernel_table_size < 0) error->fix_error(FLERR,this,"'kernel_table' value must be >= 0");
+          iarg += 2;
+
+    } else if (strcmp(arg[iarg],"fused") == 0) {
+          if (iarg+2 > narg) error->fix_error(FLERR,this,"Illegal use of keyword 'fused'. Not enough input arguments");
+          if (strcmp(arg[iarg+1],"yes") == 0) fused_flag = 1;
+          else if (strcmp(arg[iarg+1],"no") == 0) fused_flag = 0;
+          else error->fix_error(FLERR,this,"expecting 'yes' or 'no' after 'fused'");
+          iarg += 2;
+
     } else error->fix_error(FLERR,this,"Wrong keyword.");
   }
+
+  // the density pass uses the neighbor list of the pair style
+  if (fused_flag) list_flag = 0;
 }
 
 /* ---------------------------------------------------------------------- */
 
 FixSPHDensitySum::~FixSPHDensitySum()
 {
+  memory->destroy(cache);
+  memory->destroy(offset);
+  memory->destroy(rho_thr);
+}
+
+/* ---------------------------------------------------------------------- */
 
+void FixSPHDensitySum::pre_delete(bool unfixflag)
+{
+  // stop the pair style from using the cache
+  // (on exit, the pair style is deleted before the fixes)
+  if(!unfixflag) return;
+  PairSph *pair = static_cast<PairSph*>(force->pair_match("sph",0));
+  if(pair) pair->unregister_fix_sph_density(this);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -110,8 +157,13 @@ FixSPHDensitySum::~FixSPHDensitySum()
 int FixSPHDensitySum::setmask()
 {
   int mask = 0;
-  mask |= POST_INTEGRATE;
-  mask |= POST_INTEGRATE_RESPA;
+  if (fused_flag) {
+    mask |= PRE_FORCE;
+    mask |= POST_FORCE;
+  } else {
+    mask |= POST_INTEGRATE;
+    mask |= POST_INTEGRATE_RESPA;
+  }
   return mask;
 }
 
@@ -141,21 +193,94 @@ void FixSPHDensitySum::init()
 
   if(me == -1 && pres >= 0) error->fix_error(FLERR,this,"Fix sph/pressure has to be defined after sph/density/summation \n");
   if(pres == -1) error->fix_error(FLERR,this,"Requires to define a fix sph/pressure also \n");
+
+  // with 'fused yes' the density is summed up in pre_force, after the
+  // neighbor list of the pair style is built, and the kernel values of
+  // this pass are kept for the force pass of the pair style
+
+  eos_flag = false;
+  if (fused_flag) {
+    if (strcmp(update->integrate_style,"respa") == 0)
+      error->fix_error(FLERR,this,"'fused yes' does not work with run_style respa");
+    if (force->newton_pair)
+      error->fix_error(FLERR,this,"'fused yes' requires newton_pair off");
+    if (strcmp(force->pair_style,"hybrid")==0 || strcmp(force->pair_style,"hybrid/overlay")==0)
+      error->fix_error(FLERR,this,"'fused yes' does not work with pair style hybrid");
+
+    pair_sph = static_cast<PairSph*>(force->pair_match("sph",0));
+    if (!pair_sph) error->fix_error(FLERR,this,"'fused yes' requires an sph pair style");
+    if (pair_sph->sph_kernel_id() != kernel_id || pair_sph->sph_kernel_table_size() != kernel_table_size)
+      error->fix_error(FLERR,this,"'fused yes' requires the same sph kernel and 'kernel_table' as the pair style");
+    pair_sph->register_fix_sph_density(this);
+
+    // the pressure is set in the same pass unless a density
+    // correction has to be applied before. the correction is done in
+    // pre_force as well, so it has to come after the summation
+
+    fix_pressure = static_cast<FixSPHPressure*>(modify->fix[pres]);
+    eos_flag = true;
+    bool after = false;
+    for(int i = 0; i < modify->nfix; i++) {
+      if(modify->fix[i] == this) after = true;
+      else if(strncmp("sph/density/corr",modify->fix[i]->style,16) == 0) {
+        if(!after) error->fix_error(FLERR,this,"'fused yes' requires fix sph/density/corr to be defined after sph/density/summation");
+        eos_flag = false;
+      }
+    }
+
+    comm_forward = eos_flag ? 2 : 1;
+  }
 }
 
 /* ---------------------------------------------------------------------- */
 
+struct FixSPHDensitySum::Eval
+{
+  FixSPHDensitySum *fix;
+  Eval(FixSPHDensitySum *f) : fix(f) {}
+
+  template <class KERNEL> void operator()(const KERNEL &kernel) const
+  {
+    if (fix->fused_flag) {
+      if (fix->mass_type) fix->pre_force_eval<1>(kernel);
+      else fix->pre_force_eval<0>(kernel);
+    } else {
+      if (fix->mass_type) fix->post_integrate_eval<1>(kernel);
+      else fix->post_integrate_eval<0>(kernel);
+    }
+  }
+};
+
+/* ---------------------------------------------------------------------- */
+
 void FixSPHDensitySum::post_integrate()
 {
   //template function for using per atom or per atomtype smoothing length
-  if (mass_type) post_integrate_eval<1>();
-  else post_integrate_eval<0>();
+  //and the kernel
+  SPH_KERNEL_NS::sph_kernel_dispatch(kernel_id,kernel_table,Eval(this));
 }
 
 /* ---------------------------------------------------------------------- */
 
-template <int MASSFLAG>
-void FixSPHDensitySum::post_integrate_eval()
+void FixSPHDensitySum::pre_force(int)
+{
+  SPH_KERNEL_NS::sph_kernel_dispatch(kernel_id,kernel_table,Eval(this));
+
+  // the force pass of this time-step may use the kernel values
+  fused_pass_ = true;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixSPHDensitySum::post_force(int)
+{
+  fused_pass_ = false;
+}
+
+/* ---------------------------------------------------------------------- */
+
+template <int MASSFLAG,class KERNEL>
+void FixSPHDensitySum::post_integrate_eval(const KERNEL kernel)
 {
   int i,j,ii,jj,inum,jnum,itype,jtype;
   double xtmp,ytmp,ztmp,delx,dely,delz,rsq,r,s=0.0,W;
@@ -190,7 +315,7 @@ void FixSPHDensitySum::post_integrate_eval()
 
     // this gets a value for W at self, perform error check
 
-    W = SPH_KERNEL_NS::sph_kernel(kernel_id,0.,sli,sliInv);
+    W = kernel.W(0.,sli,sliInv);
     if (W < 0.)
     {
       fprintf(screen,"s = %f, W = %f\n",s,W);
@@ -264,7 +389,7 @@ void FixSPHDensitySum::post_integrate_eval()
 
       // this gets a value for W at self, perform error check
 
-      W = SPH_KERNEL_NS::sph_kernel(kernel_id,s,slCom,slComInv);
+      W = kernel.W(s,slCom,slComInv);
       if (W < 0.)
       {
         fprintf(screen,"s = %f, W = %f\n",s,W);
@@ -287,3 +412,234 @@ void FixSPHDensitySum::post_integrate_eval()
   timer->stamp(TIME_COMM);
 
 }
+
+/* ----------------------------------------------------------------------
+   density summation of 'fused yes' over the neighbor list of the pair style
+   all pairs of the list get their kernel values cached, the density is
+   only summed up for pairs within the group
+------------------------------------------------------------------------- */
+
+template <int MASSFLAG,class KERNEL>
+void FixSPHDensitySum::pre_force_eval(const KERNEL kernel)
+{
+  double **x = atom->x;
+  int *mask = atom->mask;
+  double *rho = atom->rho;
+  double *p = atom->p;
+  int *type = atom->type;
+  double *mass = atom->mass;
+  double *rmass = atom->rmass;
+  const int nlocal = atom->nlocal;
+  const int nthreads = comm->nthreads;
+
+  updatePtrs(); // get sl
+
+  // ghost positions are up to date due to regular communication
+
+  NeighList *plist = pair_sph->list;
+  const int inum = plist->inum;
+  int * const ilist = plist->ilist;
+  int * const numneigh = plist->numneigh;
+  int ** const firstneigh = plist->firstneigh;
+
+  // first cached pair of each atom of the list
+
+  if (inum+1 > maxoffset) {
+    maxoffset = inum+1;
+    memory->destroy(offset);
+    memory->create(offset,maxoffset,"sph/density/summation:offset");
+  }
+  offset[0] = 0;
+  for (int ii = 0; ii < inum; ii++)
+    offset[ii+1] = offset[ii] + numneigh[ilist[ii]];
+  if (3*offset[inum] > maxcache) {
+    maxcache = 3*offset[inum];
+    memory->destroy(cache);
+    memory->create(cache,maxcache,"sph/density/summation:cache");
+  }
+
+  // all threads but the master sum up the density in their own arrays,
+  // newton_pair is off, so only the density of owned atoms is summed
+
+  if (nthreads > 1) grow_thr(nthreads);
+
+  int nillegal = 0; // kernel values W < 0, reported after the parallel region
+
+#if defined (_OPENMP)
+#pragma omp parallel num_threads(nthreads) default(shared) reduction(+:nillegal)
+#endif
+  {
+#if defined (_OPENMP)
+  const int tid = omp_get_thread_num();
+#else
+  const int tid = 0;
+#endif
+  double * const rho_t = tid ? rho_thr[tid-1] : rho;
+  if (tid) memset(rho_t,0,nlocal*sizeof(double));
+
+  // reset and add rho contribution of self
+
+#if defined (_OPENMP)
+#pragma omp for schedule(static)
+#endif
+  for (int i = 0; i < nlocal; i++) {
+    double sli,imass;
+    if (MASSFLAG) {
+      sli = sl[type[i]-1];
+      imass = mass[type[i]];
+    } else {
+      sli = sl[i];
+      imass = rmass[i];
+    }
+
+    const double W = kernel.W(0.,sli,1./sli);
+    nillegal += (W < 0.);
+    rho[i] = W * imass;
+  }
+
+#if defined (_OPENMP)
+#pragma omp for schedule(static)
+#endif
+  for (int ii = 0; ii < inum; ii++) {
+    const int i = ilist[ii];
+    const bool igroup = mask[i] & groupbit;
+    const int itype = type[i];
+    const double xtmp = x[i][0];
+    const double ytmp = x[i][1];
+    const double ztmp = x[i][2];
+    int * const jlist = firstneigh[i];
+    const int jnum = numneigh[i];
+    double * const c = &cache[3*offset[ii]];
+
+    double sli = 0.,imass;
+    if (MASSFLAG) {
+      imass = mass[itype];
+    } else {
+      imass = rmass[i];
+      sli = sl[i];
+    }
+
+    for (int jj = 0; jj < jnum; jj++) {
+      const int j = jlist[jj];
+      double jmass,slCom;
+
+      if (MASSFLAG) {
+        const int jtype = type[j];
+        jmass = mass[jtype];
+        slCom = slComType[itype][jtype];
+      } else {
+        jmass = rmass[j];
+        slCom = interpDist(sli,sl[j]);
+      }
+
+      const double cut = slCom*kernel_cut;
+      const double delx = xtmp - x[j][0];
+      const double dely = ytmp - x[j][1];
+      const double delz = ztmp - x[j][2];
+      const double rsq = delx*delx + dely*dely + delz*delz;
+
+      if (rsq >= cut*cut) {
+        c[3*jj] = c[3*jj+1] = c[3*jj+2] = 0.;
+        continue;
+      }
+
+      // calculate distance and normalized distance
+
+      const double r = sqrt(rsq);
+      const double slComInv = 1./slCom;
+      const double s = r*slComInv;
+
+      const double W = kernel.W(s,slCom,slComInv);
+      nillegal += (W < 0.);
+
+      c[3*jj] = W;
+      c[3*jj+1] = kernel.der(s,slCom,slComInv);
+      c[3*jj+2] = 1./r;
+
+      // add contribution of neighbor
+      // have a half neigh list, so do it for both if necessary
+
+      if (!igroup || !(mask[j] & groupbit)) continue;
+
+      rho_t[i] += W * jmass;
+      if (j < nlocal) rho_t[j] += W * imass;
+    }
+  }
+  } // end of omp parallel
+
+  if (nillegal) error->one(FLERR,"Illegal kernel used, W < 0");
+
+  // rho is now correct, sum up threads and evaluate the equation of state
+
+  if (nthreads > 1 || eos_flag) {
+    const int pbit = eos_flag ? fix_pressure->groupbit : 0;
+#if defined (_OPENMP)
+#pragma omp parallel for num_threads(nthreads) default(shared) schedule(static)
+#endif
+    for (int i = 0; i < nlocal; i++) {
+      for (int t = 0; t < nthreads-1; t++) rho[i] += rho_thr[t][i];
+      if (mask[i] & pbit) p[i] = fix_pressure->eos(rho[i]);
+    }
+  }
+
+  // send rho (and p) to ghosts
+  timer->stamp();
+  comm->forward_comm_fix(this);
+  timer->stamp(TIME_COMM);
+}
+
+/* ----------------------------------------------------------------------
+   per-thread density of pre_force_eval() for threads 1 ... nthreads-1
+------------------------------------------------------------------------- */
+
+void FixSPHDensitySum::grow_thr(int nthreads)
+{
+  if (nthreads-1 == nthr && atom->nmax <= maxthr) return;
+
+  memory->destroy(rho_thr);
+  nthr = nthreads-1;
+  maxthr = atom->nmax;
+  memory->create(rho_thr,nthr,maxthr,"sph/density/summation:rho_thr");
+}
+
+/* ---------------------------------------------------------------------- */
+
+int FixSPHDensitySum::pack_comm(int n, int *list, double *buf,
+                                int pbc_flag, int *pbc)
+{
+  double *rho = atom->rho;
+  double *p = atom->p;
+
+  int m = 0;
+  for (int i = 0; i < n; i++) {
+    int j = list[i];
+    buf[m++] = rho[j];
+    if (eos_flag) buf[m++] = p[j];
+  }
+  return comm_forward;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixSPHDensitySum::unpack_comm(int n, int first, double *buf)
+{
+  double *rho = atom->rho;
+  double *p = atom->p;
+
+  int m = 0;
+  int last = first + n;
+  for (int i = first; i < last; i++) {
+    rho[i] = buf[m++];
+    if (eos_flag) p[i] = buf[m++];
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+
+double FixSPHDensitySum::memory_usage()
+{
+  double bytes = maxcache * sizeof(double);
+  bytes += maxoffset * sizeof(int);
+  bytes += nthr * maxthr * sizeof(double);
+  return bytes;
+}
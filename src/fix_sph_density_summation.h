@@ -58,9 +58,46 @@ class FixSPHDensitySum : public FixSph {
   virtual int setmask();
   virtual void init();
   virtual void post_integrate();
+  virtual void pre_force(int);
+  virtual void post_force(int);
+  virtual void pre_delete(bool);
+  int pack_comm(int, int *, double *, int, int *);
+  void unpack_comm(int, int, double *);
+  double memory_usage();
+
+  // kernel values of 'fused yes' for all pairs of the neighbor list of the
+  // sph pair style, W, dW/ds and 1/r for jj of ilist[ii] are found at
+  // pair_cache() + 3*(pair_offset()[ii] + jj), all zero beyond the cutoff
+  inline bool fused_pass() const
+  { return fused_pass_; }
+  inline const double * pair_cache() const
+  { return cache; }
+  inline const int * pair_offset() const
+  { return offset; }
+
+  // 1 if the density pass also sets the pressure of fix sph/pressure
+  inline bool fused_eos() const
+  { return eos_flag; }
 
  private:
-  template <int> void post_integrate_eval();
+  template <int MASSFLAG,class KERNEL> void post_integrate_eval(const KERNEL);
+  template <int MASSFLAG,class KERNEL> void pre_force_eval(const KERNEL);
+  struct Eval;
+  void grow_thr(int);
+
+  int fused_flag;
+  bool fused_pass_;
+  bool eos_flag;
+  class FixSPHPressure *fix_pressure;
+  class PairSph *pair_sph;
+
+  int maxcache,maxoffset;
+  double *cache;
+  int *offset;
+
+  // per-thread density of threads 1 ... nthreads-1
+  int nthr,maxthr;
+  double **rho_thr;
 
 };
 
@@ -45,6 +45,7 @@
 #include "string.h"
 #include "stdlib.h"
 #include "fix_sph_pressure.h"
+#include "fix_sph_density_summation.h"
 #include "update.h"
 #include "respa.h"
 #include "atom.h"
@@ -65,7 +66,8 @@ using namespace FixConst;
 /* ---------------------------------------------------------------------- */
 
 FixSPHPressure::FixSPHPressure(LAMMPS *lmp, int narg, char **arg) :
-  FixSph(lmp, narg, arg)
+  FixSph(lmp, narg, arg),
+  fused_(false)
 {
     //Check args
     int iarg = 3;
@@ -160,12 +162,19 @@ void FixSPHPressure::init()
   }
 
   if(dens == -1) error->fix_error(FLERR,this,"Requires to define a fix sph/density also \n");
+
+  // sph/density/summation with 'fused yes' evaluates eos() right after the
+  // density summation, unless a density correction has to come in between
+  fused_ = strcmp("sph/density/summation",modify->fix[dens]->style) == 0 &&
+           static_cast<FixSPHDensitySum*>(modify->fix[dens])->fused_eos();
 }
 
 /* ---------------------------------------------------------------------- */
 
 void FixSPHPressure::pre_force(int vflag)
 {
+  if (fused_) return;
+
   int *mask = atom->mask;
   double *rho = atom->rho;
   double *p = atom->p;
@@ -175,38 +184,11 @@ void FixSPHPressure::pre_force(int vflag)
 
   // set pressure
 
-  if (pressureStyle == PRESSURESTYLE_TAIT)
-  {
-    for (int i = 0; i < nlocal; i++)
-    {
-
-      if (mask[i] & groupbit)
-      {
-
-      p[i] = B*(pow(rho[i]*rho0inv,gamma) - 1) + P0; // Tait's equation
-      // Added a background pressure P0 (see e.g., S. Adami, X.Y. Hu, N.A. Adams,
-      // J. Comput. Phys. 241 (2013) 292-307)
-    }
-    }
-  }
-  else if (pressureStyle == PRESSURESTYLE_RELATIV)
+  for (int i = 0; i < nlocal; i++)
   {
-    for (int i = 0; i < nlocal; i++)
+    if (mask[i] & groupbit)
     {
-      if (mask[i] & groupbit)
-      {
-        p[i] = B * (rho[i] - rho0) + P0;
-      }
-    }
-  }
-  else if (pressureStyle == PRESSURESTYLE_ABSOLUT)
-  {
-    for (int i = 0; i < nlocal; i++)
-    {
-      if (mask[i] & groupbit)
-      {
-        p[i] = B * B * rho[i];
-      }
+      p[i] = eos(rho[i]);
     }
   }
 }
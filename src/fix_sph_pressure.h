@@ -49,6 +49,7 @@ FixStyle(sph/pressure,FixSPHPressure)
 #ifndef LMP_FIX_SPH_PRESSURE_H
 #define LMP_FIX_SPH_PRESSURE_H
 
+#include "math.h"
 #include "fix_sph.h"
 
 namespace LAMMPS_NS {
@@ -68,9 +69,23 @@ class FixSPHPressure : public FixSph {
     else return rho0;
   };
 
+  // equation of state, also evaluated by fix sph/density/summation 'fused yes'
+  inline double eos(double rhoi) const
+  {
+    if (pressureStyle == PRESSURESTYLE_TAIT)
+      // Tait's equation with a background pressure P0 (see e.g., S. Adami,
+      // X.Y. Hu, N.A. Adams, J. Comput. Phys. 241 (2013) 292-307)
+      return B*(pow(rhoi*rho0inv,gamma) - 1) + P0;
+    else if (pressureStyle == PRESSURESTYLE_RELATIV)
+      return B * (rhoi - rho0) + P0;
+    else
+      return B * B * rhoi;
+  };
+
  private:
   int pressureStyle;
   double B,rho0,rho0inv,gamma,P0;
+  bool fused_; // pressure is set by the density pass
 };
 
 }
@@ -406,6 +406,7 @@ void FixWallGran::post_create()
    {
        
        FixMesh_list_[i]->createWallNeighList(igroup);
+       FixMesh_list_[i]->meshNeighlist()->enableParticleList(true);
        FixMesh_list_[i]->createContactHistory(dnum());
 
        if(store_force_contact_)
@@ -699,153 +700,58 @@ void FixWallGran::post_force_respa(int vflag, int ilevel, int iloop)
 
 void FixWallGran::post_force_mesh(int vflag)
 {
-    
-    // contact properties
-    double v_wall[3],bary[3];
-    double delta[3],deltan;
-    MultiVectorContainer<double,3,3> *vMeshC;
-    double ***vMesh;
     int nlocal = atom->nlocal;
-    int nTriAll;
 
-    SurfacesIntersectData sidata;
-    sidata.is_wall = true;
+#if defined (_OPENMP)
+    // compute wall/gran/local, stress and heat flux tracking, stored contact
+    // forces and the legacy compute_force() of derived classes sum into
+    // shared data, the contacts are then evaluated by the master thread only
+    const bool serial = !impl || (cwl_ && addflag_) || stress_flag_ ||
+                        heattransfer_flag_ || store_force_contact_;
+    const int nthreads = serial ? 1 : comm->nthreads;
+#endif
 
     for(int iMesh = 0; iMesh < n_FixMesh_; iMesh++)
     {
-      TriMesh *mesh = FixMesh_list_[iMesh]->triMesh();
-      nTriAll = mesh->sizeLocal() + mesh->sizeGhost();
-      FixContactHistoryMesh *fix_contact = FixMesh_list_[iMesh]->contactHistory();
+      FixMeshSurface *fix_mesh = FixMesh_list_[iMesh];
+      TriMesh *mesh = fix_mesh->triMesh();
+      FixContactHistoryMesh *fix_contact = fix_mesh->contactHistory();
 
       // mark all contacts for delettion at this point
       
       if(fix_contact) fix_contact->markAllContacts();
 
       if(store_force_contact_)
-        fix_wallforce_contact_ = FixMesh_list_[iMesh]->meshforceContact();
+        fix_wallforce_contact_ = fix_mesh->meshforceContact();
 
-      // get neighborList and numNeigh
-      FixNeighlistMesh * meshNeighlist = FixMesh_list_[iMesh]->meshNeighlist();
+      // get the particle-major neighbor list
+      FixNeighlistMesh * meshNeighlist = fix_mesh->meshNeighlist();
+      const int *offsets = meshNeighlist->get_particle_offsets();
+      const int *triangles = meshNeighlist->get_particle_triangles();
+      const int npart = MathExtraLiggghts::min(nlocal,meshNeighlist->getSizeParticleList());
 
-      vectorZeroize3D(v_wall);
-      vMeshC = mesh->prop().getElementProperty<MultiVectorContainer<double,3,3> >("v");
+      // moving mesh - calculate v_wall from the node velocities
+      MultiVectorContainer<double,3,3> *vMeshC = mesh->prop().getElementProperty<MultiVectorContainer<double,3,3> >("v");
+      double ***vMesh = vMeshC ? vMeshC->begin() : NULL;
 
-      atom_type_wall_ = FixMesh_list_[iMesh]->atomTypeWall();
+      atom_type_wall_ = fix_mesh->atomTypeWall();
 
-      // moving mesh
-      if(vMeshC)
+      // all contacts of a particle are handled by the same thread, so its
+      // force, torque and contact history are written without conflicts
+#if defined (_OPENMP)
+#pragma omp parallel num_threads(nthreads) default(shared)
+#endif
       {
-        vMesh = vMeshC->begin();
+        SurfacesIntersectData sidata;
+        sidata.is_wall = true;
 
-        // loop owned and ghost triangles
-        for(int iTri = 0; iTri < nTriAll; iTri++)
-        {
-          const std::vector<int> & neighborList = meshNeighlist->get_contact_list(iTri);
-          const int numneigh = neighborList.size();
-          for(int iCont = 0; iCont < numneigh; iCont++)
-          {
-            
-            const int iPart = neighborList[iCont];
-
-            // do not need to handle ghost particles
-            if(iPart >= nlocal) continue;
-
-            int idTri = mesh->id(iTri);
-
-            #ifdef SUPERQUADRIC_ACTIVE_FLAG
-                if(atom->superquadric_flag) {
-                  sidata.pos_i = x_[iPart];
-                  sidata.quat_i = quat_[iPart];
-                  sidata.shape_i = shape_[iPart];
-                  sidata.roundness_i = roundness_[iPart];
-                  Superquadric particle(sidata.pos_i, sidata.quat_i, sidata.shape_i, sidata.roundness_i);
-                  if(mesh->sphereTriangleIntersection(iTri, radius_[iPart], sidata.pos_i)) //check for Bounding Sphere-triangle intersection
-                    deltan = mesh->resolveTriSuperquadricContact(iTri, delta, sidata.contact_point, particle, bary);
-                  else
-                    deltan = LARGE_TRIMESH;
-                  sidata.is_non_spherical = true; //by default it is false
-                } else
-                  deltan = mesh->resolveTriSphereContactBary(iPart,iTri,radius_ ? radius_[iPart]:r0_ ,x_[iPart],delta,bary);
-            #else
-                deltan = mesh->resolveTriSphereContactBary(iPart,iTri,radius_ ? radius_[iPart]:r0_ ,x_[iPart],delta,bary);
-            #endif
-            
-            if(deltan > skinDistance_) //allow force calculation away from the wall
-            {
-              
-            }
-            else
-            {
-              
-              if(fix_contact && ! fix_contact->handleContact(iPart,idTri,sidata.contact_history)) continue;
-
-              for(int i = 0; i < 3; i++)
-                v_wall[i] = (bary[0]*vMesh[iTri][0][i] + bary[1]*vMesh[iTri][1][i] + bary[2]*vMesh[iTri][2][i]);
-
-              sidata.i = iPart;
-              sidata.deltan = -deltan;
-              sidata.delta[0] = -delta[0];
-              sidata.delta[1] = -delta[1];
-              sidata.delta[2] = -delta[2];
-              post_force_eval_contact(sidata, v_wall,iMesh,FixMesh_list_[iMesh],mesh,iTri);
-            }
-
-          }
-        }
-      }
-      // non-moving mesh - do not calculate v_wall, use standard distance function
-      else
-      {
-        // loop owned and ghost particles
-        for(int iTri = 0; iTri < nTriAll; iTri++)
+#if defined (_OPENMP)
+#pragma omp for schedule(dynamic,64)
+#endif
+        for(int iPart = 0; iPart < npart; iPart++)
         {
-          const std::vector<int> & neighborList = meshNeighlist->get_contact_list(iTri);
-          const int numneigh = neighborList.size();
-          
-          for(int iCont = 0; iCont < numneigh; iCont++)
-          {
-            const int iPart = neighborList[iCont];
-
-            // do not need to handle ghost particles
-            if(iPart >= nlocal) continue;
-
-            int idTri = mesh->id(iTri);
-            #ifdef SUPERQUADRIC_ACTIVE_FLAG
-                if(atom->superquadric_flag) {
-                  sidata.pos_i = x_[iPart];
-                  sidata.quat_i = quat_[iPart];
-                  sidata.shape_i = shape_[iPart];
-                  sidata.roundness_i = roundness_[iPart];
-                  Superquadric particle(sidata.pos_i, sidata.quat_i, sidata.shape_i, sidata.roundness_i);
-                  if(mesh->sphereTriangleIntersection(iTri, radius_[iPart], sidata.pos_i)) //check for Bounding Sphere-triangle intersection
-                    deltan = mesh->resolveTriSuperquadricContact(iTri, delta, sidata.contact_point, particle);
-                  else
-                    deltan = LARGE_TRIMESH;
-                  sidata.is_non_spherical = true; //by default it is false
-                } else
-                  deltan = mesh->resolveTriSphereContact(iPart,iTri,radius_ ? radius_[iPart]:r0_,x_[iPart],delta);
-            #else
-                deltan = mesh->resolveTriSphereContact(iPart,iTri,radius_ ? radius_[iPart]:r0_,x_[iPart],delta);
-            #endif
-            
-            if(deltan > skinDistance_) //allow force calculation away from the wall
-            {
-              
-            }
-             
-            else
-            {
-              
-              if(fix_contact && ! fix_contact->handleContact(iPart,idTri,sidata.contact_history)) continue;
-              
-              sidata.i = iPart;
-              sidata.deltan = -deltan;
-              sidata.delta[0] = -delta[0];
-              sidata.delta[1] = -delta[1];
-              sidata.delta[2] = -delta[2];
-              post_force_eval_contact(sidata, v_wall,iMesh,FixMesh_list_[iMesh],mesh,iTri);
-            }
-          }
+          for(int iCont = offsets[iPart]; iCont < offsets[iPart+1]; iCont++)
+            post_force_mesh_contact(sidata,iMesh,fix_mesh,mesh,vMesh,fix_contact,iPart,triangles[iCont]);
         }
       }
 
@@ -856,6 +762,59 @@ void FixWallGran::post_force_mesh(int vflag)
 
 }
 
+/* ----------------------------------------------------------------------
+   contact of particle iPart with triangle iTri of a mesh wall
+   vMesh is NULL for a non-moving mesh
+------------------------------------------------------------------------- */
+
+inline void FixWallGran::post_force_mesh_contact(SurfacesIntersectData & sidata, int iMesh, FixMeshSurface *fix_mesh, TriMesh *mesh,
+                                                 double ***vMesh, FixContactHistoryMesh *fix_contact, int iPart, int iTri)
+{
+    double v_wall[3],bary[3];
+    double delta[3],deltan;
+    const int idTri = mesh->id(iTri);
+
+    #ifdef SUPERQUADRIC_ACTIVE_FLAG
+        if(atom->superquadric_flag) {
+          sidata.pos_i = x_[iPart];
+          sidata.quat_i = quat_[iPart];
+          sidata.shape_i = shape_[iPart];
+          sidata.roundness_i = roundness_[iPart];
+          Superquadric particle(sidata.pos_i, sidata.quat_i, sidata.shape_i, sidata.roundness_i);
+          if(!mesh->sphereTriangleIntersection(iTri, radius_[iPart], sidata.pos_i)) //check for Bounding Sphere-triangle intersection
+            deltan = LARGE_TRIMESH;
+          else if(vMesh)
+            deltan = mesh->resolveTriSuperquadricContact(iTri, delta, sidata.contact_point, particle, bary);
+          else
+            deltan = mesh->resolveTriSuperquadricContact(iTri, delta, sidata.contact_point, particle);
+          sidata.is_non_spherical = true; //by default it is false
+        } else
+          deltan = mesh->resolveTriSphereContactBary(iPart,iTri,radius_ ? radius_[iPart]:r0_ ,x_[iPart],delta,bary);
+    #else
+        deltan = mesh->resolveTriSphereContactBary(iPart,iTri,radius_ ? radius_[iPart]:r0_ ,x_[iPart],delta,bary);
+    #endif
+
+    if(deltan > skinDistance_) //allow force calculation away from the wall
+        return;
+
+    if(fix_contact && ! fix_contact->handleContact(iPart,idTri,sidata.contact_history)) return;
+
+    if(vMesh)
+    {
+        for(int i = 0; i < 3; i++)
+          v_wall[i] = (bary[0]*vMesh[iTri][0][i] + bary[1]*vMesh[iTri][1][i] + bary[2]*vMesh[iTri][2][i]);
+    }
+    else
+        vectorZeroize3D(v_wall);
+
+    sidata.i = iPart;
+    sidata.deltan = -deltan;
+    sidata.delta[0] = -delta[0];
+    sidata.delta[1] = -delta[1];
+    sidata.delta[2] = -delta[2];
+    post_force_eval_contact(sidata, v_wall,iMesh,fix_mesh,mesh,iTri);
+}
+
 /* ----------------------------------------------------------------------
    post_force for primitive wall
 ------------------------------------------------------------------------- */
@@ -281,6 +281,8 @@ class FixWallGran : public Fix, public LIGGGHTS::IContactHistorySetup {
   virtual void post_force_wall(int vflag);
 
   inline void post_force_eval_contact(LCM::SurfacesIntersectData & sidata, double * v_wall, int iMesh = -1, FixMeshSurface *fix_mesh = 0, TriMesh *mesh = 0, int iTri = 0);
+  inline void post_force_mesh_contact(LCM::SurfacesIntersectData & sidata, int iMesh, FixMeshSurface *fix_mesh, TriMesh *mesh,
+                                      double ***vMesh, class FixContactHistoryMesh *fix_contact, int iPart, int iTri);
 };
 
 }
@@ -217,6 +217,11 @@ namespace LAMMPS_NS
         
         virtual bool resetToOrig();
 
+        // rigid body transform of the nodes w.r.t. node_orig_
+        // composed by the move / rotate functions, used by the rebuild check only
+        void resetBodyTransform();
+        void composeBodyTransform(double rot[3][3], double *origin);
+
         inline double precision()
         { return precision_; }
 
@@ -244,6 +249,17 @@ namespace LAMMPS_NS
         // only relevant for moving mesh
         int stepLastReset_;
 
+        // node_ = bodyRot_ * node_orig_ + bodyTrans_ as long as bodyValid_
+        // is set, i.e. the mesh has only been translated and rotated
+        double bodyRot_[3][3], bodyTrans_[3];
+        bool bodyValid_;
+
+        // body transform and bounding sphere of owned nodes at last re-build
+        // used to bound the node displacement in decideRebuild()
+        double bodyRotRe_[3][3], bodyTransRe_[3];
+        double centerRe_[3], radiusRe_;
+        bool bodyValidRe_;
+
         // extends a given bbox to include element number nElem
         void extendToElem(BoundingBox &box, int const nElem);
         void extendToElem(int const nElem);
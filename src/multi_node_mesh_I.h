@@ -67,8 +67,12 @@
     nScale_(0),
     nTranslate_(0),
     nRotate_(0),
-    stepLastReset_(-1)
+    stepLastReset_(-1),
+    bodyValid_(false),
+    radiusRe_(0.),
+    bodyValidRe_(false)
   {
+    resetBodyTransform();
   }
 
   /* ----------------------------------------------------------------------
@@ -195,10 +199,13 @@
       if(isDeforming())
           updateCenterRbound(ilo,ihi);
 
-      storeNodePosRebuild();
-
       if(node_orig_ && setupFlag)
+      {
         storeNodePosOrig(ilo,ihi);
+        resetBodyTransform();
+      }
+
+      storeNodePosRebuild();
 
       // nothing more to do here, necessary initialitation done in addElement()
   }
@@ -361,6 +368,8 @@
           }
 
           this->memory->template destroy<double>(tmp);
+
+          resetBodyTransform();
       }
 
       return isFirst;
@@ -382,6 +391,7 @@
       {
           delete node_orig_;
           node_orig_ = NULL;
+          bodyValid_ = bodyValidRe_ = false;
       }
   }
 
@@ -428,11 +438,48 @@
             for(int j = 0; j < NUM_NODES; j++)
                 vectorCopy3D(node_orig(i)[j],node_(i)[j]);
 
+        resetBodyTransform();
         return true;
     }
     return false;
   }
 
+  /* ----------------------------------------------------------------------
+   track the rigid body motion of the mesh
+   the nodes are node_orig_ rotated by bodyRot_ and shifted by bodyTrans_
+   as long as the mesh is only translated and rotated, which lets
+   decideRebuild() bound the node displacement without a loop over nodes.
+   the transform is only used for this check, move() and rotate() still
+   update all nodes and element properties, so moving a mesh stays O(ntri)
+  ------------------------------------------------------------------------- */
+
+  template<int NUM_NODES>
+  void MultiNodeMesh<NUM_NODES>::resetBodyTransform()
+  {
+    for(int i = 0; i < 3; i++)
+    {
+        vectorZeroize3D(bodyRot_[i]);
+        bodyRot_[i][i] = 1.;
+    }
+    vectorZeroize3D(bodyTrans_);
+    bodyValid_ = (node_orig_ != NULL);
+  }
+
+  template<int NUM_NODES>
+  void MultiNodeMesh<NUM_NODES>::composeBodyTransform(double rot[3][3], double *origin)
+  {
+    // x -> rot * (x - origin) + origin applied to x = bodyRot_ * X + bodyTrans_
+    double newRot[3][3], dx[3];
+
+    MathExtra::times3(rot,bodyRot_,newRot);
+    for(int i = 0; i < 3; i++)
+        vectorCopy3D(newRot[i],bodyRot_[i]);
+
+    vectorSubtract3D(bodyTrans_,origin,dx);
+    MathExtra::matvec(rot,dx,bodyTrans_);
+    vectorAdd3D(bodyTrans_,origin,bodyTrans_);
+  }
+
   /* ----------------------------------------------------------------------
    move mesh by amount vecTotal, starting from original position
   ------------------------------------------------------------------------- */
@@ -459,6 +506,8 @@
         vectorScalarDiv3D(center_(i),static_cast<double>(NUM_NODES));
     }
 
+    vectorAdd3D(bodyTrans_,vecTotal,bodyTrans_);
+
     updateGlobalBoundingBox();
   }
 
@@ -480,6 +529,8 @@
         vectorAdd3D(center_(i),vecIncremental,center_(i));
     }
 
+    vectorAdd3D(bodyTrans_,vecIncremental,bodyTrans_);
+
     updateGlobalBoundingBox();
   }
   /* ----------------------------------------------------------------------
@@ -494,6 +545,9 @@
 
     vectorAdd3D(center_(i),vecIncremental,center_(i));
 
+    // single elements no longer follow the body transform
+    bodyValid_ = false;
+
     extendToElem(bbox_,i);
   }
 
@@ -557,6 +611,10 @@
       vectorScalarDiv3D(center_(i),static_cast<double>(NUM_NODES));
     }
 
+    double rot[3][3];
+    MathExtra::quat_to_mat(totalQ,rot);
+    composeBodyTransform(rot,origin);
+
     updateGlobalBoundingBox();
   }
 
@@ -610,6 +668,10 @@
       vectorScalarDiv3D(center_(i),static_cast<double>(NUM_NODES));
     }
 
+    double rot[3][3];
+    MathExtra::quat_to_mat(dQ,rot);
+    composeBodyTransform(rot,origin);
+
     updateGlobalBoundingBox();
   }
 
@@ -646,6 +708,8 @@
       rBound_(i) = rb;
     }
 
+    bodyValid_ = false;
+
     updateGlobalBoundingBox();
   }
 
@@ -741,6 +805,29 @@
     if(nlocal != nodesLastRe_.size())
         this->error->one(FLERR,"Internal error in MultiNodeMesh::decide_rebuild()");
 
+    // rigid motion since last re-build: the displacement of every node X
+    // (body frame) is (R - R_re)*X + t - t_re, bound it via the bounding
+    // sphere of the nodes and only check node by node if it may exceed
+    if(bodyValid_ && bodyValidRe_)
+    {
+        double dRot[3][3], b[3];
+        double normSq = 0.;
+        for(int i = 0; i < 3; i++)
+        {
+            vectorSubtract3D(bodyRot_[i],bodyRotRe_[i],dRot[i]);
+            normSq += vectorMag3DSquared(dRot[i]);
+        }
+        MathExtra::matvec(dRot,centerRe_,b);
+        vectorAdd3D(b,bodyTrans_,b);
+        vectorSubtract3D(b,bodyTransRe_,b);
+
+        // allow for round-off of the node positions
+        double bound = sqrt(normSq)*radiusRe_ + vectorMag3D(b)
+                     + 1e-8*(vectorMag3D(centerRe_) + radiusRe_ + vectorMag3D(bodyTrans_));
+        if(bound*bound <= triggersq)
+            nlocal = 0;
+    }
+
     for(int iTri = 0; iTri < nlocal; iTri++)
     {
       for(int iNode = 0; iNode < NUM_NODES; iNode++)
@@ -779,6 +866,43 @@
     nodesLastRe_.clearContainer();
     for(int i = 0; i < nlocal; i++)
         nodesLastRe_.add(node[i]);
+
+    // store body transform and bounding sphere of the original nodes
+    // for decideRebuild(), if all owned nodes follow the body transform
+    bodyValidRe_ = false;
+    if(!bodyValid_ || isDeforming())
+        return;
+
+    BoundingBox box;
+    double lo[3], hi[3];
+    vectorZeroize3D(lo);
+    vectorZeroize3D(hi);
+
+    for(int i = 0; i < nlocal; i++)
+    {
+        for(int j = 0; j < NUM_NODES; j++)
+        {
+            double x[3], d[3];
+            MathExtra::matvec(bodyRot_,node_orig(i)[j],x);
+            vectorAdd3D(x,bodyTrans_,x);
+            vectorSubtract3D(node[i][j],x,d);
+            if(vectorMag3D(d) > 1e-10*(vectorMag3D(x) + this->neighbor->skin))
+                return;
+            box.extendToContain(node_orig(i)[j]);
+        }
+    }
+    if(nlocal > 0)
+        box.getBoxBounds(lo,hi);
+
+    for(int i = 0; i < 3; i++)
+        centerRe_[i] = 0.5*(lo[i] + hi[i]);
+    vectorSubtract3D(hi,centerRe_,hi);
+    radiusRe_ = vectorMag3D(hi);
+
+    for(int i = 0; i < 3; i++)
+        vectorCopy3D(bodyRot_[i],bodyRotRe_[i]);
+    vectorCopy3D(bodyTrans_,bodyTransRe_);
+    bodyValidRe_ = true;
   }
 
 #endif
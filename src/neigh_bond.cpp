@@ -100,7 +100,7 @@ void Neighbor::bond_all()
       if (newton_bond || i < atom1) {
         if (nbondlist == maxbond) {
           maxbond += BONDDELTA;
-          memory->grow(bondlist,maxbond,4,"neighbor:bondlist");
+          memory->grow(bondlist,maxbond,5,"neighbor:bondlist");
           if(atom->n_bondhist)
             memory->grow(bondhistlist,maxbond,atom->n_bondhist,"neighbor:bondhistlist");
         }
@@ -108,6 +108,7 @@ void Neighbor::bond_all()
         bondlist[nbondlist][1] = atom1;
         bondlist[nbondlist][2] = bond_type[i][m];
         bondlist[nbondlist][3] = 0;
+        bondlist[nbondlist][4] = m;
         if(n_bondhist) {
 //fprintf(logfile, "Neighbor::bond_all i=%d(tag=%d) j=%d(tag=%d) num_neighb=%d (bond_atom[i][m]=%d)\n", i, tag[i], atom1, tag[atom1], m, bond_atom[i][m]); ///AS DEBUG
             for(int j = 0; j < n_bondhist; j++)
@@ -158,12 +159,13 @@ void Neighbor::bond_partial()
       if (newton_bond || i < atom1) {
         if (nbondlist == maxbond) {
           maxbond += BONDDELTA;
-          memory->grow(bondlist,maxbond,3,"neighbor:bondlist");
+          memory->grow(bondlist,maxbond,5,"neighbor:bondlist");
         }
         bondlist[nbondlist][0] = i;
         bondlist[nbondlist][1] = atom1;
         bondlist[nbondlist][2] = bond_type[i][m];
         bondlist[nbondlist][3] = 0; 
+        bondlist[nbondlist][4] = m;
         if(n_bondhist) { 
 fprintf(logfile, "Neighbor::bond_partial i=%d m=%d \n", i, m); ///AS DEBUG
             for(int j = 0; j < n_bondhist; j++)
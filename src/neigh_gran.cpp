@@ -76,7 +76,6 @@ void Neighbor::granular_nsq_no_newton(NeighList *list)
   double *contact_hist_ptr = NULL;
 
   NeighList *listgranhistory;
-  int *npartner = NULL,**partner = NULL;
   double **contacthistory = NULL; 
   int **first_contact_flag;
   double **first_contact_hist;
@@ -104,8 +103,7 @@ void Neighbor::granular_nsq_no_newton(NeighList *list)
 
   FixContactHistory *fix_history = list->fix_history; 
   if (fix_history) {
-    npartner = fix_history->npartner_; 
-    partner = fix_history->partner_; 
+    fix_history->reset_partner_lookup();
     contacthistory = fix_history->contacthistory_; 
     listgranhistory = list->listgranhistory;
     first_contact_flag = listgranhistory->firstneigh;
@@ -155,9 +153,8 @@ void Neighbor::granular_nsq_no_newton(NeighList *list)
         if (fix_history) {
           if (rsq < radsum*radsum)
           {
-            for (m = 0; m < npartner[i]; m++)
-              if (partner[i][m] == tag[j]) break;
-            if (m < npartner[i]) {
+            m = fix_history->find_partner(i,tag[j]);
+            if (m >= 0) {
               contact_flag_ptr[n] = 1;
               for (d = 0; d < dnum; d++) {  
                 contact_hist_ptr[nn++] = contacthistory[i][m*dnum+d];
@@ -310,7 +307,6 @@ void Neighbor::granular_bin_no_newton_ghost(NeighList *list)
   double *contact_hist_ptr = NULL;
 
   NeighList *listgranhistory;
-  int *npartner = NULL,**partner = NULL;
   double **contacthistory = NULL;
   int **first_contact_flag = NULL;
   double **first_contact_hist = NULL;
@@ -343,8 +339,7 @@ void Neighbor::granular_bin_no_newton_ghost(NeighList *list)
 
   FixContactHistory *fix_history = list->fix_history; 
   if (fix_history) {
-    npartner = fix_history->npartner_; 
-    partner = fix_history->partner_; 
+    fix_history->reset_partner_lookup();
     contacthistory = fix_history->contacthistory_; 
     listgranhistory = list->listgranhistory;
     first_contact_flag = listgranhistory->firstneigh;
@@ -402,9 +397,8 @@ void Neighbor::granular_bin_no_newton_ghost(NeighList *list)
             if (fix_history) {
               if (rsq < radsum*radsum)
               {
-                for (m = 0; m < npartner[i]; m++)
-                  if (partner[i][m] == tag[j]) break;
-                if (m < npartner[i]) {
+                m = fix_history->find_partner(i,tag[j]);
+                if (m >= 0) {
                   contact_flag_ptr[n] = 1;
                   for (d = 0; d < dnum; d++) { 
                     contact_hist_ptr[nn++] = contacthistory[i][m*dnum+d];
@@ -491,7 +485,6 @@ void Neighbor::granular_bin_no_newton(NeighList *list)
   double *contact_hist_ptr = NULL;
 
   NeighList *listgranhistory;
-  int *npartner = NULL,**partner = NULL;
   double **contacthistory = NULL;
   int **first_contact_flag = NULL;
   double **first_contact_hist = NULL;
@@ -523,8 +516,7 @@ void Neighbor::granular_bin_no_newton(NeighList *list)
 
   FixContactHistory *fix_history = list->fix_history; 
   if (fix_history) {
-    npartner = fix_history->npartner_; 
-    partner = fix_history->partner_; 
+    fix_history->reset_partner_lookup();
     contacthistory = fix_history->contacthistory_; 
     listgranhistory = list->listgranhistory;
     first_contact_flag = listgranhistory->firstneigh;
@@ -584,10 +576,9 @@ void Neighbor::granular_bin_no_newton(NeighList *list)
             if (rsq < radsum*radsum)
             {
 
-              for (m = 0; m < npartner[i]; m++)
-                if (partner[i][m] == tag[j]) break;
+              m = fix_history->find_partner(i,tag[j]);
 
-              if (m < npartner[i]) {
+              if (m >= 0) {
                 contact_flag_ptr[n] = 1;
                 
                 for (d = 0; d < dnum; d++) { 
@@ -835,7 +835,7 @@ void Neighbor::init()
   if (atom->molecular && atom->nbonds && maxbond == 0) {
     if (nprocs == 1) maxbond = atom->nbonds;
     else maxbond = static_cast<int> (LB_FACTOR * atom->nbonds / nprocs);
-    memory->create(bondlist,maxbond,4,"neigh:bondlist");   
+    memory->create(bondlist,maxbond,5,"neigh:bondlist");   
     
     if(atom->n_bondhist)
        memory->create(bondhistlist,maxbond,atom->n_bondhist,"neigh:bondhistlist");
@@ -2174,7 +2174,7 @@ bigint Neighbor::memory_usage()
 
   for (int i = 0; i < nlist; i++) bytes += lists[i]->memory_usage();
 
-  bytes += memory->usage(bondlist,maxbond,3);
+  bytes += memory->usage(bondlist,maxbond,5);
   bytes += memory->usage(anglelist,maxangle,4);
   bytes += memory->usage(dihedrallist,maxdihedral,5);
   bytes += memory->usage(improperlist,maximproper,5);
@@ -106,7 +106,7 @@ class Neighbor : protected Pointers {
   class NeighList **lists;
 
   int nbondlist;                   // list of bonds to compute
-  int **bondlist;                  
+  int **bondlist;                  // i1, i2, type, state, slot of the bond in bond_atom[i1]
   double **bondhistlist;           
   int nanglelist;                  // list of angles to compute
   int **anglelist;
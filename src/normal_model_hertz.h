@@ -58,7 +58,7 @@ namespace ContactModels
   class NormalModel<HERTZ> : protected Pointers
   {
   public:
-    static const int MASK = CM_REGISTER_SETTINGS | CM_CONNECT_TO_PROPERTIES | CM_SURFACES_INTERSECT;
+    static const int MASK = CM_REGISTER_SETTINGS | CM_CONNECT_TO_PROPERTIES | CM_SURFACES_INTERSECT | CM_SURFACES_INTERSECT_BATCH;
 
     NormalModel(LAMMPS * lmp, IContactHistorySetup*,class ContactModelBase *c) : Pointers(lmp),
       Yeff(NULL),
@@ -213,6 +213,76 @@ namespace ContactModels
       }
     }
 
+    // heating tallies per pair, it is only done by surfacesIntersect()
+    inline bool checkSurfacesIntersectBatch()
+    {
+      return !heating;
+    }
+
+    // same as surfacesIntersect() for a block of particle-particle contacts
+    inline void surfacesIntersectBatch(SurfacesIntersectBatch & b)
+    {
+      const int n = b.n;
+      const bool limit = limitForce;
+      const double nktv2p = force->nktv2p;
+      const double sqrtFiveOverSix = 0.91287092917527685576161630466800355658790782499663875;
+      double Y[SurfacesIntersectBatch::SIZE];
+      double G[SurfacesIntersectBatch::SIZE];
+      double beta[SurfacesIntersectBatch::SIZE];
+
+      // material parameters of the pairs, the loop below does not vectorise with them
+      for (int k = 0; k < n; k++) {
+        Y[k] = Yeff[b.itype[k]][b.jtype[k]];
+        G[k] = Geff[b.itype[k]][b.jtype[k]];
+        beta[k] = betaeff[b.itype[k]][b.jtype[k]];
+      }
+
+      #pragma omp simd
+      for (int k = 0; k < n; k++) {
+        const double ri = b.radi[k];
+        const double rj = b.radj[k];
+        const double reff = ri*rj/(ri+rj);
+        const double meff = b.meff[k];
+        const double deltan = b.deltan[k];
+
+        const double sqrtval = sqrt(reff*deltan);
+
+        const double Sn=2.*Y[k]*sqrtval;
+        const double St=8.*G[k]*sqrtval;
+
+        // convert Kn and Kt from pressure units to force/distance^2
+        const double kn=4./3.*Y[k]*sqrtval/nktv2p;
+        const double kt=St/nktv2p;
+        const double gamman=-2.*sqrtFiveOverSix*beta[k]*sqrt(Sn*meff);
+        const double gammat=-2.*sqrtFiveOverSix*beta[k]*sqrt(St*meff);
+
+        const double Fn_damping = -gamman*b.vn[k];
+        const double Fn_contact = kn*deltan;
+        double Fn = Fn_damping + Fn_contact;
+
+        //limit force to avoid the artefact of negative repulsion force
+        if(limit && (Fn<0.0))
+          Fn = 0.0;
+
+        b.Fn[k] = Fn;
+        b.kn[k] = kn;
+        b.kt[k] = kt;
+        b.gamman[k] = gamman;
+        b.gammat[k] = gammat;
+
+        // apply normal force
+        b.fx[k] = Fn * b.enx[k];
+        b.fy[k] = Fn * b.eny[k];
+        b.fz[k] = Fn * b.enz[k];
+        b.torqueix[k] = b.torqueiy[k] = b.torqueiz[k] = 0.0;
+        b.torquejx[k] = b.torquejy[k] = b.torquejz[k] = 0.0;
+      }
+
+      if (!tangential_damping)
+        for (int k = 0; k < n; k++)
+          b.gammat[k] = 0.0;
+    }
+
     void surfacesClose(SurfacesCloseData&, ForceData&, ForceData&){}
     void beginPass(SurfacesIntersectData&, ForceData&, ForceData&){}
     void endPass(SurfacesIntersectData&, ForceData&, ForceData&){}
@@ -62,7 +62,7 @@ namespace ContactModels
   class NormalModel<HOOKE> : protected Pointers
   {
   public:
-    static const int MASK = CM_REGISTER_SETTINGS | CM_CONNECT_TO_PROPERTIES | CM_SURFACES_INTERSECT;
+    static const int MASK = CM_REGISTER_SETTINGS | CM_CONNECT_TO_PROPERTIES | CM_SURFACES_INTERSECT | CM_SURFACES_INTERSECT_BATCH;
 
     NormalModel(LAMMPS * lmp, IContactHistorySetup*,class ContactModelBase *c) : Pointers(lmp),
       Yeff(NULL),
@@ -258,6 +258,79 @@ namespace ContactModels
       }
     }
 
+    // heating tallies per pair, it is only done by surfacesIntersect()
+    inline bool checkSurfacesIntersectBatch()
+    {
+      return !heating;
+    }
+
+    // same as surfacesIntersect() for a block of particle-particle contacts
+    inline void surfacesIntersectBatch(SurfacesIntersectBatch & b)
+    {
+      const int n = b.n;
+      const bool limit = limitForce;
+      const double nktv2p = force->nktv2p;
+      double coeffRestLogChosen[SurfacesIntersectBatch::SIZE];
+
+      // pow() and log() do not vectorise, the stiffness is computed in a scalar loop
+      for (int k = 0; k < n; k++) {
+        const int itype = b.itype[k];
+        const int jtype = b.jtype[k];
+        const double ri = b.radi[k];
+        const double rj = b.radj[k];
+        const double reff = ri*rj/(ri+rj);
+        const double meff = b.meff[k];
+        const double sqrtval = sqrt(reff);
+
+        if (viscous)  {
+           // Stokes Number from MW Schmeeckle (2001)
+           const double stokes=meff*b.vn[k]/(6.0*M_PI*coeffMu[itype][jtype]*reff*reff);
+           // Empirical from Legendre (2006)
+           coeffRestLogChosen[k]=log(coeffRestMax[itype][jtype])+coeffStc[itype][jtype]/stokes;
+        } else {
+           coeffRestLogChosen[k]=coeffRestLog[itype][jtype];
+        }
+
+        const double kn = 16./15.*sqrtval*(Yeff[itype][jtype])*pow(15.*meff*charVel*charVel/(16.*sqrtval*Yeff[itype][jtype]),0.2);
+        b.kn[k] = kn;
+        b.kt[k] = ktToKn ? kn*0.285714286 : kn; //2//7
+      }
+
+      #pragma omp simd
+      for (int k = 0; k < n; k++) {
+        const double kn = b.kn[k];
+        const double kt = b.kt[k];
+        const double crl = coeffRestLogChosen[k];
+        const double gamman=sqrt(4.*b.meff[k]*kn/(1.+(M_PI/crl)*(M_PI/crl)));
+
+        // convert Kn and Kt from pressure units to force/distance^2
+        const double Fn_damping = -gamman*b.vn[k];
+        const double Fn_contact = kn/nktv2p*b.deltan[k];
+        double Fn = Fn_damping + Fn_contact;
+
+        //limit force to avoid the artefact of negative repulsion force
+        if(limit && (Fn<0.0))
+          Fn = 0.0;
+
+        b.Fn[k] = Fn;
+        b.kn[k] = kn/nktv2p;
+        b.kt[k] = kt/nktv2p;
+        b.gamman[k] = gamman;
+        b.gammat[k] = gamman;
+
+        // apply normal force
+        b.fx[k] = Fn * b.enx[k];
+        b.fy[k] = Fn * b.eny[k];
+        b.fz[k] = Fn * b.enz[k];
+        b.torqueix[k] = b.torqueiy[k] = b.torqueiz[k] = 0.0;
+        b.torquejx[k] = b.torquejy[k] = b.torquejz[k] = 0.0;
+      }
+
+      if (!tangential_damping)
+        for (int k = 0; k < n; k++)
+          b.gammat[k] = 0.0;
+    }
+
     inline void surfacesClose(SurfacesCloseData&, ForceData&, ForceData&){}
     void beginPass(SurfacesIntersectData&, ForceData&, ForceData&){}
     void endPass(SurfacesIntersectData&, ForceData&, ForceData&){}
@@ -103,6 +103,7 @@ PairGran::PairGran(LAMMPS *lmp) : Pair(lmp)
 
   cpl_enable = 1;
   cpl_ = NULL;
+  fhgc_ = NULL;
 
   energytrack_enable = 0;
   fppaCPEn = fppaCDEn = fppaCPEt = fppaCDEVt = fppaCDEFt = fppaCTFW = fppaDEH = NULL;
@@ -517,6 +518,21 @@ void PairGran::unregister_compute_pair_local(ComputePairGranLocal *ptr)
    cpl_ = NULL;
 }
 
+/* ----------------------------------------------------------------------
+   register and unregister callback to fix heat/gran/conduction
+------------------------------------------------------------------------- */
+
+void PairGran::register_fix_heat_gran_cond(FixHeatGranCond *ptr)
+{
+   if(fhgc_ != NULL && fhgc_ != ptr) error->all(FLERR,"Pair gran allows only one fix heat/gran/conduction with 'fused yes'");
+   fhgc_ = ptr;
+}
+
+void PairGran::unregister_fix_heat_gran_cond(FixHeatGranCond *ptr)
+{
+   if(fhgc_ == ptr) fhgc_ = NULL;
+}
+
 /* ----------------------------------------------------------------------
    return index for extra dnum
 ------------------------------------------------------------------------- */
@@ -108,6 +108,9 @@ public:
     cpl_->pair_finalize();
   }
 
+  void register_fix_heat_gran_cond(class FixHeatGranCond *);
+  void unregister_fix_heat_gran_cond(class FixHeatGranCond *ptr);
+
   /* PUBLIC ACCESS FUNCTIONS */
 
   int is_history()
@@ -123,6 +126,10 @@ public:
     return cpl_;
   }
 
+  inline class FixHeatGranCond * fhgc() {
+    return fhgc_;
+  }
+
   inline bool storeContactForces() {
     return store_contact_forces_;
   }
@@ -210,6 +217,9 @@ public:
   int cpl_enable;
   class ComputePairGranLocal *cpl_;
 
+  // fix heat/gran/conduction evaluating its fluxes in the force pass
+  class FixHeatGranCond *fhgc_;
+
   // storage for per-contact forces
   bool store_contact_forces_;
   class FixContactPropertyAtom *fix_contact_forces_;
@@ -60,9 +60,17 @@
 #include "neighbor.h"
 #include "neigh_list.h"
 #include "fix_contact_property_atom.h"
+#include "fix_heat_gran_conduction.h"
 #include "os_specific.h"
 
 #include "granular_pair_style.h"
+#include "memory.h"
+#include <vector>
+#include <algorithm>
+
+#if defined(_OPENMP)
+#include "omp.h"
+#endif
 
 namespace LIGGGHTS {
 using namespace ContactModels;
@@ -73,11 +81,37 @@ using namespace LAMMPS_NS;
 
 template<typename ContactModel>
 class Granular : private Pointers, public IGranularPairStyle {
+  // pair which passed the broad phase check in this step
+  struct ActiveContact {
+    int i, j;
+    int * contact_flags;
+    double * contact_history;
+  };
+
+  // selects the evaluation of the contact list in blocks, see compute_contacts_batch()
+  template<bool> struct Batched {};
+  typedef Batched<ContactModel::HANDLE_SURFACES_INTERSECT_BATCH != 0> BatchTag;
+
   SurfacesIntersectData * aligned_sidata;
   ForceData * aligned_i_forces;
   ForceData * aligned_j_forces;
+  SurfacesIntersectBatch * aligned_batch; // NULL if the models cannot be batched
   ContactModel cmodel;
 
+  // per-thread data of threads 1 ... nthreads-1, the master uses the aligned_* data and f, torque
+  int nthr, maxthr;
+  SurfacesIntersectData ** sidata_thr;
+  ForceData ** i_forces_thr;
+  ForceData ** j_forces_thr;
+  SurfacesIntersectBatch ** batch_thr;
+  double ***f_thr, ***torque_thr;
+
+  // touching pairs of each thread, including the master, rebuilt every step
+  std::vector< std::vector<ActiveContact> > contacts_thr;
+
+  // heat conduction fix called for every touching pair of this pass, or NULL
+  FixHeatGranCond * heat_pass;
+
   inline void force_update(double * const f, double * const torque,
       const ForceData & forces) {
     for (int coord = 0; coord < 3; coord++) {
@@ -91,13 +125,19 @@ public:
     aligned_sidata(aligned_malloc<SurfacesIntersectData>(32)),
     aligned_i_forces(aligned_malloc<ForceData>(32)),
     aligned_j_forces(aligned_malloc<ForceData>(32)),
-    cmodel(lmp, parent,false /*is_wall*/) {
+    aligned_batch(ContactModel::HANDLE_SURFACES_INTERSECT_BATCH ? aligned_malloc<SurfacesIntersectBatch>(64) : NULL),
+    cmodel(lmp, parent,false /*is_wall*/),
+    nthr(0), maxthr(0),
+    sidata_thr(NULL), i_forces_thr(NULL), j_forces_thr(NULL), batch_thr(NULL),
+    f_thr(NULL), torque_thr(NULL), heat_pass(NULL) {
   }
 
   virtual ~Granular() {
     aligned_free(aligned_sidata);
     aligned_free(aligned_i_forces);
     aligned_free(aligned_j_forces);
+    if (aligned_batch) aligned_free(aligned_batch);
+    destroy_thr();
   }
 
   int64_t hashcode()
@@ -178,17 +218,452 @@ public:
     else
       pg->evflag = pg->vflag_fdotr = 0;
 
-    double **x = atom->x;
-    double **v = atom->v;
     double **f = atom->f;
-    double **omega = atom->omega;
     double **torque = atom->torque;
+    const int nlocal = atom->nlocal;
+    const int newton_pair = force->newton_pair;
+    const int inum = pg->list->inum;
+    const bool store_contact_forces = pg->storeContactForces();
+
+    // fix heat/gran/conduction with 'fused yes' adds its fluxes in the
+    // force pass of the time-step, not in passes of compute pair/gran/local
+    heat_pass = (pg->fhgc() && !addflag && pg->computeflag() && pg->fhgc()->fused_pass()) ? pg->fhgc() : NULL;
+
+    // storing contact forces, compute pair/gran/local, heat fluxes, per-atom
+    // tallies and models writing per-atom data of both partners are not
+    // thread-safe, the pair loop then runs on the master thread only
+    const bool serial = store_contact_forces || (pg->cpl() && addflag) || heat_pass ||
+                        pg->eflag_atom || pg->vflag_atom ||
+                        ContactModel::HANDLE_WRITES_ATOM_DATA;
+    const int nthreads = serial ? 1 : comm->nthreads;
+    const bool batched = batch_enabled(BatchTag());
+    const int nall = newton_pair ? nlocal + atom->nghost : nlocal;
+    double v0,v1,v2,v3,v4,v5; // global virial of threads 1 ... nthreads-1
+    v0 = v1 = v2 = v3 = v4 = v5 = 0.0;
+
+    // all threads but the master accumulate forces and torques in their own
+    // arrays, which are summed up after the pair loop
+    if (nthreads > 1) grow_thr(nthreads);
+    if ((int)contacts_thr.size() < nthreads) contacts_thr.resize(nthreads);
+
+    // the hooks of the pass are called by the master only, so the contact
+    // models must not keep per-pair state between beginPass() and endPass()
+    init_thread_data(pg, *aligned_sidata, *aligned_i_forces, *aligned_j_forces);
+    cmodel.beginPass(*aligned_sidata, *aligned_i_forces, *aligned_j_forces);
+
+#if defined (_OPENMP)
+#pragma omp parallel num_threads(nthreads) default(shared) reduction(+:v0,v1,v2,v3,v4,v5)
+#endif
+    {
+#if defined (_OPENMP)
+      const int tid = omp_get_thread_num();
+#else
+      const int tid = 0;
+#endif
+      SurfacesIntersectData & sidata = tid ? *sidata_thr[tid-1] : *aligned_sidata;
+      ForceData & i_forces = tid ? *i_forces_thr[tid-1] : *aligned_i_forces;
+      ForceData & j_forces = tid ? *j_forces_thr[tid-1] : *aligned_j_forces;
+      SurfacesIntersectBatch * const batch = tid ? batch_thr[tid-1] : aligned_batch;
+      double ** const f_t = tid ? f_thr[tid-1] : f;
+      double ** const torque_t = tid ? torque_thr[tid-1] : torque;
+      double v[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+      double * const v_t = tid ? v : NULL; // the master tallies into pg directly
+      if (tid) {
+        init_thread_data(pg, sidata, i_forces, j_forces);
+        if (nall > 0) {
+          memset(&(f_t[0][0]), 0, 3*nall*sizeof(double));
+          memset(&(torque_t[0][0]), 0, 3*nall*sizeof(double));
+        }
+      }
+
+      // a pair is listed for one of its atoms only, so its contact history
+      // is only touched by the thread owning ii
+
+      std::vector<ActiveContact> & contacts = contacts_thr[tid];
+      contacts.clear();
+
+#if defined (_OPENMP)
+#pragma omp for schedule(static) nowait
+#endif
+      for (int ii = 0; ii < inum; ii++)
+        collect_contacts_i(pg, ii, addflag, contacts, sidata, i_forces, j_forces, f_t, torque_t, v_t);
+
+      // the contact models only run over the dense list of touching pairs
+
+      if (batched) {
+        compute_contacts_batch(pg, addflag, contacts, *batch, sidata, i_forces, j_forces, f_t, torque_t, v_t, BatchTag());
+      } else {
+        const int ncontacts = contacts.size();
+        for (int n = 0; n < ncontacts; n++)
+          compute_contact(pg, addflag, contacts[n], sidata, i_forces, j_forces, f_t, torque_t, v_t);
+      }
+
+      v0 += v[0]; v1 += v[1]; v2 += v[2];
+      v3 += v[3]; v4 += v[4]; v5 += v[5];
+    } // end of omp parallel
+
+    if (nthreads > 1) {
+#if defined (_OPENMP)
+#pragma omp parallel for num_threads(nthreads) default(shared) schedule(static)
+#endif
+      for (int i = 0; i < nall; i++)
+        for (int t = 0; t < nthreads-1; t++) {
+          vectorAdd3D(f[i], f_thr[t][i], f[i]);
+          vectorAdd3D(torque[i], torque_thr[t][i], torque[i]);
+        }
+    }
+
+    if (pg->vflag_global) {
+      pg->virial[0] += v0;
+      pg->virial[1] += v1;
+      pg->virial[2] += v2;
+      pg->virial[3] += v3;
+      pg->virial[4] += v4;
+      pg->virial[5] += v5;
+    }
+
+    cmodel.endPass(*aligned_sidata, *aligned_i_forces, *aligned_j_forces);
+
+    if (pg->cpl() && addflag)
+        pg->cpl_pair_finalize();
+
+    if(store_contact_forces)
+        pg->fix_contact_forces()->do_forward_comm();
+  }
+
+private:
+
+  // clear data, just to be safe
+  inline void init_thread_data(PairGran * pg, SurfacesIntersectData & sidata,
+      ForceData & i_forces, ForceData & j_forces) {
+    memset(&sidata, 0, sizeof(SurfacesIntersectData));
+    memset(&i_forces, 0, sizeof(ForceData));
+    memset(&j_forces, 0, sizeof(ForceData));
+    sidata.area_ratio = 1.0;
+    sidata.is_wall = false;
+    sidata.computeflag = pg->computeflag();
+    sidata.shearupdate = pg->shearupdate();
+  }
+
+  // global virial of one pair as in Pair::ev_tally_xyz()
+  inline void virial_tally(double * const v, const int i, const int j, const int nlocal,
+      const int newton_pair, const double * const fij, const double * const del) {
+    const double factor = newton_pair ? 1.0 : 0.5*((i < nlocal) + (j < nlocal));
+    v[0] += factor*del[0]*fij[0];
+    v[1] += factor*del[1]*fij[1];
+    v[2] += factor*del[2]*fij[2];
+    v[3] += factor*del[0]*fij[1];
+    v[4] += factor*del[0]*fij[2];
+    v[5] += factor*del[1]*fij[2];
+  }
+
+  // broad phase check of atom ilist[ii] with its neighbours, touching pairs are appended
+  // to the contact list, non-touching pairs are handled here if the models need them
+  inline void collect_contacts_i(PairGran * pg, const int ii, const int addflag,
+      std::vector<ActiveContact> & contacts,
+      SurfacesIntersectData & sidata, ForceData & i_forces, ForceData & j_forces,
+      double ** const f_t, double ** const torque_t, double * const v_t)
+  {
+    double **x = atom->x;
     double *radius = atom->radius;
+
+    int ** first_contact_flag = pg->listgranhistory ? pg->listgranhistory->firstneigh : NULL;
+    double ** first_contact_hist = pg->listgranhistory ? pg->listgranhistory->firstdouble : NULL;
+    const int dnum = pg->dnum();
+
+    const int i = pg->list->ilist[ii];
+    const double xtmp = x[i][0];
+    const double ytmp = x[i][1];
+    const double ztmp = x[i][2];
+    const double radi = radius[i];
+    int * const contact_flags = first_contact_flag ? first_contact_flag[i] : NULL;
+    double * const all_contact_hist = first_contact_hist ? first_contact_hist[i] : NULL;
+    int * const jlist = pg->list->firstneigh[i];
+    const int jnum = pg->list->numneigh[i];
+
+    for (int jj = 0; jj < jnum; jj++) {
+      const int j = jlist[jj] & NEIGHMASK;
+
+      const double delx = xtmp - x[j][0];
+      const double dely = ytmp - x[j][1];
+      const double delz = ztmp - x[j][2];
+      const double rsq = delx * delx + dely * dely + delz * delz;
+      const double radsum = radi + radius[j];
+
+      ActiveContact c;
+      c.i = i;
+      c.j = j;
+      c.contact_flags = contact_flags ? &contact_flags[jj] : NULL;
+      c.contact_history = all_contact_hist ? &all_contact_hist[dnum*jj] : NULL;
+
+      // rsq < radsum * radsum is broad phase check with bounding spheres
+      if (rsq < radsum * radsum) {
+        contacts.push_back(c);
+        continue;
+      }
+
+      if (!ContactModel::HANDLE_SURFACES_CLOSE) continue;
+
+      setup_pair(sidata, c);
+      i_forces.reset();
+      j_forces.reset();
+
+      // apply force update only if selected contact models have requested it
+      sidata.has_force_update = false;
+      cmodel.surfacesClose(sidata, i_forces, j_forces);
+
+      if(sidata.has_force_update)
+        pair_force_update(pg, addflag, sidata, i_forces, j_forces, f_t, torque_t, v_t);
+    }
+  }
+
+  // forces of a pair from the contact list, accumulated in f_t and torque_t
+  // v_t = global virial of a thread other than the master, NULL for the master
+  inline void compute_contact(PairGran * pg, const int addflag, const ActiveContact & c,
+      SurfacesIntersectData & sidata, ForceData & i_forces, ForceData & j_forces,
+      double ** const f_t, double ** const torque_t, double * const v_t)
+  {
+    double **v = atom->v;
+    double **omega = atom->omega;
+    int *type = atom->type;
+#ifdef SUPERQUADRIC_ACTIVE_FLAG
+    double *rmass = atom->rmass;
+    double *mass = atom->mass;
+#endif
+    const int i = c.i;
+    const int j = c.j;
+
+    setup_pair(sidata, c);
+    i_forces.reset();
+    j_forces.reset();
+
+    // cmodel.checkSurfaceIntersect() is narrow phase check
+
+#ifdef SUPERQUADRIC_ACTIVE_FLAG
+    sidata.v_i     = v[i];
+    sidata.v_j     = v[j];
+    if (rmass) {
+      sidata.mi = rmass[i];
+      sidata.mj = rmass[j];
+    } else {
+      sidata.mi = mass[type[i]];
+      sidata.mj = mass[type[j]];
+    }
+    sidata.omega_i = omega[i];
+    sidata.omega_j = omega[j];
+#endif
+    if (cmodel.checkSurfaceIntersect(sidata)) {
+      const double r = sqrt(sidata.rsq);
+      const double rinv = 1.0 / r;
+
+      // unit normal vector for case of spherical particles
+      // for non-spherical, this is done by surface model
+      const double enx_sphere = sidata.delta[0] * rinv;
+      const double eny_sphere = sidata.delta[1] * rinv;
+      const double enz_sphere = sidata.delta[2] * rinv;
+
+      // meff = effective mass of pair of particles
+      // if I or J part of rigid body, use body mass
+      // if I or J is frozen, meff is other particle
+      double mi, mj;
+      const int itype = type[i];
+      const int jtype = type[j];
+      const double meff = effective_mass(pg, i, j, mi, mj);
+
+      // copy collision data to struct (compiler can figure out a better way to
+      // interleave these stores with the double calculations above.
+      sidata.itype = itype;
+      sidata.jtype = jtype;
+      sidata.r = r;
+      sidata.rinv = rinv;
+      sidata.meff = meff;
+      sidata.mi = mi;
+      sidata.mj = mj;
+      if(atom->sphere_flag) {
+          sidata.en[0]   = enx_sphere;
+          sidata.en[1]   = eny_sphere;
+          sidata.en[2]   = enz_sphere;
+      }
+      sidata.v_i     = v[i];
+      sidata.v_j     = v[j];
+      sidata.omega_i = omega[i];
+      sidata.omega_j = omega[j];
+
+      cmodel.surfacesIntersect(sidata, i_forces, j_forces);
+
+      cmodel.endSurfacesIntersect(sidata,0);
+
+      if (heat_pass)
+        heat_pass->add_pair(i, j, sidata.delta, r, sidata.radi, sidata.radj);
+
+      // if there is a surface touch, there will always be a force
+      sidata.has_force_update = true;
+    } else {
+      // apply force update only if selected contact models have requested it
+      sidata.has_force_update = false;
+      cmodel.surfacesClose(sidata, i_forces, j_forces);
+    }
+
+    if(sidata.has_force_update)
+      pair_force_update(pg, addflag, sidata, i_forces, j_forces, f_t, torque_t, v_t);
+  }
+
+  // meff = effective mass of pair of particles
+  // if I or J part of rigid body, use body mass
+  // if I or J is frozen, meff is other particle
+  inline double effective_mass(PairGran * pg, const int i, const int j, double & mi, double & mj)
+  {
     double *rmass = atom->rmass;
     double *mass = atom->mass;
     int *type = atom->type;
     int *mask = atom->mask;
-    int nlocal = atom->nlocal;
+    const int freeze_group_bit = pg->freeze_group_bit();
+
+    if (rmass) {
+      mi = rmass[i];
+      mj = rmass[j];
+    } else {
+      mi = mass[type[i]];
+      mj = mass[type[j]];
+    }
+    if (pg->fr_pair()) {
+      const double * mass_rigid = pg->mr_pair();
+      if (mass_rigid[i] > 0.0) mi = mass_rigid[i];
+      if (mass_rigid[j] > 0.0) mj = mass_rigid[j];
+    }
+
+    double meff = mi * mj / (mi + mj);
+    if (mask[i] & freeze_group_bit)
+      meff = mj;
+    if (mask[j] & freeze_group_bit)
+      meff = mi;
+    return meff;
+  }
+
+  // the contact list is evaluated in blocks if all models support it and
+  // none of them needs per-pair calls this run
+  inline bool batch_enabled(Batched<false>)
+  {
+    return false;
+  }
+
+  inline bool batch_enabled(Batched<true>)
+  {
+#ifdef SUPERQUADRIC_ACTIVE_FLAG
+    if (atom->superquadric_flag) return false;
+#endif
+    return atom->sphere_flag && cmodel.checkSurfacesIntersectBatch();
+  }
+
+  inline void compute_contacts_batch(PairGran *, const int, const std::vector<ActiveContact> &,
+      SurfacesIntersectBatch &, SurfacesIntersectData &, ForceData &, ForceData &,
+      double ** const, double ** const, double * const, Batched<false>) {}
+
+  // forces of the pairs from the contact list, evaluated in blocks of
+  // SurfacesIntersectBatch::SIZE pairs by the vectorised contact models
+  inline void compute_contacts_batch(PairGran * pg, const int addflag,
+      const std::vector<ActiveContact> & contacts, SurfacesIntersectBatch & batch,
+      SurfacesIntersectData & sidata, ForceData & i_forces, ForceData & j_forces,
+      double ** const f_t, double ** const torque_t, double * const v_t, Batched<true>)
+  {
+    double **x = atom->x;
+    double **v = atom->v;
+    double **omega = atom->omega;
+    double *radius = atom->radius;
+    int *type = atom->type;
+    const int ncontacts = contacts.size();
+
+    batch.computeflag = sidata.computeflag;
+    batch.shearupdate = sidata.shearupdate;
+
+    for (int first = 0; first < ncontacts; first += SurfacesIntersectBatch::SIZE) {
+      const int n = std::min(ncontacts - first, SurfacesIntersectBatch::SIZE);
+      const ActiveContact * const c = &contacts[first];
+
+      // gather the pairs of the block
+      batch.n = n;
+      for (int k = 0; k < n; k++) {
+        const int i = c[k].i;
+        const int j = c[k].j;
+        double mi, mj;
+
+        batch.i[k] = i;
+        batch.j[k] = j;
+        batch.itype[k] = type[i];
+        batch.jtype[k] = type[j];
+        batch.contact_flags[k] = c[k].contact_flags;
+        batch.contact_history[k] = c[k].contact_history;
+        batch.radi[k] = radius[i];
+        batch.radj[k] = radius[j];
+        batch.radsum[k] = radius[i] + radius[j];
+
+        const double delx = x[i][0] - x[j][0];
+        const double dely = x[i][1] - x[j][1];
+        const double delz = x[i][2] - x[j][2];
+        const double r = sqrt(delx*delx + dely*dely + delz*delz);
+        const double rinv = 1.0 / r;
+        batch.deltax[k] = delx;
+        batch.deltay[k] = dely;
+        batch.deltaz[k] = delz;
+        batch.r[k] = r;
+        batch.rinv[k] = rinv;
+        batch.enx[k] = delx * rinv;
+        batch.eny[k] = dely * rinv;
+        batch.enz[k] = delz * rinv;
+        batch.meff[k] = effective_mass(pg, i, j, mi, mj);
+
+        batch.vix[k] = v[i][0];
+        batch.viy[k] = v[i][1];
+        batch.viz[k] = v[i][2];
+        batch.vjx[k] = v[j][0];
+        batch.vjy[k] = v[j][1];
+        batch.vjz[k] = v[j][2];
+        batch.omegaix[k] = omega[i][0];
+        batch.omegaiy[k] = omega[i][1];
+        batch.omegaiz[k] = omega[i][2];
+        batch.omegajx[k] = omega[j][0];
+        batch.omegajy[k] = omega[j][1];
+        batch.omegajz[k] = omega[j][2];
+      }
+
+      cmodel.surfacesIntersectBatch(batch);
+
+      // scatter the forces in the order of the contact list
+      for (int k = 0; k < n; k++) {
+        sidata.i = batch.i[k];
+        sidata.j = batch.j[k];
+        sidata.delta[0] = batch.deltax[k];
+        sidata.delta[1] = batch.deltay[k];
+        sidata.delta[2] = batch.deltaz[k];
+        sidata.contact_flags = batch.contact_flags[k];
+        sidata.contact_history = batch.contact_history[k];
+
+        i_forces.delta_F[0] = batch.fx[k];
+        i_forces.delta_F[1] = batch.fy[k];
+        i_forces.delta_F[2] = batch.fz[k];
+        i_forces.delta_torque[0] = batch.torqueix[k];
+        i_forces.delta_torque[1] = batch.torqueiy[k];
+        i_forces.delta_torque[2] = batch.torqueiz[k];
+        j_forces.delta_F[0] = -batch.fx[k];
+        j_forces.delta_F[1] = -batch.fy[k];
+        j_forces.delta_F[2] = -batch.fz[k];
+        j_forces.delta_torque[0] = batch.torquejx[k];
+        j_forces.delta_torque[1] = batch.torquejy[k];
+        j_forces.delta_torque[2] = batch.torquejz[k];
+
+        pair_force_update(pg, addflag, sidata, i_forces, j_forces, f_t, torque_t, v_t);
+
+        if (heat_pass)
+          heat_pass->add_pair(batch.i[k], batch.j[k], sidata.delta, batch.r[k], batch.radi[k], batch.radj[k]);
+      }
+    }
+  }
+
+  // geometry and history of a pair for surfacesIntersect() and surfacesClose()
+  inline void setup_pair(SurfacesIntersectData & sidata, const ActiveContact & c)
+  {
+    double **x = atom->x;
+    double *radius = atom->radius;
 #ifdef SUPERQUADRIC_ACTIVE_FLAG
     int superquadric_flag = atom->superquadric_flag;
     double **quat = atom->quaternion;
@@ -196,220 +671,133 @@ public:
     double **roundness = atom->roundness;
     double **inertia = atom->inertia;
 #endif // SUPERQUADRIC_ACTIVE_FLAG
-    const int newton_pair = force->newton_pair;
+    const int i = c.i;
+    const int j = c.j;
+
+    sidata.i = i;
+    sidata.j = j;
+    sidata.delta[0] = x[i][0] - x[j][0];
+    sidata.delta[1] = x[i][1] - x[j][1];
+    sidata.delta[2] = x[i][2] - x[j][2];
+    sidata.rsq = vectorMag3DSquared(sidata.delta);
+    sidata.radi = radius[i];
+    sidata.radj = radius[j];
+    sidata.radsum = radius[i] + radius[j];
+    sidata.contact_flags = c.contact_flags;
+    sidata.contact_history = c.contact_history;
+    #ifdef SUPERQUADRIC_ACTIVE_FLAG
+        if(superquadric_flag) {
+          sidata.pos_i = x[i];
+          sidata.quat_i = quat[i];
+          sidata.shape_i = shape[i];
+          sidata.roundness_i = roundness[i];
+          sidata.radi = cbrt(0.75 * atom->volume[i] / M_PI);
+          sidata.inertia_i = inertia[i];
+          sidata.pos_j = x[j];
+          sidata.quat_j = quat[j];
+          sidata.shape_j = shape[j];
+          sidata.roundness_j = roundness[j];
+          sidata.radj = cbrt(0.75 * atom->volume[j] / M_PI);
+          sidata.inertia_j = inertia[j];
+        }
+    #endif
+  }
 
-    int inum = pg->list->inum;
-    int * ilist = pg->list->ilist;
-    int * numneigh = pg->list->numneigh;
+  // apply the forces of a pair and tally them
+  inline void pair_force_update(PairGran * pg, const int addflag, SurfacesIntersectData & sidata,
+      ForceData & i_forces, ForceData & j_forces,
+      double ** const f_t, double ** const torque_t, double * const v_t)
+  {
+    const int i = sidata.i;
+    const int j = sidata.j;
+    const int nlocal = atom->nlocal;
+    const int newton_pair = force->newton_pair;
+    const bool store_contact_forces = pg->storeContactForces();
 
-    int ** firstneigh = pg->list->firstneigh;
-    int ** first_contact_flag = pg->listgranhistory ? pg->listgranhistory->firstneigh : NULL;
-    double ** first_contact_hist = pg->listgranhistory ? pg->listgranhistory->firstdouble : NULL;
+    if (sidata.computeflag) {
+      force_update(f_t[i], torque_t[i], i_forces);
 
-    const int dnum = pg->dnum();
-    const bool store_contact_forces = pg->storeContactForces();
-    const int freeze_group_bit = pg->freeze_group_bit();
+      if(newton_pair || j < nlocal) {
+        force_update(f_t[j], torque_t[j], j_forces);
+      }
+    }
 
-    // clear data, just to be safe
-    memset(aligned_sidata, 0, sizeof(SurfacesIntersectData));
-    memset(aligned_i_forces, 0, sizeof(ForceData));
-    memset(aligned_j_forces, 0, sizeof(ForceData));
-    aligned_sidata->area_ratio = 1.0;
+    if (pg->cpl() && addflag)
+      pg->cpl_add_pair(sidata, i_forces);
 
-    SurfacesIntersectData & sidata = *aligned_sidata;
-    ForceData & i_forces = *aligned_i_forces;
-    ForceData & j_forces = *aligned_j_forces;
-    sidata.is_wall = false;
-    sidata.computeflag = pg->computeflag();
-    sidata.shearupdate = pg->shearupdate();
+    if (pg->evflag) {
+      if (!v_t)
+        pg->ev_tally_xyz(i, j, nlocal, newton_pair, 0.0, 0.0,i_forces.delta_F[0],i_forces.delta_F[1],i_forces.delta_F[2],sidata.delta[0],sidata.delta[1],sidata.delta[2]);
+      else if (pg->vflag_global)
+        virial_tally(v_t, i, j, nlocal, newton_pair, i_forces.delta_F, sidata.delta);
+    }
 
-    cmodel.beginPass(sidata, i_forces, j_forces);
-
-    // loop over neighbors of my atoms
-
-    for (int ii = 0; ii < inum; ii++) {
-      const int i = ilist[ii];
-      const double xtmp = x[i][0];
-      const double ytmp = x[i][1];
-      const double ztmp = x[i][2];
-      const double radi = radius[i];
-      int * const contact_flags = first_contact_flag ? first_contact_flag[i] : NULL;
-      double * const all_contact_hist = first_contact_hist ? first_contact_hist[i] : NULL;
-      int * const jlist = firstneigh[i];
-      const int jnum = numneigh[i];
-
-      sidata.i = i;
-      sidata.radi = radi;
-      #ifdef SUPERQUADRIC_ACTIVE_FLAG
-          if(superquadric_flag) {
-            sidata.pos_i = x[i];
-            sidata.quat_i = quat[i];
-            sidata.shape_i = shape[i];
-            sidata.roundness_i = roundness[i];
-            sidata.radi = cbrt(0.75 * atom->volume[i] / M_PI);
-            sidata.inertia_i = inertia[i];
-          }
-      #endif
-
-      for (int jj = 0; jj < jnum; jj++) {
-        const int j = jlist[jj] & NEIGHMASK;
-
-        const double delx = xtmp - x[j][0];
-        const double dely = ytmp - x[j][1];
-        const double delz = ztmp - x[j][2];
-        const double rsq = delx * delx + dely * dely + delz * delz;
-        const double radj = radius[j];
-        const double radsum = radi + radj;
-
-        sidata.j = j;
-        sidata.delta[0] = delx;
-        sidata.delta[1] = dely;
-        sidata.delta[2] = delz;
-        sidata.rsq = rsq;
-        sidata.radj = radj;
-        sidata.radsum = radsum;
-        sidata.contact_flags = contact_flags ? &contact_flags[jj] : NULL;
-        sidata.contact_history = all_contact_hist ? &all_contact_hist[dnum*jj] : NULL;
-        #ifdef SUPERQUADRIC_ACTIVE_FLAG
-            if(superquadric_flag) {
-              sidata.pos_j = x[j];
-              sidata.quat_j = quat[j];
-              sidata.shape_j = shape[j];
-              sidata.roundness_j = roundness[j];
-              sidata.radj = cbrt(0.75 * atom->volume[j] / M_PI);
-              sidata.inertia_j = inertia[j];
-            }
-        #endif
-
-        i_forces.reset();
-        j_forces.reset();
-
-        // rsq < radsum * radsum is broad phase check with bounding spheres
-        // cmodel.checkSurfaceIntersect() is narrow phase check
-        
-#ifdef SUPERQUADRIC_ACTIVE_FLAG
-        sidata.v_i     = v[i];
-        sidata.v_j     = v[j];
-        if (rmass) {
-          sidata.mi = rmass[i];
-          sidata.mj = rmass[j];
-        } else {
-          sidata.mi = mass[type[i]];
-          sidata.mj = mass[type[j]];
-        }
-        sidata.omega_i = omega[i];
-        sidata.omega_j = omega[j];
-#endif
-        if (rsq < radsum * radsum && cmodel.checkSurfaceIntersect(sidata)) {
-          const double r = sqrt(rsq);
-          const double rinv = 1.0 / r;
-
-          // unit normal vector for case of spherical particles
-          // for non-spherical, this is done by surface model
-          const double enx_sphere = delx * rinv;
-          const double eny_sphere = dely * rinv;
-          const double enz_sphere = delz * rinv;
-
-          // meff = effective mass of pair of particles
-          // if I or J part of rigid body, use body mass
-          // if I or J is frozen, meff is other particle
-          double mi, mj;
-          const int itype = type[i];
-          const int jtype = type[j];
-
-          if (rmass) {
-            mi = rmass[i];
-            mj = rmass[j];
-          } else {
-            mi = mass[itype];
-            mj = mass[jtype];
-          }
-          if (pg->fr_pair()) {
-            const double * mass_rigid = pg->mr_pair();
-            if (mass_rigid[i] > 0.0) mi = mass_rigid[i];
-            if (mass_rigid[j] > 0.0) mj = mass_rigid[j];
-          }
-
-          double meff = mi * mj / (mi + mj);
-          if (mask[i] & freeze_group_bit)
-            meff = mj;
-          if (mask[j] & freeze_group_bit)
-            meff = mi;
-
-          // copy collision data to struct (compiler can figure out a better way to
-          // interleave these stores with the double calculations above.
-          sidata.itype = itype;
-          sidata.jtype = jtype;
-          sidata.r = r;
-          sidata.rinv = rinv;
-          sidata.meff = meff;
-          sidata.mi = mi;
-          sidata.mj = mj;
-          if(atom->sphere_flag) {
-              sidata.en[0]   = enx_sphere;
-              sidata.en[1]   = eny_sphere;
-              sidata.en[2]   = enz_sphere;
-          }
-          sidata.v_i     = v[i];
-          sidata.v_j     = v[j];
-          sidata.omega_i = omega[i];
-          sidata.omega_j = omega[j];
-
-          cmodel.surfacesIntersect(sidata, i_forces, j_forces);
-
-          cmodel.endSurfacesIntersect(sidata,0);
-
-          // if there is a surface touch, there will always be a force
-          sidata.has_force_update = true;
-        } else {
-          // apply force update only if selected contact models have requested it
-          sidata.has_force_update = false;
-          cmodel.surfacesClose(sidata, i_forces, j_forces);
-        }
+    if (store_contact_forces)
+    {
+      double forces_torques_i[6],forces_torques_j[6];
 
-        if(sidata.has_force_update) {
-          if (sidata.computeflag) {
-            force_update(f[i], torque[i], i_forces);
-
-            if(newton_pair || j < nlocal) {
-              force_update(f[j], torque[j], j_forces);
-            }
-          }
-
-          if (pg->cpl() && addflag)
-            pg->cpl_add_pair(sidata, i_forces);
-
-          if (pg->evflag)
-            pg->ev_tally_xyz(i, j, nlocal, newton_pair, 0.0, 0.0,i_forces.delta_F[0],i_forces.delta_F[1],i_forces.delta_F[2],sidata.delta[0],sidata.delta[1],sidata.delta[2]);
-
-          if (store_contact_forces)
-          {
-            double forces_torques_i[6],forces_torques_j[6];
-
-            if(!pg->fix_contact_forces()->has_partner(i,atom->tag[j]))
-            {
-                vectorCopy3D(i_forces.delta_F,&(forces_torques_i[0]));
-                vectorCopy3D(i_forces.delta_torque,&(forces_torques_i[3]));
-                pg->fix_contact_forces()->add_partner(i,atom->tag[j],forces_torques_i);
-            }
-            if(!pg->fix_contact_forces()->has_partner(j,atom->tag[i]))
-            {
-                vectorCopy3D(j_forces.delta_F,&(forces_torques_j[0]));
-                vectorCopy3D(j_forces.delta_torque,&(forces_torques_j[3]));
-                pg->fix_contact_forces()->add_partner(j,atom->tag[i],forces_torques_j);
-            }
-          }
-        }
+      if(!pg->fix_contact_forces()->has_partner(i,atom->tag[j]))
+      {
+          vectorCopy3D(i_forces.delta_F,&(forces_torques_i[0]));
+          vectorCopy3D(i_forces.delta_torque,&(forces_torques_i[3]));
+          pg->fix_contact_forces()->add_partner(i,atom->tag[j],forces_torques_i);
+      }
+      if(!pg->fix_contact_forces()->has_partner(j,atom->tag[i]))
+      {
+          vectorCopy3D(j_forces.delta_F,&(forces_torques_j[0]));
+          vectorCopy3D(j_forces.delta_torque,&(forces_torques_j[3]));
+          pg->fix_contact_forces()->add_partner(j,atom->tag[i],forces_torques_j);
       }
     }
+  }
 
-    cmodel.endPass(sidata, i_forces, j_forces);
+  // per-thread data of threads 1 ... nthreads-1, the force arrays grow with atom->nmax
 
-    if (pg->cpl() && addflag)
-        pg->cpl_pair_finalize();
+  void grow_thr(int nthreads)
+  {
+    if (nthreads-1 == nthr && atom->nmax <= maxthr) return;
+
+    if (nthreads-1 != nthr) {
+      destroy_thr();
+      nthr = nthreads-1;
+      sidata_thr = new SurfacesIntersectData*[nthr];
+      i_forces_thr = new ForceData*[nthr];
+      j_forces_thr = new ForceData*[nthr];
+      batch_thr = new SurfacesIntersectBatch*[nthr];
+      for (int t = 0; t < nthr; t++) {
+        sidata_thr[t] = aligned_malloc<SurfacesIntersectData>(32);
+        i_forces_thr[t] = aligned_malloc<ForceData>(32);
+        j_forces_thr[t] = aligned_malloc<ForceData>(32);
+        batch_thr[t] = aligned_batch ? aligned_malloc<SurfacesIntersectBatch>(64) : NULL;
+      }
+    }
 
-    if(store_contact_forces)
-        pg->fix_contact_forces()->do_forward_comm();
+    memory->destroy(f_thr);
+    memory->destroy(torque_thr);
+    maxthr = atom->nmax;
+    memory->create(f_thr,nthr,maxthr,3,"pair:f_thr");
+    memory->create(torque_thr,nthr,maxthr,3,"pair:torque_thr");
+  }
+
+  void destroy_thr()
+  {
+    for (int t = 0; t < nthr; t++) {
+      aligned_free(sidata_thr[t]);
+      aligned_free(i_forces_thr[t]);
+      aligned_free(j_forces_thr[t]);
+      if (batch_thr[t]) aligned_free(batch_thr[t]);
+    }
+    delete [] sidata_thr;
+    delete [] i_forces_thr;
+    delete [] j_forces_thr;
+    delete [] batch_thr;
+    memory->destroy(f_thr);
+    memory->destroy(torque_thr);
+    sidata_thr = NULL;
+    i_forces_thr = j_forces_thr = NULL;
+    batch_thr = NULL;
+    f_thr = torque_thr = NULL;
+    nthr = maxthr = 0;
   }
 };
 
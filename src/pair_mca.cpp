@@ -55,28 +55,55 @@
 #include "error.h"
 #include "neighbor.h"
 #include "bond_mca.h"
+#include "bond_mca_break.h"
 #include "atom_vec_mca.h"
 #include "vector_liggghts.h"
 #include "rotations_mca.h"
 
+#if defined(_OPENMP)
+#include "omp.h"
+#endif
+
 
 using namespace LAMMPS_NS;
 using namespace MathConst;
 using namespace MCAAtomConst;
+using namespace MCABondConst;
 
 /// see also in 'fix_mca_meanstress.cpp'
 ///#define NO_MEANSTRESS // see also in fix_mca_meanstress.cpp
 ///#define NO_ROTATIONS
 #define REAL_NULL_CONST 5.0E-22 // 5.0E-14
 
+// bond history slots computed in this step which are read from ghost atoms
+// by compute_total_force(); P and Y of ghosts become P_PREV and Y_PREV when
+// FixMCAMeanStress::swap_prev() flips the generation in the next step.
+// N and SH are only read by the equivalent strain break criterion, so they
+// come last and are forwarded only if a bond type uses it, see init_style()
+static const int PAIR_COMM_HIST[] = {E, P, YX, YY, YZ, SX, SY, SZ, MX, MY, MZ,
+                                     NX, NY, NZ, SHX, SHY, SHZ};
+static const int PAIR_COMM_HIST_LEN = 11;
+static const int PAIR_COMM_HIST_STRAIN_LEN = 17;
+
+enum{NO_BOND_UPDATE = -1}; // the bonds are updated by BondMCA::compute()
+
 /* ---------------------------------------------------------------------- */
 
 PairMCA::PairMCA(LAMMPS *lmp) : Pair(lmp)
 {
   writedata = 1;
   single_enable = 0;
+  comm_forward = 1; // set in init_style()
+  n_comm_hist = PAIR_COMM_HIST_LEN;
   Sy = NULL;
   Eh = NULL;
+
+  fuse_flag = 1;
+  bond_fused = NULL;
+
+  no_virial_fdotr_compute = 1; // virial is tallied per bond in compute_total_force()
+  nthr = maxthr = 0;
+  f_thr = torque_thr = vatom_thr = NULL;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -95,6 +122,9 @@ PairMCA::~PairMCA()
     memory->destroy(Sy);
     memory->destroy(Eh);
   }
+  memory->destroy(f_thr);
+  memory->destroy(torque_thr);
+  memory->destroy(vatom_thr);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -121,6 +151,7 @@ inline void  PairMCA::compute_elastic_force()
   const int * const num_bond = atom->num_bond;
   const int newton_bond = force->newton_bond;
   double ***bond_hist = atom->bond_hist;
+  const int * const hs = BOND_HIST_SLOT[atom->bond_hist_gen]; // double buffered slots
   const int nbondlist = neighbor->nbondlist;
   int ** const bondlist = neighbor->bondlist;
   int ** const bond_index = atom->bond_index;
@@ -140,6 +171,7 @@ inline void  PairMCA::compute_elastic_force()
     if (num_bond[i] == 0) continue;
 
     int ** const bond_mca = atom->bond_mca;
+    int ** const bond_partner = atom->bond_partner;
     double rKHi,rKHj;// 1-2*G/(3*K) for atom i (j)
     double rHi,rHj;  // 2*G for atom i (j)
     double pi,pj;
@@ -181,31 +213,29 @@ inline void  PairMCA::compute_elastic_force()
       int bond_state = bondlist[bond_index_i][3];
       if(bond_state == NOT_INTERACT) { // pair does not interact
 //        if (logfile) fprintf(logfile,"PairMCA::compute_elastic_force bond %d (%d - %d) does not interact\n",bond_index_i,i,j);
+        keep_elastic_hist(bond_hist[i][k],hs);
         continue;
       }
 //if (logfile) fprintf(logfile,"PairMCA::compute_elastic_force bond %d (%d - %d(k=%d)) has state %d\n",bond_index_i,i,j,k,bond_state);
 
-      double *bond_hist_ik = &(bond_hist[tag[i]-1][k][0]);
-      int found = 0;
-      for(jk = 0; jk < num_bond[j]; jk++)
-        if(bond_atom[j][jk] == tag[i]) {found = 1; break; }
-      if (!found) error->all(FLERR,"PairMCA::compute_elastic_force 'jk' not found");
-      double *bond_hist_jk = &(bond_hist[tag[j]-1][jk][0]);
+      double *bond_hist_ik = &(bond_hist[i][k][0]);
+      jk = bond_partner[i][k];
+      double *bond_hist_jk = &(bond_hist[j][jk][0]);
 
       jtype = type[j];
       rGj = mca_pair->G[jtype][jtype];
       rHj = 2. * rGj;
       rKHj = mca_pair->K[jtype][jtype]; rKHj = 1. - rHj / (3. * rKHj);
 
-      r = bond_hist_ik[R];
-      r0 = bond_hist_ik[R_PREV];
+      r = bond_hist_ik[hs[R]];
+      r0 = bond_hist_ik[hs[R_PREV]];
       ei = bond_hist_ik[E];
-      pi = bond_hist_ik[P_PREV];
+      pi = bond_hist_ik[hs[P_PREV]];
       if (newton_bond) {
         //pj = bond_hist_ik[PJ_PREV];
         error->all(FLERR,"PairMCA::compute_elastic_force does not support 'newton on'");
       } else
-        pj = bond_hist_jk[P_PREV];
+        pj = bond_hist_jk[hs[P_PREV]];
 
       /// BEGIN central force
       d_e0 = (r - r0) / mca_radius;
@@ -220,6 +250,7 @@ inline void  PairMCA::compute_elastic_force()
         if((bond_state == BONDED) || (pi <= 0.0)) {
           if (logfile) fprintf(logfile,"PairMCA::compute_elastic_force: 'Qij>Dij' E=%g oNbrR_i.rE=%g IDi=%d IDj=%d Dij=%g D0ij=%g\n   dE=%g Pj=%g Pi=%g dSgmj=%g dSgmi=%g Hj=%g Hi=%g bond_state=%d\n",
           ei,bond_hist_ik[E],tag[i],bond_atom[i][k],r,r0,d_e,pj,(pi-d_p),rdSgmj,rdSgmi,rHj,rHi,bond_state);
+          keep_elastic_hist(bond_hist_ik,hs);
           continue;
         }
       }
@@ -252,8 +283,8 @@ inline void  PairMCA::compute_elastic_force()
       } else {
         /// BEGIN shear force
 
-        double *nv = &(bond_hist_ik[NX]);       // normal unit vector
-        double *nv0 = &(bond_hist_ik[NX_PREV]); // normal unit vector at prev time step
+        double *nv = &(bond_hist_ik[hs[NX]]);       // normal unit vector
+        double *nv0 = &(bond_hist_ik[hs[NX_PREV]]); // normal unit vector at prev time step
         double dYij[3];
         vectorCross3D(nv0, nv, dYij); // rotaion of the pair
 ///if(i == 13) if (logfile) fprintf(logfile,"PairMCA::compute_elastic_force i=%d j=%d nv0= %20.12e %20.12e %20.12e nv= %20.12e %20.12e %20.12e \n",i,j,nv0[0],nv0[1],nv0[2],nv[0],nv[1],nv[2]); ///AS DEBUG
@@ -304,9 +335,9 @@ inline void  PairMCA::compute_elastic_force()
         double rKS = 1. / (qj*rGi + qi*rGj);
         double rQR = qj * 0.5 * rKS;
         double vYj[3], vYij[3];
-        vectorCopy3D(&(bond_hist_ik[SHX_PREV]), vShear);
-        vectorCopy3D(&(bond_hist_ik[YX_PREV]), vYi);
-        vectorCopy3D(&(bond_hist_jk[YX_PREV]), vYj);
+        vectorCopy3D(&(bond_hist_ik[hs[SHX_PREV]]), vShear);
+        vectorCopy3D(&(bond_hist_ik[hs[YX_PREV]]), vYi);
+        vectorCopy3D(&(bond_hist_jk[hs[YX_PREV]]), vYj);
         vectorCopy3D(vYj, vR1); vectorScalarMult3D(vR1, rQR);
         vectorCopy3D(vYi, vR2); vectorScalarMult3D(vR2, -rQR);
         vectorAdd3D(vR1, vR2, vYij);
@@ -378,13 +409,13 @@ vMij[0]= vMij[1]= vMij[2]= 0.;
         /// END bending-torsion torque
       } // end of else if Unlinked and P>0
       bond_hist_ik[E] = ei;
-      bond_hist_ik[P] = pi;
-      bond_hist_ik[SHX] = vShear[0];
-      bond_hist_ik[SHY] = vShear[1];
-      bond_hist_ik[SHZ] = vShear[2];
-      bond_hist_ik[YX] = vYi[0];
-      bond_hist_ik[YY] = vYi[1];
-      bond_hist_ik[YZ] = vYi[2];
+      bond_hist_ik[hs[P]] = pi;
+      bond_hist_ik[hs[SHX]] = vShear[0];
+      bond_hist_ik[hs[SHY]] = vShear[1];
+      bond_hist_ik[hs[SHZ]] = vShear[2];
+      bond_hist_ik[hs[YX]] = vYi[0];
+      bond_hist_ik[hs[YY]] = vYi[1];
+      bond_hist_ik[hs[YZ]] = vYi[2];
       bond_hist_ik[SX] = vSij[0];
       bond_hist_ik[SY] = vSij[1];
       bond_hist_ik[SZ] = vSij[2];
@@ -406,6 +437,7 @@ inline void  PairMCA::compute_equiv_stress()
   int ** const bond_atom = atom->bond_atom;
   const int * const num_bond = atom->num_bond;
   double *** const bond_hist = atom->bond_hist;
+  const int * const hs = BOND_HIST_SLOT[atom->bond_hist_gen]; // double buffered slots
   int ** const bondlist = neighbor->bondlist;
   int ** const bond_index = atom->bond_index;
   const int * const type = atom->type;
@@ -424,10 +456,9 @@ inline void  PairMCA::compute_equiv_stress()
     int numb = num_bond[i];
     if (numb == 0) continue;
 
-    const int * const tag = atom->tag;
     const double * const theta = &(atom->theta[i][0]);
     double * const theta_prev = &(atom->theta_prev[i][0]);
-    double ** const bond_hist_i = &(bond_hist[tag[i]-1][0]);
+    double ** const bond_hist_i = &(bond_hist[i][0]);
     double *mean_stress = atom->mean_stress;
     double *cont_distance = atom->cont_distance;
     double meanstr = 0.0;
@@ -445,7 +476,7 @@ inline void  PairMCA::compute_equiv_stress()
       if (bond_state == NOT_INTERACT) continue;
 
       double * const bond_hist_ik = &(bond_hist_i[k][0]);
-      double p = bond_hist_ik[P];
+      double p = bond_hist_ik[hs[P]];
       if ((bond_state == UNBONDED) && (p > 0.0)) continue; // 01.08.18 this is free surface
       rdSumP += p;
       rdSumE += bond_hist_ik[E];
@@ -462,7 +493,7 @@ inline void  PairMCA::compute_equiv_stress()
       if (bond_state == NOT_INTERACT) continue;
 
       double * const bond_hist_ik = &(bond_hist_i[k][0]);
-      double p = bond_hist_ik[P];
+      double p = bond_hist_ik[hs[P]];
       if ((bond_state == UNBONDED) && (p > 0.0)) continue;
 
       double xtmp,ytmp,ztmp,rEqStress;
@@ -505,6 +536,7 @@ void PairMCA::correct_for_plasticity()
 ///  const int nmax = atom->nmax;
   const double mca_radius = atom->mca_radius;
   double ***bond_hist = atom->bond_hist;
+  const int * const hs = BOND_HIST_SLOT[atom->bond_hist_gen]; // double buffered slots
   int ** const bondlist = neighbor->bondlist;
   int ** const bond_index = atom->bond_index;
 
@@ -517,14 +549,13 @@ void PairMCA::correct_for_plasticity()
 
     const int newton_bond = force->newton_bond;
     const int * const type = atom->type;
-    const int * const tag = atom->tag;
     int ** const bond_atom = atom->bond_atom;
     const PairMCA * const mca_pair = (PairMCA*) force->pair;
     const double * const mean_stress = atom->mean_stress;
     const double * const equiv_stress_prev = atom->equiv_stress_prev;
 
 
-    double **bond_hist_i = &(bond_hist[tag[i]-1][0]);
+    double **bond_hist_i = &(bond_hist[i][0]);
     double *equiv_stress = atom->equiv_stress;
     double *equiv_strain = atom->equiv_strain;
     double *plastic_heat = atom->plastic_heat;
@@ -572,22 +603,22 @@ void PairMCA::correct_for_plasticity()
             for(jk = 0; jk < num_bond[j]; jk++)
               if(bond_atom[j][jk] == tag[i]) {found = 1; break; }
             if (!found) error->all(FLERR,"PairMCA::correct_for_plasticity 'jk' not found");
-            double *bond_hist_jk = &(bond_hist[tag[j]-1][jk][0]);
+            double *bond_hist_jk = &(bond_hist[j][jk][0]);
 */
-            rP = bond_hist_ik[P];
+            rP = bond_hist_ik[hs[P]];
             rP = rP * rM + mean_stress[i] * rMpli;
             double rMij = rM;
             if ((rP > 0.0) && (bond_state == UNBONDED)) {
               rP = 0.0;
               rMij = 0.0;
             }
-            bond_hist_ik[P] = rP;
+            bond_hist_ik[hs[P]] = rP;
             bond_hist_ik[SX] *= rMij;
             bond_hist_ik[SY] *= rMij;
             bond_hist_ik[SZ] *= rMij;
-            bond_hist_ik[YX] *= rMij;
-            bond_hist_ik[YY] *= rMij;
-            bond_hist_ik[YZ] *= rMij;
+            bond_hist_ik[hs[YX]] *= rMij;
+            bond_hist_ik[hs[YY]] *= rMij;
+            bond_hist_ik[hs[YZ]] *= rMij;
             bond_hist_ik[MX] *= rMij;
             bond_hist_ik[MY] *= rMij;
             bond_hist_ik[MZ] *= rMij;
@@ -607,11 +638,11 @@ void PairMCA::correct_for_plasticity()
         int jtype = type[j];
         double rCOF = mca_pair->cof[itype][jtype];
         double *bond_hist_ik = &(bond_hist_i[k][0]);
-        double rP = bond_hist_ik[P];
+        double rP = bond_hist_ik[hs[P]];
         double *vSij = &(bond_hist_ik[SX]);
         double *vMij = &(bond_hist_ik[MX]);
         if (rP > 0.0) {
-          rP = 0.0; bond_hist_ik[P] = 0.0;
+          rP = 0.0; bond_hist_ik[hs[P]] = 0.0;
         }
         if (rCOF < REAL_NULL_CONST) {
           vSij[0] = vSij[1] = vSij[2] = 0.0;
@@ -651,36 +682,100 @@ void PairMCA::correct_for_plasticity()
   return;
 }
 
-/* ---------------------------------------------------------------------- */
+/* ----------------------------------------------------------------------
+   total force and torque of the bonds, with 'fuse yes' the states of the
+   bonds are updated in the same loop instead of BondMCA::compute()
+------------------------------------------------------------------------- */
 
 void PairMCA::compute_total_force(int eflag, int vflag)
+{
+  if (!bond_fused) {
+    compute_total_force_eval<NO_BOND_UPDATE>(eflag,vflag);
+    return;
+  }
+
+  switch (bond_fused->break_style()) {
+    case BREAKSTYLE_NONE:
+      compute_total_force_eval<BREAKSTYLE_NONE>(eflag,vflag); break;
+    case BREAKSTYLE_EQUIV_STRAIN:
+      compute_total_force_eval<BREAKSTYLE_EQUIV_STRAIN>(eflag,vflag); break;
+    case BREAKSTYLE_EQUIV_STRESS:
+      compute_total_force_eval<BREAKSTYLE_EQUIV_STRESS>(eflag,vflag); break;
+    case BREAKSTYLE_DRUCKER_PRAGER:
+      compute_total_force_eval<BREAKSTYLE_DRUCKER_PRAGER>(eflag,vflag); break;
+    default:
+      compute_total_force_eval<BREAKSTYLE_MIXED>(eflag,vflag); break;
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+
+template<int BREAKSTYLE>
+inline void PairMCA::update_bond(const int n)
+{
+  bond_fused->update_bond<BREAKSTYLE>(n);
+}
+
+template<>
+inline void PairMCA::update_bond<NO_BOND_UPDATE>(const int)
+{
+}
+
+/* ---------------------------------------------------------------------- */
+
+template<int BREAKSTYLE>
+void PairMCA::compute_total_force_eval(int eflag, int vflag)
 {
   const int nbondlist = neighbor->nbondlist;
+  const int nlocal = atom->nlocal;
+  const int nthreads = comm->nthreads;
   double **f = atom->f;
   double **torque = atom->torque;
+  double v0,v1,v2,v3,v4,v5; // virial, MCA bonds have no potential energy
+  v0 = v1 = v2 = v3 = v4 = v5 = 0.0;
+  int nattract = 0; // unbonded pairs which attract each other, warned about after the loop
 
   if (eflag || vflag) ev_setup(eflag,vflag);
-  else evflag = 0;
+  else evflag = vflag_either = vflag_global = vflag_atom = 0; // flags are read below without evflag
 
 //if (logfile) fprintf(logfile, "PairMCA::compute_total_force \n");  ///AS DEBUG TRACE
 
-///#if defined (_OPENMP)
-//#pragma omp parallel for shared(x,f,torque,bondlist,bond_atom,bond_hist) default(none) schedule(static)
-///#pragma omp parallel for default(shared) schedule(static)
-///#endif
+  // all threads but the master accumulate forces, torques and per-atom virial
+  // in their own arrays, which are summed up after the bond loop
+  if (nthreads > 1) grow_thr(nthreads);
+
+#if defined (_OPENMP)
+#pragma omp parallel num_threads(nthreads) default(shared) reduction(+:v0,v1,v2,v3,v4,v5,nattract)
+#endif
+  {
+#if defined (_OPENMP)
+  const int tid = omp_get_thread_num();
+#else
+  const int tid = 0;
+#endif
+  double ** const f_t = tid ? f_thr[tid-1] : f;
+  double ** const torque_t = tid ? torque_thr[tid-1] : torque;
+  double ** const vatom_t = (tid && vflag_atom) ? vatom_thr[tid-1] : vatom;
+  if (tid) {
+    memset(&(f_t[0][0]),0,3*nlocal*sizeof(double));
+    memset(&(torque_t[0][0]),0,3*nlocal*sizeof(double));
+    if (vflag_atom) memset(&(vatom_t[0][0]),0,6*nlocal*sizeof(double));
+  }
+
+#if defined (_OPENMP)
+#pragma omp for schedule(static)
+#endif
   for (int n = 0; n < nbondlist; n++) {
     const double mca_radius  = atom->mca_radius;
     const double contact_area  = atom->contact_area;
-    const int * const tag = atom->tag; // tag of atom is their ID number
     double ** const x = atom->x;
     const double * const mean_stress  = atom->mean_stress;
     int ** const bondlist = neighbor->bondlist;
 ///AS I do not whant to use it, because it requires to be copied every step///  double **bondhistlist = neighbor->bondhistlist;
     double *** const bond_hist = atom->bond_hist;
-    const int * const num_bond = atom->num_bond;
-    int ** const bond_atom = atom->bond_atom;
+    const int * const hs = BOND_HIST_SLOT[atom->bond_hist_gen]; // double buffered slots
+    int ** const bond_partner = atom->bond_partner;
 
-    const int nlocal = atom->nlocal;
     const int newton_bond = force->newton_bond;
     const PairMCA * const mca_pair = (PairMCA*) force->pair;
 
@@ -689,6 +784,7 @@ void PairMCA::compute_total_force(int eflag, int vflag)
     if(bond_state == NOT_INTERACT)
     {
 ///       if (logfile) fprintf(logfile,"PairMCA::compute_total_force bond %d does not interact\n",n);
+       update_bond<BREAKSTYLE>(n);
        continue;
     }
 
@@ -704,26 +800,18 @@ void PairMCA::compute_total_force(int eflag, int vflag)
     i1 = bondlist[n][0];
     i2 = bondlist[n][1];
 
-    for (n1 = 0; n1 < num_bond[i1]; n1++) {
-      const int ib1 = bond_atom[i1][n1];
-      if (ib1==tag[i2]) break;
-    }
-    if (n1 == num_bond[i1]) error->all(FLERR,"Internal error in PairMCA: n1 not found");
+    n1 = bondlist[n][4];
+    n2 = bond_partner[i1][n1];
 
-    for (n2 = 0; n2 < num_bond[i2]; n2++) {
-      const int ib2 = bond_atom[i2][n2];
-      if (ib2==tag[i1]) break;
-    }
-    if (n2 == num_bond[i2]) error->all(FLERR,"Internal error in PairMCA: n2 not found");
+    double * const bond_hist1 = &(bond_hist[i1][n1][0]);
+    double * const bond_hist2 = &(bond_hist[i2][n2][0]);
 
-    double * const bond_hist1 = &(bond_hist[tag[i1]-1][n1][0]);
-    double * const bond_hist2 = &(bond_hist[tag[i2]-1][n2][0]);
-
-    double pi = bond_hist1[P];
-    double pj = bond_hist2[P];
+    double pi = bond_hist1[hs[P]];
+    double pj = bond_hist2[hs[P]];
     if ( (bond_state == UNBONDED) && ((pi>0.) || (pj>0.)) ) {
-      error->warning(FLERR,"PairMCA::compute_total_force (pi>0.)||(pj>0.) - be careful!");
+      nattract++;
       pi=0.0; pj=0.0;
+      update_bond<BREAKSTYLE>(n);
       continue;
     }
 
@@ -735,7 +823,7 @@ void PairMCA::compute_total_force(int eflag, int vflag)
     //int type = bondlist[n][2];
 
     double rD0 = 2.0*mca_radius;
-    double rDij = bond_hist1[R];
+    double rDij = bond_hist1[hs[R]];
     int itype = atom->type[i1];
     double rKi =  mca_pair->K[itype][itype];
     int jtype = atom->type[i2];
@@ -755,7 +843,7 @@ void PairMCA::compute_total_force(int eflag, int vflag)
     rinv = -1. / r; // "-" means that unit vector is from i1 to i2
 
     // normal unit vector
-    nv[0] = delx*rinv; // compute normal here because in bond_hist1[NX] it has implicit increment
+    nv[0] = delx*rinv; // compute normal here because in bond_hist1[hs[NX]] it has implicit increment
     nv[1] = dely*rinv;
     nv[2] = delz*rinv;
 
@@ -785,34 +873,101 @@ void PairMCA::compute_total_force(int eflag, int vflag)
 
     // apply force to each of 2 atoms
 
-///#if defined (_OPENMP)
-///#pragma omp critical(tfI1)
-///#endif
     if (newton_bond || i1 < nlocal) {
-      f[i1][0] += (dnforce[0] + dtforce[0]) * A;
-      f[i1][1] += (dnforce[1] + dtforce[1]) * A;
-      f[i1][2] += (dnforce[2] + dtforce[2]) * A;
-      torque[i1][0] += q1 * A * dttorque[0] + tor1;
-      torque[i1][1] += q1 * A * dttorque[1] + tor2;
-      torque[i1][2] += q1 * A * dttorque[2] + tor3;
+      f_t[i1][0] += (dnforce[0] + dtforce[0]) * A;
+      f_t[i1][1] += (dnforce[1] + dtforce[1]) * A;
+      f_t[i1][2] += (dnforce[2] + dtforce[2]) * A;
+      torque_t[i1][0] += q1 * A * dttorque[0] + tor1;
+      torque_t[i1][1] += q1 * A * dttorque[1] + tor2;
+      torque_t[i1][2] += q1 * A * dttorque[2] + tor3;
     }
 
-///#if defined (_OPENMP)
-///#pragma omp critical(tfI2)
-///#endif
     if (newton_bond || i2 < nlocal) {
-      f[i2][0] -= (dnforce[0] + dtforce[0]) * A;
-      f[i2][1] -= (dnforce[1] + dtforce[1]) * A;
-      f[i2][2] -= (dnforce[2] + dtforce[2]) * A;
-      torque[i2][0] += q2 * A * dttorque[0] - tor1;
-      torque[i2][1] += q2 * A * dttorque[1] - tor2;
-      torque[i2][2] += q2 * A * dttorque[2] - tor3;
+      f_t[i2][0] -= (dnforce[0] + dtforce[0]) * A;
+      f_t[i2][1] -= (dnforce[1] + dtforce[1]) * A;
+      f_t[i2][2] -= (dnforce[2] + dtforce[2]) * A;
+      torque_t[i2][0] += q2 * A * dttorque[0] - tor1;
+      torque_t[i2][1] += q2 * A * dttorque[1] - tor2;
+      torque_t[i2][2] += q2 * A * dttorque[2] - tor3;
+    }
+
+    if (vflag_either) { // see Pair::ev_tally_xyz(), only local ends receive the force
+      const double fx = (dnforce[0] + dtforce[0]) * A;
+      const double fy = (dnforce[1] + dtforce[1]) * A;
+      const double fz = (dnforce[2] + dtforce[2]) * A;
+      const int local1 = newton_bond || i1 < nlocal;
+      const int local2 = newton_bond || i2 < nlocal;
+      double v[6];
+      v[0] = 0.5*delx*fx;
+      v[1] = 0.5*dely*fy;
+      v[2] = 0.5*delz*fz;
+      v[3] = 0.5*delx*fy;
+      v[4] = 0.5*delx*fz;
+      v[5] = 0.5*dely*fz;
+      if (vflag_global) {
+        const double rEnds = local1 + local2;
+        v0 += rEnds*v[0]; v1 += rEnds*v[1]; v2 += rEnds*v[2];
+        v3 += rEnds*v[3]; v4 += rEnds*v[4]; v5 += rEnds*v[5];
+      }
+      if (vflag_atom) {
+        if (local1) for (int l = 0; l < 6; l++) vatom_t[i1][l] += v[l];
+        if (local2) for (int l = 0; l < 6; l++) vatom_t[i2][l] += v[l];
+      }
     }
 
-    //if (evflag) ev_tally(i1,i2,nlocal,newton_bond,ebond,0./*fbond*/,delx,dely,delz);
+    // the bond may break now, its force in this step is not changed by this
+    update_bond<BREAKSTYLE>(n);
+  }
+  } // end of omp parallel
+
+  if (nattract) {
+    char str[128];
+    sprintf(str,"PairMCA::compute_total_force (pi>0.)||(pj>0.) for %d bonds - be careful!",nattract);
+    error->warning(FLERR,str);
+  }
+
+  if (nthreads > 1) {
+#if defined (_OPENMP)
+#pragma omp parallel for num_threads(nthreads) default(shared) schedule(static)
+#endif
+    for (int i = 0; i < nlocal; i++)
+      for (int t = 0; t < nthreads-1; t++) {
+        vectorAdd3D(f[i],f_thr[t][i],f[i]);
+        vectorAdd3D(torque[i],torque_thr[t][i],torque[i]);
+        if (vflag_atom) for (int l = 0; l < 6; l++) vatom[i][l] += vatom_thr[t][i][l];
+      }
+  }
+
+  if (vflag_global) {
+    virial[0] += v0;
+    virial[1] += v1;
+    virial[2] += v2;
+    virial[3] += v3;
+    virial[4] += v4;
+    virial[5] += v5;
   }
 }
 
+/* ----------------------------------------------------------------------
+   per-thread accumulators of compute_total_force() for threads 1 ... nthreads-1
+------------------------------------------------------------------------- */
+
+void PairMCA::grow_thr(int nthreads)
+{
+  if (nthreads-1 == nthr && atom->nmax <= maxthr && (vatom_thr || !vflag_atom)) return;
+
+  memory->destroy(f_thr);
+  memory->destroy(torque_thr);
+  memory->destroy(vatom_thr);
+  vatom_thr = NULL;
+
+  nthr = nthreads-1;
+  maxthr = atom->nmax;
+  memory->create(f_thr,nthr,maxthr,3,"pair:f_thr");
+  memory->create(torque_thr,nthr,maxthr,3,"pair:torque_thr");
+  if (vflag_atom) memory->create(vatom_thr,nthr,maxthr,6,"pair:vatom_thr");
+}
+
 /* ---------------------------------------------------------------------- */
 
 void PairMCA::compute(int eflag, int vflag)
@@ -827,11 +982,56 @@ void PairMCA::compute(int eflag, int vflag)
   compute_elastic_force();
   compute_equiv_stress();
   correct_for_plasticity();
+  comm->forward_comm_pair(this); // ghost bond history is stored per rank now
   compute_total_force(eflag,vflag);
 
   if (vflag_fdotr) virial_fdotr_compute();
 }
 
+/* ----------------------------------------------------------------------
+   forward comm of contact distance and bond history computed in this step
+   for ghost atoms
+------------------------------------------------------------------------- */
+
+int PairMCA::pack_comm(int n, int *list, double *buf, int pbc_flag, int *pbc)
+{
+  int i,j,k,l,m;
+  const int * const num_bond = atom->num_bond;
+  const double * const cont_distance = atom->cont_distance;
+  double *** const bond_hist = atom->bond_hist;
+  const int * const hs = BOND_HIST_SLOT[atom->bond_hist_gen]; // double buffered slots
+
+  m = 0;
+  for (i = 0; i < n; i++) {
+    j = list[i];
+    buf[m++] = cont_distance[j];
+    for (k = 0; k < num_bond[j]; k++)
+      for (l = 0; l < n_comm_hist; l++)
+        buf[m++] = bond_hist[j][k][hs[PAIR_COMM_HIST[l]]];
+  }
+  return comm_forward;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void PairMCA::unpack_comm(int n, int first, double *buf)
+{
+  int i,k,l,m,last;
+  const int * const num_bond = atom->num_bond;
+  double * const cont_distance = atom->cont_distance;
+  double *** const bond_hist = atom->bond_hist;
+  const int * const hs = BOND_HIST_SLOT[atom->bond_hist_gen]; // double buffered slots
+
+  m = 0;
+  last = first + n;
+  for (i = first; i < last; i++) {
+    cont_distance[i] = buf[m++];
+    for (k = 0; k < num_bond[i]; k++)
+      for (l = 0; l < n_comm_hist; l++)
+        bond_hist[i][k][hs[PAIR_COMM_HIST[l]]] = buf[m++];
+  }
+}
+
 /* ----------------------------------------------------------------------
    allocate all arrays
 ------------------------------------------------------------------------- */
@@ -857,12 +1057,51 @@ void PairMCA::allocate()
   memory->create(Eh,n+1,n+1,"pair:Eh");
 }
 
+/* ----------------------------------------------------------------------
+   init specific to this pair style
+------------------------------------------------------------------------- */
+
+void PairMCA::init_style()
+{
+  Pair::init_style();
+
+  // with 'fuse yes' the bond states are updated in compute_total_force(),
+  // which saves BondMCA::compute() a second loop over the bond history
+
+  Bond *bond = force->bond_match("mca");
+  bond_fused = fuse_flag ? (BondMCA *) bond : NULL;
+  if (bond) ((BondMCA *) bond)->fused = fuse_flag;
+
+  // cont_distance + bond history read from ghosts for each bond slot in use
+
+  n_comm_hist = PAIR_COMM_HIST_LEN;
+  if (bond) {
+    const int breakstyle = ((BondMCA *) bond)->break_style();
+    if (breakstyle == BREAKSTYLE_EQUIV_STRAIN || breakstyle == BREAKSTYLE_MIXED)
+      n_comm_hist = PAIR_COMM_HIST_STRAIN_LEN;
+  }
+  comm_forward = 1 + atom->bond_per_atom*n_comm_hist;
+}
+
 /* ----------------------------------------------------------------------
    global settings
 ------------------------------------------------------------------------- */
 
 void PairMCA::settings(int narg, char **arg)
 {
+  // pair_style mca cutoff [fuse yes/no], the cut-off is not used yet
+
+  int iarg = 0;
+  if (narg > 0 && strcmp(arg[0],"fuse") != 0) iarg = 1;
+  while (iarg < narg) {
+    if (strcmp(arg[iarg],"fuse") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal pair_style mca command");
+      if (strcmp(arg[iarg+1],"yes") == 0) fuse_flag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) fuse_flag = 0;
+      else error->all(FLERR,"Illegal pair_style mca command");
+      iarg += 2;
+    } else error->all(FLERR,"Illegal pair_style mca command");
+  }
 /*
   if (narg != 1) error->all(FLERR,"Illegal pair_style command");
 
@@ -60,6 +60,7 @@ class PairMCA : public Pair {
   virtual ~PairMCA();
 
   virtual void compute(int, int);
+  void init_style();
   void settings(int, char **);
   void coeff(int, char **);
   double init_one(int, int);
@@ -69,6 +70,8 @@ class PairMCA : public Pair {
   void read_restart_settings(FILE *);
   void write_data(FILE *);
   void write_data_all(FILE *);
+  int pack_comm(int, int *, double *, int, int *);
+  void unpack_comm(int, int, double *);
 
   double **cof; // Coefficient of friction
   double **G; // shear modulus
@@ -87,6 +90,18 @@ class PairMCA : public Pair {
   void compute_equiv_stress();
   void correct_for_plasticity();
   void compute_total_force(int, int);
+  template<int BREAKSTYLE> void compute_total_force_eval(int, int);
+
+  // bond states updated in the loop of compute_total_force(), see bond_mca_break.h
+  int fuse_flag;
+  class BondMCA *bond_fused; // NULL if BondMCA::compute() updates them
+  int n_comm_hist;          // # of bond history slots per bond in forward comm
+  template<int BREAKSTYLE> inline void update_bond(const int);
+
+  // per-thread force, torque and per-atom virial of compute_total_force()
+  int nthr,maxthr;
+  double ***f_thr,***torque_thr,***vatom_thr;
+  void grow_thr(int);
 
   void allocate();
 };
@@ -104,6 +119,10 @@ Self-explanatory.  Check the input script syntax and compare to the
 documentation for the command.  You can use -echo screen as a
 command-line option when running LAMMPS to see the offending line.
 
+E: Illegal pair_style mca command
+
+Self-explanatory.  The only keyword is 'fuse yes|no'.
+
 E: Incorrect args for pair coefficients
 
 Self-explanatory.  Check the input script or data file.
@@ -77,6 +77,7 @@ PairSph::PairSph(LAMMPS *lmp) : Pair(lmp)
     viscosity_ = 0;
 
     kernel_style = NULL;
+    kernel_table_size = 0;
 
     fppaSl = NULL;
     fppaSlType = NULL;
@@ -84,6 +85,7 @@ PairSph::PairSph(LAMMPS *lmp) : Pair(lmp)
     slComType = NULL;
 
     fix_fgradP_ = NULL;
+    fsds_ = NULL;
 
     mass_type = atom->avec->mass_type; // get flag for mass per type
 
@@ -325,6 +327,12 @@ void PairSph::init_style()
     MPI_Allreduce(&onerad[1],&maxrad[1],atom->ntypes,MPI_DOUBLE,MPI_MAX,world);
   }
 
+  // sample kernel if requested
+  if (kernel_table_size > 0) {
+    if (!kernel_table.setup(kernel_id,kernel_table_size))
+      error->all(FLERR,"Pair sph: kernel can not be tabulated, it does not scale with a power of 1/h");
+  } else kernel_table.clear();
+
   // proceed with initialisation of the substyle
   init_substyle();
 
@@ -338,6 +346,19 @@ void PairSph::init_list(int id, NeighList *ptr)
   else error->all(FLERR,"Internal error in PairSph::init_list");
 }
 
+/* ---------------------------------------------------------------------- */
+
+void PairSph::register_fix_sph_density(FixSPHDensitySum *ptr)
+{
+  if(fsds_ != NULL && fsds_ != ptr) error->all(FLERR,"Pair sph allows only one fix sph/density/summation with 'fused yes'");
+  fsds_ = ptr;
+}
+
+void PairSph::unregister_fix_sph_density(FixSPHDensitySum *ptr)
+{
+  if(fsds_ == ptr) fsds_ = NULL;
+}
+
 /* ----------------------------------------------------------------------
    init for one type pair i,j and corresponding j,i
 ------------------------------------------------------------------------- */
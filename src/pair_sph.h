@@ -48,6 +48,7 @@
 #define LMP_PAIR_SPH_H
 
 #include "pair.h"
+#include "sph_kernels.h"
 
 namespace LAMMPS_NS {
 
@@ -78,9 +79,18 @@ class PairSph : public Pair {
   /* PUBLIC ACCESS FUNCTIONS */
 
   int sph_kernel_id(){return kernel_id;}
+  int sph_kernel_table_size(){return kernel_table_size;}
   int returnPairStyle(){return pairStyle_; };
   double returnViscosity() {return viscosity_; };
 
+  // fix sph/density/summation 'fused yes' evaluates the kernel for all pairs
+  // of the neighbor list of this pair style, see fsds()->pair_cache()
+  void register_fix_sph_density(class FixSPHDensitySum *);
+  void unregister_fix_sph_density(class FixSPHDensitySum *);
+  inline class FixSPHDensitySum * fsds() {
+    return fsds_;
+  }
+
  protected:
 
   void allocate();
@@ -98,6 +108,9 @@ class PairSph : public Pair {
   int kernel_id;
   char *kernel_style;
 
+  int kernel_table_size;  // # of intervals of the tabulated kernel, 0 if analytic
+  SPH_KERNEL_NS::KernelTable kernel_table;
+
   double *onerad;
   double *maxrad;
 
@@ -109,6 +122,8 @@ class PairSph : public Pair {
   // storage for force part caused by pressure gradient (grad P / rho):
   class FixPropertyAtom* fix_fgradP_;
   double **fgradP_;
+
+  class FixSPHDensitySum *fsds_;
 };
 
 }
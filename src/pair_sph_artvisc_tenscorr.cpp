@@ -59,8 +59,14 @@
 #include "memory.h"
 #include "error.h"
 #include "sph_kernels.h"
+#include "fix_sph_density_summation.h"
+#include "vector_liggghts.h"
 #include "timer.h"
 
+#if defined(_OPENMP)
+#include "omp.h"
+#endif
+
 using namespace LAMMPS_NS;
 
 /* ---------------------------------------------------------------------- */
@@ -79,7 +85,10 @@ PairSphArtviscTenscorr::PairSphArtviscTenscorr(LAMMPS *lmp) : PairSph(lmp),
     epsilonPPG(NULL),
     deltaP(NULL),
     wDeltaPTypeinv(NULL),
-    epsilon(0.)
+    epsilon(0.),
+    nthr(0),
+    maxthr(0),
+    f_thr(NULL)
 {
   respa_enable = 0;
   single_enable = 0;
@@ -96,6 +105,7 @@ PairSphArtviscTenscorr::~PairSphArtviscTenscorr()
     memory->destroy(betaMean);
     memory->destroy(wDeltaPTypeinv);
   }
+  memory->destroy(f_thr);
 }
 
 /* ----------------------------------------------------------------------
@@ -135,6 +145,7 @@ void PairSphArtviscTenscorr::settings(int narg, char **arg)
   // optional parameters
 
   artVisc_flag = tensCorr_flag = 0;
+  kernel_table_size = 0;
 
   while (iarg < narg) {
     if (strcmp(arg[iarg],"artVisc") == 0) {
@@ -147,6 +158,12 @@ void PairSphArtviscTenscorr::settings(int narg, char **arg)
       if (iarg+1 > narg) error->all(FLERR, "Illegal pair_style sph command");
       tensCorr_flag = 1;
       iarg += 1;
+    } else if (strcmp(arg[iarg],"kernel_table") == 0) {
+      // number of intervals of the tabulated kernel
+      if (iarg+2 > narg) error->all(FLERR, "Illegal pair_style sph command");
+      kernel_table_size = force->inumeric(FLERR,arg[iarg+1]);
+      if (kernel_table_size < 0) error->all(FLERR, "Illegal pair_style sph command, kernel_table must be >= 0");
+      iarg += 2;
     } else error->all(FLERR, "Illegal pair_style sph command");
   }
 }
@@ -205,7 +222,9 @@ void PairSphArtviscTenscorr::init_substyle()
 
         const double slCom = slComType[i][j];
         const double slComInv = 1./slCom;
-        wDeltaPTypeinv[i][j] = 1./SPH_KERNEL_NS::sph_kernel(kernel_id,meanDeltaP * slComInv,slCom,slComInv);
+        const double s = meanDeltaP * slComInv;
+        if (kernel_table.active()) wDeltaPTypeinv[i][j] = 1./kernel_table.kernel().W(s,slCom,slComInv);
+        else wDeltaPTypeinv[i][j] = 1./SPH_KERNEL_NS::sph_kernel(kernel_id,s,slCom,slComInv);
       }
     }
   }
@@ -264,10 +283,32 @@ void PairSphArtviscTenscorr::allocate_properties(int size)
 */
 /* ---------------------------------------------------------------------- */
 
+struct PairSphArtviscTenscorr::Eval
+{
+  PairSphArtviscTenscorr *pair;
+  int eflag, vflag;
+  Eval(PairSphArtviscTenscorr *p, int e, int v) : pair(p), eflag(e), vflag(v) {}
+
+  template <class KERNEL> void operator()(const KERNEL &kernel) const
+  {
+    // kernel values of this time-step from fix sph/density/summation
+    const bool cached = pair->fsds_ && pair->fsds_->fused_pass();
+
+    if (pair->mass_type) {
+      if (cached) pair->compute_eval<1,1>(eflag,vflag,kernel);
+      else pair->compute_eval<1,0>(eflag,vflag,kernel);
+    } else {
+      if (cached) pair->compute_eval<0,1>(eflag,vflag,kernel);
+      else pair->compute_eval<0,0>(eflag,vflag,kernel);
+    }
+  }
+};
+
+/* ---------------------------------------------------------------------- */
+
 void PairSphArtviscTenscorr::compute(int eflag, int vflag)
 {
-  if (mass_type) compute_eval<1>(eflag,vflag);
-  else compute_eval<0>(eflag,vflag);
+  SPH_KERNEL_NS::sph_kernel_dispatch(kernel_id,kernel_table,Eval(this,eflag,vflag));
 }
 
 /* ----------------------------------------------------------------------
@@ -328,18 +369,13 @@ void PairSphArtviscTenscorr::read_restart_settings(FILE *fp)
 
 /* ----------------------------------------------------------------------
    template compute
+   CACHED = 1: W, dW/ds and 1/r are taken from fix sph/density/summation,
+   newton_pair is off then and the pairs are split among threads
 ------------------------------------------------------------------------- */
 
-template <int MASSFLAG>
-void PairSphArtviscTenscorr::compute_eval(int eflag, int vflag)
+template <int MASSFLAG,int CACHED,class KERNEL>
+void PairSphArtviscTenscorr::compute_eval(int eflag, int vflag, const KERNEL kernel)
 {
-  double sli,slCom,imass,jmass;
-  double artVisc,fAB4,rAB;
-  double rA,rB;
-  double wDeltaPinv;
-
-  double radi,rcom;
-
   double **x = atom->x;
   double **v = atom->vest;
   double *p = atom->p;
@@ -363,6 +399,12 @@ void PairSphArtviscTenscorr::compute_eval(int eflag, int vflag)
   int * const numneigh = list->numneigh;
   int ** const firstneigh = list->firstneigh;
 
+  const double * const cache = CACHED ? fsds_->pair_cache() : NULL;
+  const int * const offset = CACHED ? fsds_->pair_offset() : NULL;
+
+  // ev_tally() sums into shared data, so tallying is done by the master only
+  const int nthreads = (CACHED && !evflag) ? comm->nthreads : 1;
+
   // loop over neighbors of my atoms
   // depend on mass_type
 
@@ -373,6 +415,33 @@ void PairSphArtviscTenscorr::compute_eval(int eflag, int vflag)
     updatePtrs(); // get sl
   }
 
+  // all threads but the master accumulate forces in their own arrays
+  if (nthreads > 1) grow_thr(nthreads);
+
+  int nzero = 0; // pairs at the same position, reported after the parallel region
+
+#if defined (_OPENMP)
+#pragma omp parallel num_threads(nthreads) default(shared) reduction(+:nzero)
+#endif
+  {
+#if defined (_OPENMP)
+  const int tid = omp_get_thread_num();
+#else
+  const int tid = 0;
+#endif
+  double ** const f_t = tid ? f_thr[tid-1] : f;
+  if (tid) memset(&(f_t[0][0]),0,3*nlocal*sizeof(double));
+
+  double sli,slCom,imass,jmass;
+  double artVisc,fAB4,rAB;
+  double rA,rB;
+  double wDeltaPinv;
+
+  double radi,rcom;
+
+#if defined (_OPENMP)
+#pragma omp for schedule(static)
+#endif
   for (int ii = 0; ii < inum; ii++) {
     const int i = ilist[ii];
     const int itype = type[i];
@@ -412,6 +481,10 @@ void PairSphArtviscTenscorr::compute_eval(int eflag, int vflag)
 
       if ((MASSFLAG && rsq < cutsq[itype][jtype]) || (!MASSFLAG && rsq < rcom*rcom)) {
 
+        // cached pairs beyond the kernel cutoff have 1/r = 0
+        const double * const c = CACHED ? &cache[3*(offset[ii]+jj)] : NULL;
+        if (CACHED && c[2] == 0.) continue;
+
         if (MASSFLAG) {
           jmass = mass[jtype];
           slCom = slComType[itype][jtype];
@@ -427,16 +500,22 @@ void PairSphArtviscTenscorr::compute_eval(int eflag, int vflag)
         //cut = slCom*SPH_KERNEL_NS::sph_kernel_cut(kernel_id);
 
         // get distance and normalized distance
-        const double r = sqrt(rsq);
-        if (r == 0.) {
-          printf("Particle %i and %i are at same position (%f, %f, %f)",i,j,xtmp,ytmp,ztmp);
-          error->one(FLERR,"Zero distance between SPH particles!");
+        if (rsq == 0.) {
+          nzero++;
+          continue;
         }
-        const double rinv = 1./r;
-        const double s = r * slComInv;
+        double rinv,s = 0.,gradWmag;
+        if (CACHED) {
+          rinv = c[2];
+          gradWmag = c[1];
+        } else {
+          const double r = sqrt(rsq);
+          rinv = 1./r;
+          s = r * slComInv;
 
-        // calculate value for magnitude of grad W
-        const double gradWmag = SPH_KERNEL_NS::sph_kernel_der(kernel_id,s,slCom,slComInv);
+          // calculate value for magnitude of grad W
+          gradWmag = kernel.der(s,slCom,slComInv);
+        }
 
         // artificial viscosity
         artVisc = 0.0;
@@ -477,11 +556,11 @@ void PairSphArtviscTenscorr::compute_eval(int eflag, int vflag)
           } else {
             // assumption that deltaP = sl / 1.2
             const double deltaPOne = slCom/1.2;
-            wDeltaPinv = 1./SPH_KERNEL_NS::sph_kernel(kernel_id,deltaPOne * slComInv,slCom,slComInv);
+            wDeltaPinv = 1./kernel.W(deltaPOne * slComInv,slCom,slComInv);
           }
 
           //TODO: Is fAB4 in this form ok?!
-          const double fAB =  SPH_KERNEL_NS::sph_kernel(kernel_id,s,slCom,slComInv) * wDeltaPinv;
+          const double fAB = (CACHED ? c[0] : kernel.W(s,slCom,slComInv)) * wDeltaPinv;
           const double fAB2 = fAB * fAB;
           fAB4 = fAB2 * fAB2;
         }
@@ -491,21 +570,47 @@ void PairSphArtviscTenscorr::compute_eval(int eflag, int vflag)
 
         // apply the force
 
-        f[i][0] += delx*fpair;
-        f[i][1] += dely*fpair;
-        f[i][2] += delz*fpair;
+        f_t[i][0] += delx*fpair;
+        f_t[i][1] += dely*fpair;
+        f_t[i][2] += delz*fpair;
 
         if (newton_pair || j < nlocal) {
-          f[j][0] -= delx*fpair;
-          f[j][1] -= dely*fpair;
-          f[j][2] -= delz*fpair;
+          f_t[j][0] -= delx*fpair;
+          f_t[j][1] -= dely*fpair;
+          f_t[j][2] -= delz*fpair;
         }
 
         if (evflag) ev_tally(i,j,nlocal,newton_pair,0.0,0.0,fpair,delx,dely,delz);
       }
     }
   }
+  } // end of omp parallel
+
+  if (nzero) error->one(FLERR,"Zero distance between SPH particles!");
+
+  if (nthreads > 1) {
+#if defined (_OPENMP)
+#pragma omp parallel for num_threads(nthreads) default(shared) schedule(static)
+#endif
+    for (int i = 0; i < nlocal; i++)
+      for (int t = 0; t < nthreads-1; t++)
+        vectorAdd3D(f[i],f_thr[t][i],f[i]);
+  }
 
   if (vflag_fdotr) virial_fdotr_compute();
 
 }
+
+/* ----------------------------------------------------------------------
+   per-thread forces of compute_eval() for threads 1 ... nthreads-1
+------------------------------------------------------------------------- */
+
+void PairSphArtviscTenscorr::grow_thr(int nthreads)
+{
+  if (nthreads-1 == nthr && atom->nmax <= maxthr) return;
+
+  memory->destroy(f_thr);
+  nthr = nthreads-1;
+  maxthr = atom->nmax;
+  memory->create(f_thr,nthr,maxthr,3,"pair:f_thr");
+}
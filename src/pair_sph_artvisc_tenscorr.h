@@ -70,7 +70,8 @@ class PairSphArtviscTenscorr : public PairSph {
 
  protected:
   void allocate();
-  template <int> void compute_eval(int, int);
+  template <int MASSFLAG,int CACHED,class KERNEL> void compute_eval(int, int, const KERNEL);
+  struct Eval;
 
   int     artVisc_flag, tensCorr_flag; // flags for additional styles
 
@@ -86,6 +87,11 @@ class PairSphArtviscTenscorr : public PairSph {
   double  **wDeltaPTypeinv;
   double  epsilon; // coeffs for tensile correction
 
+  // per-thread forces of threads 1 ... nthreads-1
+  int nthr,maxthr;
+  double ***f_thr;
+  void grow_thr(int);
+
 };
 
 }
@@ -99,6 +99,9 @@ ReadDump::ReadDump(LAMMPS *lmp) : Pointers(lmp)
 
   reader = NULL;
   fp = NULL;
+
+  nblock = 0;
+  localflag = 0;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -377,6 +380,10 @@ void ReadDump::header(int fieldinfo)
   yprd = yhi - ylo;
   zprd = zhi - zlo;
 
+  // let all procs know how the snapshot is split into blocks, if at all
+
+  nblock = reader->bcast_blocks(nfield);
+
   // done if not checking fields
 
   if (!fieldinfo) return;
@@ -451,6 +458,7 @@ void ReadDump::header(int fieldinfo)
       if (fieldtype[i] == Z) zindex = i;
     }
   }
+
 }
 
 /* ---------------------------------------------------------------------- */
@@ -496,12 +504,36 @@ void ReadDump::atoms()
 
   int nchunk;
   bigint nread = 0;
-  while (nread < nsnapatoms) {
-    nchunk = MIN(nsnapatoms-nread,CHUNK);
-    if (me == 0) reader->read_atoms(nchunk,nfield,fields);
-    MPI_Bcast(&fields[0][0],nchunk*nfield,MPI_DOUBLE,0,world);
-    process_atoms(nchunk);
-    nread += nchunk;
+  if (nblock == 0) {
+    while (nread < nsnapatoms) {
+      nchunk = MIN(nsnapatoms-nread,CHUNK);
+      if (me == 0) reader->read_atoms(nchunk,nfield,fields);
+      MPI_Bcast(&fields[0][0],nchunk*nfield,MPI_DOUBLE,0,world);
+      process_atoms(nchunk);
+      nread += nchunk;
+    }
+
+  // snapshot stored in blocks, block I is read by proc I % nprocs
+  // after a purge no atom can match, so each proc adds the atoms of
+  //   its own blocks and migrate_atoms() below moves them to their owners
+  // else the reading proc broadcasts each chunk for matching as above
+
+  } else {
+    localflag = purgeflag;
+    for (int iblock = 0; iblock < nblock; iblock++) {
+      int root = iblock % nprocs;
+      if (localflag && root != me) continue;
+      int nlines = reader->block_lines(iblock);
+      for (int iline = 0; iline < nlines; iline += nchunk) {
+        nchunk = MIN(nlines-iline,CHUNK);
+        if (me == root)
+          reader->read_block(iblock,iline,nchunk,nfield,fields);
+        if (!localflag)
+          MPI_Bcast(&fields[0][0],nchunk*nfield,MPI_DOUBLE,root,world);
+        process_atoms(nchunk);
+      }
+    }
+    localflag = 0;
   }
 
   // if addflag set, add tags to new atoms if possible
@@ -829,7 +861,9 @@ void ReadDump::process_atoms(int n)
 
   if (!addflag) return;
 
-  MPI_Allreduce(ucflag,ucflag_all,n,MPI_INT,MPI_SUM,world);
+  if (localflag) {
+    for (i = 0; i < n; i++) ucflag_all[i] = ucflag[i];
+  } else MPI_Allreduce(ucflag,ucflag_all,n,MPI_INT,MPI_SUM,world);
 
   int nlocal_previous = atom->nlocal;
   double one[3];
@@ -837,11 +871,13 @@ void ReadDump::process_atoms(int n)
   for (i = 0; i < n; i++) {
     if (ucflag_all[i]) continue;
 
-    // each processor adds every Pth atom
+    // each processor adds every Pth atom, or all of its own chunk
 
-    addproc++;
-    if (addproc == nprocs) addproc = 0;
-    if (addproc != me) continue;
+    if (!localflag) {
+      addproc++;
+      if (addproc == nprocs) addproc = 0;
+      if (addproc != me) continue;
+    }
 
     // create type and coord fields from dump file
     // coord = 0.0 unless corresponding dump file field was specified
@@ -102,6 +102,8 @@ private:
   double xprd,yprd,zprd;
 
   bigint nsnapatoms;        // # of atoms in dump file shapshot
+  int nblock;               // # of blocks any proc can read, 0 = proc 0 reads
+  int localflag;            // 1 if chunk atoms are added by the reading proc
 
   int npurge,nreplace,ntrim,nadd;     // stats on processed atoms
   int addproc;                        // proc that should add next atom
@@ -63,6 +63,14 @@ class Reader : protected Pointers {
                              int, int, int &, int &, int &, int &) = 0;
   virtual void read_atoms(int, int, double **) = 0;
 
+  // readers whose snapshots are stored in blocks that any proc can read
+  // bcast_blocks() is called by all procs after read_header(),
+  // returns # of blocks or 0 if only proc 0 reads atoms via read_atoms()
+
+  virtual int bcast_blocks(int) { return 0; }
+  virtual int block_lines(int) { return 0; }
+  virtual void read_block(int, int, int, int, double **) {}
+
   virtual void open_file(const char *);
   virtual void close_file();
 
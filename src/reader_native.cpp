@@ -179,11 +179,32 @@ bigint ReaderNative::read_header(double box[3][3], int &triclinic,
     if (labels[m] == NULL) return 1;
   }
 
-  // match each field with a column of per-atom data
-  // if fieldlabel set, match with explicit column
-  // else infer one or more column matches from fieldtype
-  // xyz flag set by scaleflag + wrapflag (if fieldlabel set) or column label
+  match_fields(labels,nfield,fieldtype,fieldlabel,scaleflag,wrapflag,
+               fieldflag,xflag,yflag,zflag);
 
+  delete [] labels;
+
+  // create internal vector of word ptrs for future parsing of per-atom lines
+
+  words = new char*[nwords];
+
+  return natoms;
+}
+
+/* ----------------------------------------------------------------------
+   match each field with one of the nwords column labels
+   if fieldlabel set, match with explicit column
+   else infer one or more column matches from fieldtype
+   xyz flag set by scaleflag + wrapflag (if fieldlabel set) or column label
+   allocate and set fieldindex, set fieldflag = -1 if any unfound fields
+------------------------------------------------------------------------- */
+
+void ReaderNative::match_fields(char **labels, int nfield,
+                                int *fieldtype, char **fieldlabel,
+                                int scaleflag, int wrapflag, int &fieldflag,
+                                int &xflag, int &yflag, int &zflag)
+{
+  memory->destroy(fieldindex);
   memory->create(fieldindex,nfield,"read_dump:fieldindex");
 
   int s_index,u_index,su_index;
@@ -291,19 +312,11 @@ bigint ReaderNative::read_header(double box[3][3], int &triclinic,
       fieldindex[i] = find_label("iz",nwords,labels);
   }
 
-  delete [] labels;
-
   // set fieldflag = -1 if any unfound fields
 
   fieldflag = 0;
   for (int i = 0; i < nfield; i++)
     if (fieldindex[i] < 0) fieldflag = -1;
-
-  // create internal vector of word ptrs for future parsing of per-atom lines
-
-  words = new char*[nwords];
-
-  return natoms;
 }
 
 /* ----------------------------------------------------------------------
@@ -0,0 +1,325 @@
+/* ----------------------------------------------------------------------
+    This is the
+
+    ██╗     ██╗ ██████╗  ██████╗  ██████╗ ██╗  ██╗████████╗███████╗
+    ██║     ██║██╔════╝ ██╔════╝ ██╔════╝ ██║  ██║╚══██╔══╝██╔════╝
+    ██║     ██║██║  ███╗██║  ███╗██║  ███╗███████║   ██║   ███████╗
+    ██║     ██║██║   ██║██║   ██║██║   ██║██╔══██║   ██║   ╚════██║
+    ███████╗██║╚██████╔╝╚██████╔╝╚██████╔╝██║  ██║   ██║   ███████║
+    ╚══════╝╚═╝ ╚═════╝  ╚═════╝  ╚═════╝ ╚═╝  ╚═╝   ╚═╝   ╚══════╝®
+
+    DEM simulation engine, released by
+    DCS Computing Gmbh, Linz, Austria
+    http://www.dcs-computing.com, office@dcs-computing.com
+
+    LIGGGHTS® is part of CFDEM®project:
+    http://www.liggghts.com | http://www.cfdem.com
+
+    Core developer and main author:
+    Christoph Kloss, christoph.kloss@dcs-computing.com
+
+    LIGGGHTS® is open-source, distributed under the terms of the GNU Public
+    License, version 2 or later. It is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. You should have
+    received a copy of the GNU General Public License along with LIGGGHTS®.
+    If not, see http://www.gnu.org/licenses . See also top-level README
+    and LICENSE files.
+
+    LIGGGHTS® and CFDEM® are registered trade marks of DCS Computing GmbH,
+    the producer of the LIGGGHTS® software and the CFDEM®coupling software
+    See http://www.cfdem.com/terms-trademark-policy for details.
+
+-------------------------------------------------------------------------
+    Contributing author and copyright for this file:
+    (if no contributing author is listed, this file has been contributed
+    by the core developer)
+
+    Copyright 2012-     DCS Computing GmbH, Linz
+    Copyright 2009-2012 JKU Linz
+------------------------------------------------------------------------- */
+
+#include "stdio.h"
+#include "string.h"
+#include "reader_parallel.h"
+#include "atom.h"
+#include "memory.h"
+#include "error.h"
+
+using namespace LAMMPS_NS;
+
+#define NINFO 8             // # of index values per block, see dump
+
+/* ---------------------------------------------------------------------- */
+
+ReaderParallel::ReaderParallel(LAMMPS *lmp) : ReaderNative(lmp)
+{
+  MPI_Comm_rank(world,&me);
+
+  indexname = NULL;
+  columns = NULL;
+
+  nblock = 0;
+  blockinfo = NULL;
+
+  fpblock = NULL;
+  iblock_open = -1;
+  maxrow = 0;
+  rowbuf = NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+
+ReaderParallel::~ReaderParallel()
+{
+  if (fpblock) fclose(fpblock);
+  delete [] indexname;
+  delete [] columns;
+  memory->destroy(blockinfo);
+  memory->destroy(rowbuf);
+}
+
+/* ----------------------------------------------------------------------
+   open index file and read its header = # of columns and their labels
+   only called by proc 0
+------------------------------------------------------------------------- */
+
+void ReaderParallel::open_file(const char *file)
+{
+  if (fp != NULL) close_file();
+
+  compressed = 0;
+  fp = fopen(file,"rb");
+  if (fp == NULL) {
+    char str[512];
+    sprintf(str,"Cannot open file %s",file);
+    error->one(FLERR,str);
+  }
+
+  char magic[8];
+  if (fread(magic,sizeof(char),8,fp) != 8 || strncmp(magic,"LPDUMP01",8))
+    error->one(FLERR,"Dump file is not a parallel dump index");
+
+  int n;
+  read_bytes(&nwords,sizeof(int),1);
+  read_bytes(&n,sizeof(int),1);
+  delete [] columns;
+  columns = new char[n+1];
+  read_bytes(columns,sizeof(char),n);
+  columns[n] = '\0';
+
+  delete [] indexname;
+  indexname = new char[strlen(file)+1];
+  strcpy(indexname,file);
+}
+
+/* ----------------------------------------------------------------------
+   read and return time stamp from index file
+   if first read reaches end-of-file, return 1 so caller can open next file
+   only called by proc 0
+------------------------------------------------------------------------- */
+
+int ReaderParallel::read_time(bigint &ntimestep)
+{
+  if (fread(&ntimestep,sizeof(bigint),1,fp) != 1) return 1;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   skip snapshot from timestamp onward, data files are not touched
+   only called by proc 0
+------------------------------------------------------------------------- */
+
+void ReaderParallel::skip()
+{
+  double box[3][3];
+  int triclinic;
+  read_record(box,triclinic);
+  fseek(fp,(long) NINFO*nblock*sizeof(double),SEEK_CUR);
+}
+
+/* ----------------------------------------------------------------------
+   read remaining snapshot record and its block entries
+   match requested fields to the column labels of the index header
+   only called by proc 0
+------------------------------------------------------------------------- */
+
+bigint ReaderParallel::read_header(double box[3][3], int &triclinic,
+                                   int fieldinfo, int nfield,
+                                   int *fieldtype, char **fieldlabel,
+                                   int scaleflag, int wrapflag, int &fieldflag,
+                                   int &xflag, int &yflag, int &zflag)
+{
+  bigint natoms = read_record(box,triclinic);
+  memory->destroy(blockinfo);
+  memory->create(blockinfo,NINFO*nblock,"read_dump:blockinfo");
+  read_bytes(blockinfo,sizeof(double),NINFO*nblock);
+
+  iblock_next = iline_next = 0;
+
+  if (!fieldinfo) return natoms;
+
+  char *labelline = new char[strlen(columns)+1];
+  strcpy(labelline,columns);
+  if (atom->count_words(labelline) != nwords)
+    error->one(FLERR,"Dump file is incorrectly formatted");
+
+  char **labels = new char*[nwords];
+  labels[0] = strtok(labelline," \t\n\r\f");
+  for (int m = 1; m < nwords; m++)
+    labels[m] = strtok(NULL," \t\n\r\f");
+
+  match_fields(labels,nfield,fieldtype,fieldlabel,scaleflag,wrapflag,
+               fieldflag,xflag,yflag,zflag);
+
+  delete [] labels;
+  delete [] labelline;
+
+  return natoms;
+}
+
+/* ----------------------------------------------------------------------
+   read N atoms on proc 0 by walking through the blocks in order
+   only used if the snapshot is not read block-wise
+------------------------------------------------------------------------- */
+
+void ReaderParallel::read_atoms(int n, int nfield, double **fields)
+{
+  int nread = 0;
+  while (nread < n) {
+    int nlines = block_lines(iblock_next);
+    if (iline_next == nlines) {
+      iblock_next++;
+      iline_next = 0;
+      if (iblock_next == nblock)
+        error->one(FLERR,"Unexpected end of dump file");
+      continue;
+    }
+    int nchunk = MIN(n-nread,nlines-iline_next);
+    read_block(iblock_next,iline_next,nchunk,nfield,&fields[nread]);
+    iline_next += nchunk;
+    nread += nchunk;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   share block entries, column mapping and file name with all procs
+   return # of blocks so caller can distribute reading them
+------------------------------------------------------------------------- */
+
+int ReaderParallel::bcast_blocks(int nfield)
+{
+  MPI_Bcast(&nblock,1,MPI_INT,0,world);
+  MPI_Bcast(&nwords,1,MPI_INT,0,world);
+
+  if (me != 0) {
+    memory->destroy(blockinfo);
+    memory->create(blockinfo,NINFO*nblock,"read_dump:blockinfo");
+    memory->destroy(fieldindex);
+    memory->create(fieldindex,nfield,"read_dump:fieldindex");
+  }
+  MPI_Bcast(blockinfo,NINFO*nblock,MPI_DOUBLE,0,world);
+  MPI_Bcast(fieldindex,nfield,MPI_INT,0,world);
+
+  int n = 0;
+  if (me == 0) n = strlen(indexname) + 1;
+  MPI_Bcast(&n,1,MPI_INT,0,world);
+  if (me != 0) {
+    delete [] indexname;
+    indexname = new char[n];
+  }
+  MPI_Bcast(indexname,n,MPI_CHAR,0,world);
+
+  // index may now point to other data files
+
+  if (fpblock) fclose(fpblock);
+  fpblock = NULL;
+  iblock_open = -1;
+
+  return nblock;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int ReaderParallel::block_lines(int iblock)
+{
+  return static_cast<int> (blockinfo[NINFO*iblock]);
+}
+
+/* ----------------------------------------------------------------------
+   read N atoms starting at line first of block iblock from its data file
+   stores requested fields in fields array
+   can be called by any proc
+------------------------------------------------------------------------- */
+
+void ReaderParallel::read_block(int iblock, int first, int n,
+                                int nfield, double **fields)
+{
+  if (iblock != iblock_open) {
+    if (fpblock) fclose(fpblock);
+    char *name = new char[strlen(indexname) + 16];
+    sprintf(name,"%s.%d",indexname,iblock);
+    fpblock = fopen(name,"rb");
+    if (fpblock == NULL) {
+      char str[512];
+      sprintf(str,"Cannot open file %s",name);
+      error->one(FLERR,str);
+    }
+    delete [] name;
+    iblock_open = iblock;
+  }
+
+  if (n*nwords > maxrow) {
+    maxrow = n*nwords;
+    memory->destroy(rowbuf);
+    memory->create(rowbuf,maxrow,"read_dump:rowbuf");
+  }
+
+  long pos = static_cast<long> (blockinfo[NINFO*iblock+1]) +
+    (long) first*nwords*sizeof(double);
+  fseek(fpblock,pos,SEEK_SET);
+  if (fread(rowbuf,sizeof(double),n*nwords,fpblock) != (size_t) n*nwords)
+    error->one(FLERR,"Unexpected end of dump file");
+
+  for (int i = 0; i < n; i++) {
+    double *row = &rowbuf[i*nwords];
+    for (int m = 0; m < nfield; m++)
+      fields[i][m] = row[fieldindex[m]];
+  }
+}
+
+/* ----------------------------------------------------------------------
+   read snapshot record after the time stamp, up to the # of blocks
+   return natoms
+------------------------------------------------------------------------- */
+
+bigint ReaderParallel::read_record(double box[3][3], int &triclinic)
+{
+  bigint natoms;
+  int boundary[6];
+
+  read_bytes(&natoms,sizeof(bigint),1);
+  read_bytes(&triclinic,sizeof(int),1);
+  read_bytes(boundary,sizeof(int),6);
+
+  box[0][2] = box[1][2] = box[2][2] = 0.0;
+  read_bytes(&box[0][0],sizeof(double),2);
+  read_bytes(&box[1][0],sizeof(double),2);
+  read_bytes(&box[2][0],sizeof(double),2);
+  if (triclinic) {
+    read_bytes(&box[0][2],sizeof(double),1);
+    read_bytes(&box[1][2],sizeof(double),1);
+    read_bytes(&box[2][2],sizeof(double),1);
+  }
+
+  read_bytes(&nblock,sizeof(int),1);
+  return natoms;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void ReaderParallel::read_bytes(void *ptr, size_t size, size_t n)
+{
+  if (fread(ptr,size,n,fp) != n)
+    error->one(FLERR,"Unexpected end of dump file");
+}
@@ -0,0 +1,121 @@
+/* ----------------------------------------------------------------------
+    This is the
+
+    ██╗     ██╗ ██████╗  ██████╗  ██████╗ ██╗  ██╗████████╗███████╗
+    ██║     ██║██╔════╝ ██╔════╝ ██╔════╝ ██║  ██║╚══██╔══╝██╔════╝
+    ██║     ██║██║  ███╗██║  ███╗██║  ███╗███████║   ██║   ███████╗
+    ██║     ██║██║   ██║██║   ██║██║   ██║██╔══██║   ██║   ╚════██║
+    ███████╗██║╚██████╔╝╚██████╔╝╚██████╔╝██║  ██║   ██║   ███████║
+    ╚══════╝╚═╝ ╚═════╝  ╚═════╝  ╚═════╝ ╚═╝  ╚═╝   ╚═╝   ╚══════╝®
+
+    DEM simulation engine, released by
+    DCS Computing Gmbh, Linz, Austria
+    http://www.dcs-computing.com, office@dcs-computing.com
+
+    LIGGGHTS® is part of CFDEM®project:
+    http://www.liggghts.com | http://www.cfdem.com
+
+    Core developer and main author:
+    Christoph Kloss, christoph.kloss@dcs-computing.com
+
+    LIGGGHTS® is open-source, distributed under the terms of the GNU Public
+    License, version 2 or later. It is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. You should have
+    received a copy of the GNU General Public License along with LIGGGHTS®.
+    If not, see http://www.gnu.org/licenses . See also top-level README
+    and LICENSE files.
+
+    LIGGGHTS® and CFDEM® are registered trade marks of DCS Computing GmbH,
+    the producer of the LIGGGHTS® software and the CFDEM®coupling software
+    See http://www.cfdem.com/terms-trademark-policy for details.
+
+-------------------------------------------------------------------------
+    Contributing author and copyright for this file:
+    (if no contributing author is listed, this file has been contributed
+    by the core developer)
+
+    Copyright 2012-     DCS Computing GmbH, Linz
+    Copyright 2009-2012 JKU Linz
+------------------------------------------------------------------------- */
+
+#ifdef READER_CLASS
+
+ReaderStyle(parallel,ReaderParallel)
+
+#else
+
+#ifndef LMP_READER_PARALLEL_H
+#define LMP_READER_PARALLEL_H
+
+#include "reader_native.h"
+
+namespace LAMMPS_NS {
+
+/* ----------------------------------------------------------------------
+   reads the index and per-proc data files written by dump custom/parallel
+   proc 0 scans the index, the blocks themselves can be read on any proc
+------------------------------------------------------------------------- */
+
+class ReaderParallel : public ReaderNative {
+ public:
+  ReaderParallel(class LAMMPS *);
+  ~ReaderParallel();
+
+  int read_time(bigint &);
+  void skip();
+  bigint read_header(double [3][3], int &, int, int, int *, char **,
+                     int, int, int &, int &, int &, int &);
+  void read_atoms(int, int, double **);
+
+  int bcast_blocks(int);
+  int block_lines(int);
+  void read_block(int, int, int, int, double **);
+
+  void open_file(const char *);
+
+ private:
+  int me;
+  char *indexname;         // name of index file, data files append .<proc>
+  char *columns;           // column labels from index file header
+
+  int nblock;              // # of blocks in current snapshot
+  double *blockinfo;       // index entries of current snapshot
+
+  FILE *fpblock;           // currently open data file
+  int iblock_open;         // block whose data file is open, -1 if none
+  int maxrow;              // size of row buffer
+  double *rowbuf;          // raw per-atom values of a chunk
+
+  int iblock_next,iline_next;   // position for serial read_atoms()
+
+  bigint read_record(double [3][3], int &);
+  void read_bytes(void *, size_t, size_t);
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Cannot open file %s
+
+The specified file cannot be opened.  Check that the path and name are
+correct.
+
+E: Dump file is not a parallel dump index
+
+The file given to read_dump with format parallel must be the index file
+written by dump custom/parallel, not one of its per-proc data files.
+
+E: Dump file is incorrectly formatted
+
+Self-explanatory.
+
+E: Unexpected end of dump file
+
+A read operation from the file failed.
+
+*/
@@ -65,10 +65,42 @@ using namespace std;
  */
 RegionNeighborList::RegionNeighborList(LAMMPS *lmp) :
     Pointers(lmp),
+    ncount(0),
+    maxradius(0.),
     bbox_set(false)
 {
 }
 
+/**
+ * @brief Squared distances from a point to the neighboring bins of its bin
+ *
+ * Particles are binned by their center, so a stencil bin which is further away from x
+ * than the returned cutoff cannot hold a particle overlapping a sphere at x
+ *
+ * @param x        point in 3D
+ * @param ibin     local bin index of x
+ * @param radius   radius of the sphere at x
+ * @param dist     dist[d][0] and dist[d][2] are the squared distances to the lower and
+ *                 upper neighbor bin in dimension d, dist[d][1] is zero
+ * @return squared cutoff for overlaps with particles in this neighbor list
+ */
+double RegionNeighborList::stencilDistances(double * x, int ibin, double radius, double dist[3][3]) const {
+  const double * center = bins[ibin].center;
+  const double halfsize[3] = { 0.5*binsizex, 0.5*binsizey, 0.5*binsizez };
+
+  for(int d = 0; d < 3; d++) {
+    const double dlo = std::max(halfsize[d] + (x[d] - center[d]), 0.0);
+    const double dhi = std::max(halfsize[d] - (x[d] - center[d]), 0.0);
+    dist[d][0] = dlo*dlo;
+    dist[d][1] = 0.0;
+    dist[d][2] = dhi*dhi;
+  }
+
+  // add in SMALL for round-off safety of the bin positions
+  const double cut = radius + maxradius + SMALL*(binsizex + binsizey + binsizez);
+  return cut*cut;
+}
+
 /**
  * @brief Determine if the given particle overlaps with any particle in this neighbor list
  * @param x        position of particle to check
@@ -78,8 +110,22 @@ RegionNeighborList::RegionNeighborList(LAMMPS *lmp) :
 bool RegionNeighborList::hasOverlap(double * x, double radius) const {
   int ibin = coord2binLocal(x);
 
-  for(std::vector<int>::const_iterator it = stencil.begin(); it != stencil.end(); ++it) {
-    const int offset = *it;
+  if((ibin < 0) || ((size_t)(ibin) >= bins.size()))
+  {
+      
+      error->one(FLERR,"assertion failed");
+  }
+
+  // skip bins which are too far away to hold an overlapping particle
+  double dist[3][3];
+  const double cutsq = stencilDistances(x, ibin, radius, dist);
+
+  for(size_t istencil = 0; istencil < stencil.size(); ++istencil) {
+    const int * ijk = &stencil_ijk[3*istencil];
+    if(dist[0][ijk[0]+1] + dist[1][ijk[1]+1] + dist[2][ijk[2]+1] > cutsq)
+      continue;
+
+    const int offset = stencil[istencil];
     if((ibin+offset < 0) || ((size_t)(ibin+offset) >= bins.size()))
     {
         
@@ -152,8 +198,22 @@ bool RegionNeighborList::hasOverlapWith(double * x, double radius, std::vector<i
 
   bool overlap = false;
 
-  for(std::vector<int>::const_iterator it = stencil.begin(); it != stencil.end(); ++it) {
-    const int offset = *it;
+  if((ibin < 0) || ((size_t)(ibin) >= bins.size()))
+  {
+      
+      error->one(FLERR,"assertion failed");
+  }
+
+  // skip bins which are too far away to hold an overlapping particle
+  double dist[3][3];
+  const double cutsq = stencilDistances(x, ibin, radius, dist);
+
+  for(size_t istencil = 0; istencil < stencil.size(); ++istencil) {
+    const int * ijk = &stencil_ijk[3*istencil];
+    if(dist[0][ijk[0]+1] + dist[1][ijk[1]+1] + dist[2][ijk[2]+1] > cutsq)
+      continue;
+
+    const int offset = stencil[istencil];
     if((ibin+offset < 0) || ((size_t)(ibin+offset) >= bins.size()))
     {
         
@@ -193,6 +253,8 @@ void RegionNeighborList::insert(double * x, double radius,int index) {
 
   bins[ibin].p_array.push_back(Particle(index,x, radius));
   ++ncount;
+  if(radius > maxradius)
+    maxradius = radius;
 }
 
 #ifdef SUPERQUADRIC_ACTIVE_FLAG
@@ -216,7 +278,9 @@ void RegionNeighborList::insert_superquadric(double * x, double radius, double *
 void RegionNeighborList::clear() {
   bins.clear();
   stencil.clear();
+  stencil_ijk.clear();
   ncount = 0;
+  maxradius = 0.0;
 }
 
 /**
@@ -246,6 +310,7 @@ bool RegionNeighborList::setBoundingBox(BoundingBox & bb, double maxrad, bool ex
     // empty or invalid region
     bins.clear();
     stencil.clear();
+    stencil_ijk.clear();
     return false;
   }
 
@@ -388,10 +453,16 @@ bool RegionNeighborList::setBoundingBox(BoundingBox & bb, double maxrad, bool ex
   }
 
   // generate stencil which will look at all bins 27 bins
+  stencil.clear();
+  stencil_ijk.clear();
   for (int k = -1; k <= 1; k++)
     for (int j = -1; j <= 1; j++)
-      for (int i = -1; i <= 1; i++)
+      for (int i = -1; i <= 1; i++) {
         stencil.push_back(k*mbiny*mbinx + j*mbinx + i);
+        stencil_ijk.push_back(i);
+        stencil_ijk.push_back(j);
+        stencil_ijk.push_back(k);
+      }
 
   bbox_set = true;
 
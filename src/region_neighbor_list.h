@@ -147,7 +147,9 @@ protected:
 
     std::vector<Bin> bins;          // list of particle bins
     std::vector<int> stencil;       // stencil used to check bins for collisions
+    std::vector<int> stencil_ijk;   // bin offsets (i,j,k) of each stencil entry
     size_t ncount;                  // total number of particles in neighbor list
+    double maxradius;               // largest radius in neighbor list
 
     bool bbox_set;
 
@@ -163,6 +165,7 @@ protected:
 
     double bin_distance(int i, int j, int k);
     int coord2binLocal(double *x) const;
+    double stencilDistances(double *x, int ibin, double radius, double dist[3][3]) const;
 
 #ifdef SUPERQUADRIC_ACTIVE_FLAG
   int check_obb_flag;
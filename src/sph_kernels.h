@@ -40,6 +40,9 @@
 #ifndef LMP_SPH_KERNELS
 #define LMP_SPH_KERNELS
 
+#include <string.h>
+#include <math.h>
+#include <vector>
 #include "style_sph_kernel.h"
 
 namespace SPH_KERNEL_NS {
@@ -48,6 +51,11 @@ namespace SPH_KERNEL_NS {
   inline double sph_kernel(int id,double s,double h,double hinv);
   inline double sph_kernel_der(int id,double s,double h,double hinv);
   inline double sph_kernel_cut(int id);
+
+  template<int KERNEL_ID> struct AnalyticKernel;
+  class TabulatedKernel;
+  class KernelTable;
+  template<typename F> inline void sph_kernel_dispatch(int id,const KernelTable &table,F f);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -129,4 +137,161 @@ inline double SPH_KERNEL_NS::sph_kernel_cut(int id)
   return 0.;
 }
 
+/* ----------------------------------------------------------------------
+   kernel with the id as template parameter
+   the if/else chains of sph_kernel() and sph_kernel_der() reduce to the
+   call of the kernel functions at compile time
+------------------------------------------------------------------------- */
+
+template<int KERNEL_ID>
+struct SPH_KERNEL_NS::AnalyticKernel
+{
+  inline double W(double s,double h,double hinv) const
+  { return SPH_KERNEL_NS::sph_kernel(KERNEL_ID,s,h,hinv); }
+
+  inline double der(double s,double h,double hinv) const
+  { return SPH_KERNEL_NS::sph_kernel_der(KERNEL_ID,s,h,hinv); }
+};
+
+/* ----------------------------------------------------------------------
+   kernel and derivative sampled at n intervals of s within the cutoff
+   and linearly interpolated in between, zero beyond the cutoff
+   the samples are taken for h = 1 and scaled with the power of hinv of
+   the kernel, which is found when the table is set up
+   this is a view of a KernelTable, cheap to pass by value into a loop
+------------------------------------------------------------------------- */
+
+class SPH_KERNEL_NS::TabulatedKernel
+{
+ public:
+  TabulatedKernel(const double *t,int nintervals,double dsInv,int pW,int pDer) :
+    table(t), n(nintervals), dsinv(dsInv), powW(pW), powDer(pDer) {}
+
+  inline double W(double s,double,double hinv) const
+  {
+    const double x = s*dsinv;
+    const int k = static_cast<int>(x);
+    if (k >= n) return 0.;
+    const double *t = &table[4*k];
+    return (t[0] + (x-k)*t[1]) * hpow(hinv,powW);
+  }
+
+  inline double der(double s,double,double hinv) const
+  {
+    const double x = s*dsinv;
+    const int k = static_cast<int>(x);
+    if (k >= n) return 0.;
+    const double *t = &table[4*k];
+    return (t[2] + (x-k)*t[3]) * hpow(hinv,powDer);
+  }
+
+ private:
+  static inline double hpow(double hinv,int p)
+  {
+    const double hinv2 = hinv*hinv;
+    switch (p) {
+      case 2: return hinv2;
+      case 3: return hinv2*hinv;
+      case 4: return hinv2*hinv2;
+      default:
+      {
+        double r = 1.;
+        for (int i = 0; i < p; i++) r *= hinv;
+        return r;
+      }
+    }
+  }
+
+  const double *table; // per interval: W, increment of W, der, increment of der
+  int n;
+  double dsinv;
+  int powW, powDer;
+};
+
+/* ----------------------------------------------------------------------
+   storage of the samples of a TabulatedKernel
+------------------------------------------------------------------------- */
+
+class SPH_KERNEL_NS::KernelTable
+{
+ public:
+  KernelTable() : n(0), dsinv(0.), powW(0), powDer(0) {}
+
+  inline bool active() const
+  { return n > 0; }
+
+  inline void clear()
+  { n = 0; table.clear(); }
+
+  // returns false if the kernel does not scale with a power of hinv
+  inline bool setup(int id,int nintervals);
+
+  inline TabulatedKernel kernel() const
+  { return TabulatedKernel(&table[0],n,dsinv,powW,powDer); }
+
+ private:
+  // power of hinv a kernel function scales with at s, -1 if none
+  static inline int scaling(double (*f)(int,double,double,double),int id,double s)
+  {
+    const double f1 = f(id,s,1.,1.);
+    if (f1 == 0.) return -1;
+    const double p = log(f(id,s,0.5,2.)/f1)/log(2.);
+    const int ip = static_cast<int>(floor(p+0.5));
+    if (ip < 0 || fabs(p-ip) > 1e-6) return -1;
+    return ip;
+  }
+
+  int n;
+  double dsinv;
+  int powW, powDer;
+  std::vector<double> table;
+};
+
+/* ---------------------------------------------------------------------- */
+
+inline bool SPH_KERNEL_NS::KernelTable::setup(int id,int nintervals)
+{
+  clear();
+
+  const double cut = SPH_KERNEL_NS::sph_kernel_cut(id);
+  powW = scaling(SPH_KERNEL_NS::sph_kernel,id,0.25*cut);
+  powDer = scaling(SPH_KERNEL_NS::sph_kernel_der,id,0.25*cut);
+  if (powW < 0 || powDer < 0 || nintervals < 1) return false;
+
+  const double ds = cut/nintervals;
+  table.resize(4*nintervals);
+  for (int k = 0; k < nintervals; k++)
+  {
+    const double s0 = k*ds;
+    const double s1 = (k+1)*ds;
+    const double W0 = SPH_KERNEL_NS::sph_kernel(id,s0,1.,1.);
+    const double der0 = SPH_KERNEL_NS::sph_kernel_der(id,s0,1.,1.);
+    table[4*k] = W0;
+    table[4*k+1] = SPH_KERNEL_NS::sph_kernel(id,s1,1.,1.) - W0;
+    table[4*k+2] = der0;
+    table[4*k+3] = SPH_KERNEL_NS::sph_kernel_der(id,s1,1.,1.) - der0;
+  }
+
+  n = nintervals;
+  dsinv = 1./ds;
+  return true;
+}
+
+/* ----------------------------------------------------------------------
+   calls f(kernel) with the table if it is set up, else with the analytic
+   kernel of this id, so the loops of f are compiled for every kernel
+------------------------------------------------------------------------- */
+
+template<typename F>
+inline void SPH_KERNEL_NS::sph_kernel_dispatch(int id,const KernelTable &table,F f)
+{
+  if (table.active()) f(table.kernel());
+  #define SPH_KERNEL_CLASS
+  #define SPHKernel(kernel_id,kernelstyle,SPHKernelCalculation,SPHKernelCalculationDer,SPHKernelCalculationCut) \
+  else if (kernel_id == id) f(SPH_KERNEL_NS::AnalyticKernel<kernel_id>());
+  #include "style_sph_kernel.h"
+  #undef SPH_KERNEL_CLASS
+  #undef SPHKernel
+}
+
 #endif
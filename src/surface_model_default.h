@@ -59,7 +59,7 @@ namespace ContactModels
   class SurfaceModel<SURFACE_DEFAULT> : protected Pointers
   {
   public:
-    static const int MASK = CM_SURFACES_INTERSECT;
+    static const int MASK = CM_SURFACES_INTERSECT | CM_SURFACES_INTERSECT_BATCH;
 
     SurfaceModel(LAMMPS * lmp, IContactHistorySetup*, class ContactModelBase *) :
         Pointers(lmp)
@@ -146,6 +146,55 @@ namespace ContactModels
       sidata.P_diss = 0.;
     }
 
+    inline bool checkSurfacesIntersectBatch()
+    {
+      return true;
+    }
+
+    // same as surfacesIntersect() for a block of particle-particle contacts
+    inline void surfacesIntersectBatch(SurfacesIntersectBatch & b)
+    {
+      const int n = b.n;
+
+      #pragma omp simd
+      for (int k = 0; k < n; k++) {
+        const double enx = b.enx[k];
+        const double eny = b.eny[k];
+        const double enz = b.enz[k];
+
+        // relative translational velocity
+        const double vr1 = b.vix[k] - b.vjx[k];
+        const double vr2 = b.viy[k] - b.vjy[k];
+        const double vr3 = b.viz[k] - b.vjz[k];
+
+        // normal component
+        const double vn = vr1 * enx + vr2 * eny + vr3 * enz;
+
+        // tangential component
+        const double vt1 = vr1 - vn * enx;
+        const double vt2 = vr2 - vn * eny;
+        const double vt3 = vr3 - vn * enz;
+
+        // relative rotational velocity
+        const double deltan = b.radsum[k] - b.r[k];
+        const double rinv = b.rinv[k];
+        const double cri = b.radi[k] - 0.5 * deltan;
+        const double crj = b.radj[k] - 0.5 * deltan;
+        const double wr1 = (cri * b.omegaix[k] + crj * b.omegajx[k]) * rinv;
+        const double wr2 = (cri * b.omegaiy[k] + crj * b.omegajy[k]) * rinv;
+        const double wr3 = (cri * b.omegaiz[k] + crj * b.omegajz[k]) * rinv;
+
+        // relative velocities
+        b.vtr1[k] = vt1 - (b.deltaz[k] * wr2 - b.deltay[k] * wr3);
+        b.vtr2[k] = vt2 - (b.deltax[k] * wr3 - b.deltaz[k] * wr1);
+        b.vtr3[k] = vt3 - (b.deltay[k] * wr1 - b.deltax[k] * wr2);
+        b.vn[k] = vn;
+        b.deltan[k] = deltan;
+        b.cri[k] = cri;
+        b.crj[k] = crj;
+      }
+    }
+
     inline void endSurfacesIntersect(SurfacesIntersectData&,TriMesh *) {}
     inline void surfacesClose(SurfacesCloseData&, ForceData&, ForceData&){}
     void beginPass(SurfacesIntersectData&, ForceData&, ForceData&){}
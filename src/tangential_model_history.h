@@ -62,7 +62,7 @@ namespace ContactModels
     int history_offset;
 
   public:
-    static const int MASK = CM_CONNECT_TO_PROPERTIES | CM_SURFACES_INTERSECT | CM_SURFACES_CLOSE;
+    static const int MASK = CM_CONNECT_TO_PROPERTIES | CM_SURFACES_INTERSECT | CM_SURFACES_CLOSE | CM_SURFACES_INTERSECT_BATCH;
 
     TangentialModel(LAMMPS * lmp, IContactHistorySetup * hsetup,class ContactModelBase *c) : Pointers(lmp),
       coeffFrict(NULL),
@@ -233,6 +233,114 @@ namespace ContactModels
       }
     }
 
+    // heating tallies per pair, it is only done by surfacesIntersect()
+    inline bool checkSurfacesIntersectBatch()
+    {
+      return !heating;
+    }
+
+    // same as surfacesIntersect() for a block of particle-particle contacts,
+    // the shear history is updated while it is copied to the block and
+    // written back after the vectorised loop
+    inline void surfacesIntersectBatch(SurfacesIntersectBatch & b)
+    {
+      const int n = b.n;
+      const bool shearupdate = b.shearupdate && b.computeflag;
+      const double dt = update->dt;
+      double shearx[SurfacesIntersectBatch::SIZE];
+      double sheary[SurfacesIntersectBatch::SIZE];
+      double shearz[SurfacesIntersectBatch::SIZE];
+      double xmu[SurfacesIntersectBatch::SIZE];
+
+      for (int k = 0; k < n; k++) {
+        if(b.contact_flags[k]) *b.contact_flags[k] |= CONTACT_TANGENTIAL_MODEL;
+        const double * const shear = &b.contact_history[k][history_offset];
+        double shear0 = shear[0];
+        double shear1 = shear[1];
+        double shear2 = shear[2];
+
+        if (shearupdate) {
+          const double enx = b.enx[k];
+          const double eny = b.eny[k];
+          const double enz = b.enz[k];
+          shear0 += b.vtr1[k] * dt;
+          shear1 += b.vtr2[k] * dt;
+          shear2 += b.vtr3[k] * dt;
+
+          // rotate shear displacements
+
+          const double rsht = shear0*enx + shear1*eny + shear2*enz;
+          shear0 -= rsht * enx;
+          shear1 -= rsht * eny;
+          shear2 -= rsht * enz;
+        }
+
+        shearx[k] = shear0;
+        sheary[k] = shear1;
+        shearz[k] = shear2;
+        xmu[k] = coeffFrict[b.itype[k]][b.jtype[k]];
+      }
+
+      // branches are written as selects, so that the loop vectorises
+      #pragma omp simd
+      for (int k = 0; k < n; k++) {
+        const double enx = b.enx[k];
+        const double eny = b.eny[k];
+        const double enz = b.enz[k];
+        double shear0 = shearx[k];
+        double shear1 = sheary[k];
+        double shear2 = shearz[k];
+
+        const double shrmag = sqrt(shear0*shear0 + shear1*shear1 + shear2*shear2);
+        const double kt = b.kt[k];
+        const double gammat = b.gammat[k];
+
+        // tangential forces = shear + tangential velocity damping
+        const double Ft1 = -(kt * shear0);
+        const double Ft2 = -(kt * shear1);
+        const double Ft3 = -(kt * shear2);
+
+        // rescale frictional displacements and forces if needed
+        const double Ft_shear = kt * shrmag;
+        const double Ft_friction = xmu[k] * fabs(b.Fn[k]);
+        const bool slip = Ft_shear > Ft_friction;
+        const bool rescale = slip && shrmag != 0.0;
+        const double ratio = Ft_friction / Ft_shear;
+
+        const double Ft1_slip = rescale ? Ft1 * ratio : 0.0;
+        const double Ft2_slip = rescale ? Ft2 * ratio : 0.0;
+        const double Ft3_slip = rescale ? Ft3 * ratio : 0.0;
+        const double Ft1_new = slip ? Ft1_slip : Ft1 - gammat*b.vtr1[k];
+        const double Ft2_new = slip ? Ft2_slip : Ft2 - gammat*b.vtr2[k];
+        const double Ft3_new = slip ? Ft3_slip : Ft3 - gammat*b.vtr3[k];
+        shearx[k] = rescale ? -Ft1_new/kt : shear0;
+        sheary[k] = rescale ? -Ft2_new/kt : shear1;
+        shearz[k] = rescale ? -Ft3_new/kt : shear2;
+
+        // forces & torques
+        const double tor1 = eny * Ft3_new - enz * Ft2_new;
+        const double tor2 = enz * Ft1_new - enx * Ft3_new;
+        const double tor3 = enx * Ft2_new - eny * Ft1_new;
+
+        b.fx[k] += Ft1_new;
+        b.fy[k] += Ft2_new;
+        b.fz[k] += Ft3_new;
+        b.torqueix[k] = -b.cri[k] * tor1;
+        b.torqueiy[k] = -b.cri[k] * tor2;
+        b.torqueiz[k] = -b.cri[k] * tor3;
+        b.torquejx[k] = -b.crj[k] * tor1;
+        b.torquejy[k] = -b.crj[k] * tor2;
+        b.torquejz[k] = -b.crj[k] * tor3;
+      }
+
+      for (int k = 0; k < n; k++) {
+        double * const shear = &b.contact_history[k][history_offset];
+        shear[0] = shearx[k];
+        shear[1] = sheary[k];
+        shear[2] = shearz[k];
+      }
+    }
+
     inline void surfacesClose(SurfacesCloseData & scdata, ForceData&, ForceData&)
     {
       // unset non-touching neighbors
@@ -0,0 +1,294 @@
+/* ----------------------------------------------------------------------
+    This is the
+
+    ██╗     ██╗ ██████╗  ██████╗  ██████╗ ██╗  ██╗████████╗███████╗
+    ██║     ██║██╔════╝ ██╔════╝ ██╔════╝ ██║  ██║╚══██╔══╝██╔════╝
+    ██║     ██║██║  ███╗██║  ███╗██║  ███╗███████║   ██║   ███████╗
+    ██║     ██║██║   ██║██║   ██║██║   ██║██╔══██║   ██║   ╚════██║
+    ███████╗██║╚██████╔╝╚██████╔╝╚██████╔╝██║  ██║   ██║   ███████║
+    ╚══════╝╚═╝ ╚═════╝  ╚═════╝  ╚═════╝ ╚═╝  ╚═╝   ╚═╝   ╚══════╝®
+
+    DEM simulation engine, released by
+    DCS Computing Gmbh, Linz, Austria
+    http://www.dcs-computing.com, office@dcs-computing.com
+
+    LIGGGHTS® is part of CFDEM®project:
+    http://www.liggghts.com | http://www.cfdem.com
+
+    Core developer and main author:
+    Christoph Kloss, christoph.kloss@dcs-computing.com
+
+    LIGGGHTS® is open-source, distributed under the terms of the GNU Public
+    License, version 2 or later. It is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. You should have
+    received a copy of the GNU General Public License along with LIGGGHTS®.
+    If not, see http://www.gnu.org/licenses . See also top-level README
+    and LICENSE files.
+
+    LIGGGHTS® and CFDEM® are registered trade marks of DCS Computing GmbH,
+    the producer of the LIGGGHTS® software and the CFDEM®coupling software
+    See http://www.cfdem.com/terms-trademark-policy for details.
+
+-------------------------------------------------------------------------
+    Contributing author and copyright for this file:
+
+    Christoph Kloss (DCS Computing GmbH, Linz)
+
+    Copyright 2012-     DCS Computing GmbH, Linz
+------------------------------------------------------------------------- */
+
+#include "tri_mesh_bvh.h"
+#include "tri_mesh.h"
+#include <algorithm>
+
+using namespace LAMMPS_NS;
+
+namespace {
+
+  // orders element indices by one coordinate of their centroid
+  struct CentroidLess {
+    const double *centroid;
+    int dim;
+    CentroidLess(const double *c, int d) : centroid(c), dim(d) {}
+    bool operator()(int a, int b) const
+    { return centroid[3*a+dim] < centroid[3*b+dim]; }
+  };
+
+}
+
+/* ---------------------------------------------------------------------- */
+
+TriMeshBVH::TriMeshBVH() :
+  areaBuild_(0.),
+  area_(0.)
+{
+}
+
+/* ----------------------------------------------------------------------
+   a rebuild is needed if elements were added, removed or reordered
+   (mesh exchange and ghost communication), or if refitting has doubled
+   the summed box area, i.e. the tree no longer separates the elements well
+------------------------------------------------------------------------- */
+
+bool TriMeshBVH::needsRebuild(TriMesh *mesh)
+{
+    const int nall = mesh->sizeLocal() + mesh->sizeGhost();
+
+    if(nall != size() || area_ > 2.*areaBuild_)
+      return true;
+
+    for(int i = 0; i < nall; i++)
+      if(mesh->id(i) != ids_[i])
+        return true;
+
+    return false;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void TriMeshBVH::build(TriMesh *mesh)
+{
+    const int nall = mesh->sizeLocal() + mesh->sizeGhost();
+
+    elems_.resize(nall);
+    ids_.resize(nall);
+    elemBox_.resize(6*nall);
+    centroid_.resize(3*nall);
+    nodes_.clear();
+
+    for(int i = 0; i < nall; i++)
+    {
+      double *lo = &elemBox_[6*i];
+      double *hi = lo+3;
+      elementBox(mesh,i,lo,hi);
+      for(int dim = 0; dim < 3; dim++)
+        centroid_[3*i+dim] = 0.5*(lo[dim]+hi[dim]);
+      elems_[i] = i;
+      ids_[i] = mesh->id(i);
+    }
+
+    if(nall > 0)
+    {
+      nodes_.reserve(2*(nall/LEAF_SIZE+1));
+      buildNode(0,nall);
+    }
+
+    areaBuild_ = area_ = 0.;
+    for(size_t n = 0; n < nodes_.size(); n++)
+      areaBuild_ += boxArea(nodes_[n]);
+    area_ = areaBuild_;
+}
+
+/* ----------------------------------------------------------------------
+   node for elems_[first ... first+count-1], returns its index
+   nodes are stored depth-first, so children come after their parent
+------------------------------------------------------------------------- */
+
+int TriMeshBVH::buildNode(int first, int count)
+{
+    const int index = nodes_.size();
+    nodes_.push_back(Node());
+
+    double lo[3] = { elemBox_[6*elems_[first]], elemBox_[6*elems_[first]+1], elemBox_[6*elems_[first]+2] };
+    double hi[3] = { elemBox_[6*elems_[first]+3], elemBox_[6*elems_[first]+4], elemBox_[6*elems_[first]+5] };
+    double clo[3] = { centroid_[3*elems_[first]], centroid_[3*elems_[first]+1], centroid_[3*elems_[first]+2] };
+    double chi[3] = { clo[0], clo[1], clo[2] };
+
+    for(int k = first+1; k < first+count; k++)
+    {
+      const double *box = &elemBox_[6*elems_[k]];
+      const double *c = &centroid_[3*elems_[k]];
+      for(int dim = 0; dim < 3; dim++)
+      {
+        lo[dim] = std::min(lo[dim],box[dim]);
+        hi[dim] = std::max(hi[dim],box[dim+3]);
+        clo[dim] = std::min(clo[dim],c[dim]);
+        chi[dim] = std::max(chi[dim],c[dim]);
+      }
+    }
+
+    for(int dim = 0; dim < 3; dim++)
+    {
+      nodes_[index].lo[dim] = lo[dim];
+      nodes_[index].hi[dim] = hi[dim];
+    }
+
+    if(count <= LEAF_SIZE)
+    {
+      nodes_[index].first = first;
+      nodes_[index].count = count;
+      return index;
+    }
+
+    // split at the median centroid along the longest axis
+    int dim = 0;
+    if(chi[1]-clo[1] > chi[dim]-clo[dim]) dim = 1;
+    if(chi[2]-clo[2] > chi[dim]-clo[dim]) dim = 2;
+
+    const int nleft = count/2;
+    std::nth_element(elems_.begin()+first, elems_.begin()+first+nleft, elems_.begin()+first+count,
+                     CentroidLess(&centroid_[0],dim));
+
+    buildNode(first,nleft);
+    const int right = buildNode(first+nleft,count-nleft);
+
+    nodes_[index].first = right;
+    nodes_[index].count = 0;
+    return index;
+}
+
+/* ----------------------------------------------------------------------
+   update the boxes for the current node positions, keeping the topology
+------------------------------------------------------------------------- */
+
+void TriMeshBVH::refit(TriMesh *mesh)
+{
+    const int nall = size();
+
+    for(int i = 0; i < nall; i++)
+      elementBox(mesh,i,&elemBox_[6*i],&elemBox_[6*i+3]);
+
+    // children are stored after their parent
+    area_ = 0.;
+    for(int n = static_cast<int>(nodes_.size())-1; n >= 0; n--)
+    {
+      Node &node = nodes_[n];
+
+      if(node.count > 0)
+      {
+        const double *box = &elemBox_[6*elems_[node.first]];
+        for(int dim = 0; dim < 3; dim++)
+        {
+          node.lo[dim] = box[dim];
+          node.hi[dim] = box[dim+3];
+        }
+        for(int k = node.first+1; k < node.first+node.count; k++)
+        {
+          box = &elemBox_[6*elems_[k]];
+          for(int dim = 0; dim < 3; dim++)
+          {
+            node.lo[dim] = std::min(node.lo[dim],box[dim]);
+            node.hi[dim] = std::max(node.hi[dim],box[dim+3]);
+          }
+        }
+      }
+      else
+      {
+        const Node &left = nodes_[n+1];
+        const Node &right = nodes_[node.first];
+        for(int dim = 0; dim < 3; dim++)
+        {
+          node.lo[dim] = std::min(left.lo[dim],right.lo[dim]);
+          node.hi[dim] = std::max(left.hi[dim],right.hi[dim]);
+        }
+      }
+
+      area_ += boxArea(node);
+    }
+}
+
+/* ---------------------------------------------------------------------- */
+
+void TriMeshBVH::query(const double *x, double delta, std::vector<int> &elems) const
+{
+    if(nodes_.empty())
+      return;
+
+    int stack[64];
+    int nstack = 0;
+    stack[nstack++] = 0;
+
+    while(nstack > 0)
+    {
+      const Node &node = nodes_[stack[--nstack]];
+
+      if(x[0] < node.lo[0]-delta || x[0] > node.hi[0]+delta ||
+         x[1] < node.lo[1]-delta || x[1] > node.hi[1]+delta ||
+         x[2] < node.lo[2]-delta || x[2] > node.hi[2]+delta)
+        continue;
+
+      if(node.count > 0)
+      {
+        for(int k = node.first; k < node.first+node.count; k++)
+          elems.push_back(elems_[k]);
+      }
+      else
+      {
+        // the tree is balanced, 64 levels are never reached
+        stack[nstack++] = node.first;
+        stack[nstack++] = &node - &nodes_[0] + 1;
+      }
+    }
+}
+
+/* ---------------------------------------------------------------------- */
+
+void TriMeshBVH::elementBox(TriMesh *mesh, int iElem, double *lo, double *hi)
+{
+    double pt[3];
+
+    mesh->node(iElem,0,pt);
+    for(int dim = 0; dim < 3; dim++)
+      lo[dim] = hi[dim] = pt[dim];
+
+    for(int j = 1; j < 3; j++)
+    {
+      mesh->node(iElem,j,pt);
+      for(int dim = 0; dim < 3; dim++)
+      {
+        lo[dim] = std::min(lo[dim],pt[dim]);
+        hi[dim] = std::max(hi[dim],pt[dim]);
+      }
+    }
+}
+
+/* ---------------------------------------------------------------------- */
+
+double TriMeshBVH::boxArea(const Node &node) const
+{
+    const double dx = node.hi[0]-node.lo[0];
+    const double dy = node.hi[1]-node.lo[1];
+    const double dz = node.hi[2]-node.lo[2];
+    return 2.*(dx*dy + dy*dz + dz*dx);
+}
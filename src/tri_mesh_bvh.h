@@ -0,0 +1,101 @@
+/* ----------------------------------------------------------------------
+    This is the
+
+    ██╗     ██╗ ██████╗  ██████╗  ██████╗ ██╗  ██╗████████╗███████╗
+    ██║     ██║██╔════╝ ██╔════╝ ██╔════╝ ██║  ██║╚══██╔══╝██╔════╝
+    ██║     ██║██║  ███╗██║  ███╗██║  ███╗███████║   ██║   ███████╗
+    ██║     ██║██║   ██║██║   ██║██║   ██║██╔══██║   ██║   ╚════██║
+    ███████╗██║╚██████╔╝╚██████╔╝╚██████╔╝██║  ██║   ██║   ███████║
+    ╚══════╝╚═╝ ╚═════╝  ╚═════╝  ╚═════╝ ╚═╝  ╚═╝   ╚═╝   ╚══════╝®
+
+    DEM simulation engine, released by
+    DCS Computing Gmbh, Linz, Austria
+    http://www.dcs-computing.com, office@dcs-computing.com
+
+    LIGGGHTS® is part of CFDEM®project:
+    http://www.liggghts.com | http://www.cfdem.com
+
+    Core developer and main author:
+    Christoph Kloss, christoph.kloss@dcs-computing.com
+
+    LIGGGHTS® is open-source, distributed under the terms of the GNU Public
+    License, version 2 or later. It is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. You should have
+    received a copy of the GNU General Public License along with LIGGGHTS®.
+    If not, see http://www.gnu.org/licenses . See also top-level README
+    and LICENSE files.
+
+    LIGGGHTS® and CFDEM® are registered trade marks of DCS Computing GmbH,
+    the producer of the LIGGGHTS® software and the CFDEM®coupling software
+    See http://www.cfdem.com/terms-trademark-policy for details.
+
+-------------------------------------------------------------------------
+    Contributing author and copyright for this file:
+
+    Christoph Kloss (DCS Computing GmbH, Linz)
+
+    Copyright 2012-     DCS Computing GmbH, Linz
+------------------------------------------------------------------------- */
+
+#ifndef LMP_TRI_MESH_BVH_H
+#define LMP_TRI_MESH_BVH_H
+
+#include <vector>
+
+namespace LAMMPS_NS
+{
+
+/**
+ * @brief Bounding volume hierarchy over the owned and ghost elements of a TriMesh
+ *
+ * The tree is built top-down, splitting the elements at the median centroid
+ * along the longest axis of their bounding box. If only the node positions
+ * change (moving or deforming mesh), refit() updates the boxes bottom-up and
+ * keeps the topology. needsRebuild() tells when the elements changed or the
+ * refitted boxes have grown too much.
+ */
+
+class TriMeshBVH
+{
+  public:
+
+    TriMeshBVH();
+
+    void build(class TriMesh *mesh);
+    void refit(class TriMesh *mesh);
+    bool needsRebuild(class TriMesh *mesh);
+
+    // appends all elements whose bounding box extended by delta contains x
+    void query(const double *x, double delta, std::vector<int> &elems) const;
+
+    int size() const
+    { return static_cast<int>(elems_.size()); }
+
+  private:
+
+    static const int LEAF_SIZE = 4;
+
+    struct Node {
+      double lo[3];
+      double hi[3];
+      int first; // leaf: first entry in elems_, inner node: right child (left child is next node)
+      int count; // leaf: number of elements, inner node: 0
+    };
+
+    int buildNode(int first, int count);
+    void elementBox(class TriMesh *mesh, int iElem, double *lo, double *hi);
+    double boxArea(const Node &node) const;
+
+    std::vector<Node> nodes_;
+    std::vector<int> elems_;          // element indices in leaf order
+    std::vector<int> ids_;            // mesh ids of the elements the tree was built for
+    std::vector<double> elemBox_;     // lo and hi of each element, 6 per element
+    std::vector<double> centroid_;    // 3 per element, during build only
+
+    double areaBuild_;                // summed box area after the last build
+    double area_;                     // summed box area after the last refit
+};
+
+} /* LAMMPS_NS */
+#endif /* LMP_TRI_MESH_BVH_H */